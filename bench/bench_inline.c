@@ -0,0 +1,88 @@
+/* ==========================================================================
+ * STDFRIGO BENCHMARK: CHAMADA À BIBLIOTECA x STDFRIGO_INLINE
+ * ==========================================================================
+ * Compilado duas vezes por `make bench`:
+ *   -fno-lto            -> *_call:   chamada real a libstdfrigo.a, como
+ *                                    num consumidor sem LTO.
+ *   -DSTDFRIGO_INLINE   -> *_inline: corpo inline no laço.
+ * Os laços são os mesmos; bench_rand.c os mede lado a lado.
+ * ========================================================================== */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "stdhash.h"
+#include "stdrand.h"
+
+#if defined(STDFRIGO_INLINE)
+#define BENCH_MODE(name) name##_inline
+#else
+#define BENCH_MODE(name) name##_call
+#endif
+
+/* A entrada passa por um registro opaco: o compilador não pode
+ * vetorizar nem pré-calcular o laço, só eliminar a chamada. */
+#if defined(__GNUC__) || defined(__clang__)
+#define BENCH_CLOBBER(x) __asm__ volatile("" : "+r"(x))
+#else
+#define BENCH_CLOBBER(x) ((void)(x))
+#endif
+
+#define BENCH_SEED 0x2545f4914f6cdd1dULL
+
+uint64_t BENCH_MODE(b_hash32_int)(size_t n);
+uint64_t BENCH_MODE(b_hash64_int)(size_t n);
+uint64_t BENCH_MODE(b_hash64_mem)(size_t n);
+uint64_t BENCH_MODE(b_rand64_next)(size_t n);
+uint64_t BENCH_MODE(b_rand64_bound)(size_t n);
+
+uint64_t BENCH_MODE(b_hash32_int)(size_t n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t x = (uint32_t)i;
+        BENCH_CLOBBER(x);
+        acc ^= hash32_int(x);
+    }
+    return acc;
+}
+
+uint64_t BENCH_MODE(b_hash64_int)(size_t n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t x = (uint64_t)i;
+        BENCH_CLOBBER(x);
+        acc ^= hash64_int(x);
+    }
+    return acc;
+}
+
+uint64_t BENCH_MODE(b_hash64_mem)(size_t n) {
+    unsigned char key[16] = {0};
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t x = (uint64_t)i;
+        BENCH_CLOBBER(x);
+        memcpy(key, &x, sizeof(x));
+        acc ^= hash64_mem(key, sizeof(key));
+    }
+    return acc;
+}
+
+uint64_t BENCH_MODE(b_rand64_next)(size_t n) {
+    rand64_t rng = rand64_init(BENCH_SEED);
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+        acc ^= rand64_next(&rng);
+    }
+    return acc;
+}
+
+uint64_t BENCH_MODE(b_rand64_bound)(size_t n) {
+    rand64_t rng = rand64_init(BENCH_SEED);
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+        acc ^= rand64_bound(&rng, 100);
+    }
+    return acc;
+}
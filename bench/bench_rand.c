@@ -0,0 +1,536 @@
+/* ==========================================================================
+ * STDFRIGO BENCHMARK SUITE (stdrand)
+ * ==========================================================================
+ * Compilar: make bench              (CSV na saída padrão)
+ *           make bench BENCH_ARGS=--json
+ * Opções:   --csv | --json          Formato de saída
+ *           --ms N                  Duração alvo de cada amostra (padrão 20)
+ *           --runs N                Amostras por medição (padrão 5)
+ *           --filter TEXTO          Roda só medições cujo nome contém TEXTO
+ *
+ * O grupo "inline" compara a chamada à biblioteca sem LTO com o modo
+ * STDFRIGO_INLINE (bench/bench_inline.c, compilado duas vezes).
+ *
+ * Colunas: group, name, param, ns_per_op (mediana), ns_min (melhor
+ * amostra), gb_per_s (bytes produzidos / tempo mediano, 0 quando não se
+ * aplica) e fail_rate (falhas / chamadas nas funções de hardware).
+ * ========================================================================== */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "stdrand.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#define BENCH_SEED 0x2545f4914f6cdd1dULL
+#define BENCH_BUF_WORDS 8192
+#define BENCH_BUF_BYTES (BENCH_BUF_WORDS * sizeof(uint64_t))
+#define BENCH_LIMIT32 ((UINT32_C(1) << 31) + 1)
+#define BENCH_LIMIT64 ((UINT64_C(1) << 63) + 1)
+
+/* ===============================================================
+ * ESTADO GLOBAL E SUMIDOUROS
+ * ===============================================================
+ * O acumulador usa XOR (latência de 1 ciclo) para não criar uma
+ * cadeia de dependência mais lenta que o próprio gerador.
+ * =============================================================== */
+
+static uint64_t bench_buf[BENCH_BUF_WORDS];
+static uint64_t bench_fail;
+static volatile uint64_t bench_sink;
+
+static inline uint64_t bench_ubits(uint64_t x) {
+    return x;
+}
+static inline uint64_t bench_fbits(float x) {
+    uint32_t u;
+    memcpy(&u, &x, sizeof(u));
+    return u;
+}
+static inline uint64_t bench_dbits(double x) {
+    uint64_t u;
+    memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+// clang-format off
+#define BENCH_BITS(x) _Generic((x), \
+    float:   bench_fbits,           \
+    double:  bench_dbits,           \
+    default: bench_ubits            \
+)(x)
+// clang-format on
+
+/* Impede que o compilador funda laços de custo O(1) em uma conta só. */
+#if defined(__GNUC__) || defined(__clang__)
+#define BENCH_CLOBBER(x) __asm__ volatile("" : "+r"(x))
+#else
+#define BENCH_CLOBBER(x) ((void)(x))
+#endif
+
+static inline double bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* ===============================================================
+ * GERADORES DE LAÇOS
+ * ===============================================================
+ * Cada medição é uma função com o laço e a chamada direta ao
+ * gerador; o harness só faz uma chamada indireta por amostra.
+ * =============================================================== */
+
+#define BENCH_LOOP(id, type, init, expr)                   \
+    static uint64_t id(size_t n) {                         \
+        type rng = init(BENCH_SEED);                       \
+        uint64_t acc = 0;                                  \
+        for (size_t i = 0; i < n; i++) {                   \
+            acc ^= BENCH_BITS(expr);                       \
+        }                                                  \
+        return acc;                                        \
+    }
+
+#define BENCH_BULK(id, type, init, next)                   \
+    static uint64_t id(size_t n) {                         \
+        type rng = init(BENCH_SEED);                       \
+        for (size_t i = 0; i < n; i++) {                   \
+            bench_buf[i % BENCH_BUF_WORDS] = BENCH_BITS(next(&rng)); \
+        }                                                  \
+        return bench_buf[n % BENCH_BUF_WORDS];             \
+    }
+
+#define BENCH_JUMP(id, type, init, jump)                   \
+    static uint64_t id(size_t n) {                         \
+        type rng = init(BENCH_SEED);                       \
+        for (size_t i = 0; i < n; i++) {                   \
+            jump(&rng);                                    \
+        }                                                  \
+        return rng.s[0];                                   \
+    }
+
+#define BENCH_INIT(id, type, init)                         \
+    static uint64_t id(size_t n) {                         \
+        uint64_t acc = 0;                                  \
+        for (size_t i = 0; i < n; i++) {                   \
+            type rng = init(BENCH_SEED + i);               \
+            acc ^= (uint64_t)rng.s[0];                     \
+        }                                                  \
+        return acc;                                        \
+    }
+
+/* ---------------------------------------------------------------
+ * Chamada à biblioteca x STDFRIGO_INLINE (bench/bench_inline.c)
+ * --------------------------------------------------------------- */
+#define BENCH_INLINE_PAIR(name)    \
+    uint64_t name##_call(size_t n); \
+    uint64_t name##_inline(size_t n);
+
+BENCH_INLINE_PAIR(b_hash32_int)
+BENCH_INLINE_PAIR(b_hash64_int)
+BENCH_INLINE_PAIR(b_hash64_mem)
+BENCH_INLINE_PAIR(b_rand64_next)
+BENCH_INLINE_PAIR(b_rand64_bound)
+
+static rand_secure_t bench_secure;
+
+static rand_secure_t *bench_secure_init(uint64_t seed) {
+    (void)seed;
+    return &bench_secure;
+}
+
+/* ---------------------------------------------------------------
+ * Valor por chamada
+ * --------------------------------------------------------------- */
+BENCH_LOOP(b_next_r32, rand32_t, rand32_init, rand32_next(&rng))
+BENCH_LOOP(b_next_r64, rand64_t, rand64_init, rand64_next(&rng))
+BENCH_LOOP(b_next_rf, rand_float_t, rand_float_init, rand_float_next(&rng))
+BENCH_LOOP(b_next_rd, rand_double_t, rand_double_init, rand_double_next(&rng))
+BENCH_LOOP(b_next_wy, rand_wy_t, rand_wy_init, rand_wy_next(&rng))
+BENCH_LOOP(b_next_sec, rand_secure_t *, bench_secure_init, rand_secure_next(rng))
+
+/* ---------------------------------------------------------------
+ * Vazão em massa (buffer residente em L2)
+ * --------------------------------------------------------------- */
+BENCH_BULK(b_bulk_r32, rand32_t, rand32_init, rand32_next)
+BENCH_BULK(b_bulk_r64, rand64_t, rand64_init, rand64_next)
+BENCH_BULK(b_bulk_rf, rand_float_t, rand_float_init, rand_float_next)
+BENCH_BULK(b_bulk_rd, rand_double_t, rand_double_init, rand_double_next)
+BENCH_BULK(b_bulk_wy, rand_wy_t, rand_wy_init, rand_wy_next)
+
+static uint64_t b_bulk_sec(size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        rand_secure_fill(&bench_secure, bench_buf, BENCH_BUF_BYTES);
+    }
+    return bench_buf[0];
+}
+
+static uint64_t b_bulk_hw(size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (!rand_hw_fill(bench_buf, BENCH_BUF_BYTES))
+            bench_fail++;
+    }
+    return bench_buf[0];
+}
+
+/* ---------------------------------------------------------------
+ * Bound/Range: limite típico e limite adversarial (~50% rejeição)
+ * --------------------------------------------------------------- */
+BENCH_LOOP(b_bound_r32_small, rand32_t, rand32_init, rand32_bound(&rng, 100))
+BENCH_LOOP(b_bound_r32_adv, rand32_t, rand32_init, rand32_bound(&rng, BENCH_LIMIT32))
+BENCH_LOOP(b_range_r32_adv, rand32_t, rand32_init, rand32_range(&rng, 7, 7 + BENCH_LIMIT32))
+BENCH_LOOP(b_bound_r64_small, rand64_t, rand64_init, rand64_bound(&rng, 100))
+BENCH_LOOP(b_bound_r64_adv, rand64_t, rand64_init, rand64_bound(&rng, BENCH_LIMIT64))
+BENCH_LOOP(b_range_r64_adv, rand64_t, rand64_init, rand64_range(&rng, 7, 7 + BENCH_LIMIT64))
+BENCH_LOOP(b_bound_rf, rand_float_t, rand_float_init, rand_float_bound(&rng, 100.0f))
+BENCH_LOOP(b_range_rf, rand_float_t, rand_float_init, rand_float_range(&rng, -1.0f, 1.0f))
+BENCH_LOOP(b_bound_rd, rand_double_t, rand_double_init, rand_double_bound(&rng, 100.0))
+BENCH_LOOP(b_range_rd, rand_double_t, rand_double_init, rand_double_range(&rng, -1.0, 1.0))
+BENCH_LOOP(b_bound_wy_small, rand_wy_t, rand_wy_init, rand_wy_bound(&rng, 100))
+BENCH_LOOP(b_bound_wy_adv, rand_wy_t, rand_wy_init, rand_wy_bound(&rng, BENCH_LIMIT64))
+BENCH_LOOP(b_bound_sec_adv, rand_secure_t *, bench_secure_init, rand_secure_bound(rng, BENCH_LIMIT64))
+
+/* ---------------------------------------------------------------
+ * Jump e Init
+ * --------------------------------------------------------------- */
+BENCH_JUMP(b_jump_r32, rand32_t, rand32_init, rand32_jump)
+BENCH_JUMP(b_jump_r64, rand64_t, rand64_init, rand64_jump)
+BENCH_JUMP(b_jump_rf, rand_float_t, rand_float_init, rand_float_jump)
+BENCH_JUMP(b_jump_rd, rand_double_t, rand_double_init, rand_double_jump)
+
+static uint64_t b_jump_wy(size_t n) {
+    rand_wy_t rng = rand_wy_init(BENCH_SEED);
+    for (size_t i = 0; i < n; i++) {
+        rand_wy_jump(&rng);
+        BENCH_CLOBBER(rng.s);
+    }
+    return rng.s;
+}
+
+BENCH_INIT(b_init_r32, rand32_t, rand32_init)
+BENCH_INIT(b_init_r64, rand64_t, rand64_init)
+BENCH_INIT(b_init_rf, rand_float_t, rand_float_init)
+BENCH_INIT(b_init_rd, rand_double_t, rand_double_init)
+
+static uint64_t b_init_wy(size_t n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+        acc ^= rand_wy_init(BENCH_SEED + i).s;
+    }
+    return acc;
+}
+
+static uint64_t b_init_sec(size_t n) {
+    rand_secure_t rng;
+    for (size_t i = 0; i < n; i++) {
+        if (!rand_secure_init(&rng))
+            bench_fail++;
+    }
+    rand_secure_wipe(&rng);
+    return bench_fail;
+}
+
+/* ---------------------------------------------------------------
+ * Hardware: API pública (com retentativas internas) e instrução
+ * crua (uma tentativa, para medir a taxa de falha do RNG da CPU)
+ * --------------------------------------------------------------- */
+#if defined(__x86_64__) || defined(_M_X64)
+#define BENCH_HW(id, type, call)                           \
+    static uint64_t id(size_t n) {                         \
+        uint64_t acc = 0;                                  \
+        type out = 0;                                      \
+        for (size_t i = 0; i < n; i++) {                   \
+            if (!call(&out))                               \
+                bench_fail++;                              \
+            acc ^= out;                                    \
+        }                                                  \
+        return acc;                                        \
+    }
+
+BENCH_HW(b_hw_fast32, uint32_t, rand32_hw_fast)
+BENCH_HW(b_hw_fast64, uint64_t, rand64_hw_fast)
+BENCH_HW(b_hw_entropy32, uint32_t, rand32_hw_entropy)
+BENCH_HW(b_hw_entropy64, uint64_t, rand64_hw_entropy)
+
+static uint64_t b_hw_seed32(size_t n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+        acc ^= rand32_hw_seed();
+    }
+    return acc;
+}
+
+static uint64_t b_hw_seed64(size_t n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+        acc ^= rand64_hw_seed();
+    }
+    return acc;
+}
+
+__attribute__((target("rdrnd")))
+static uint64_t b_hw_rdrand_step(size_t n) {
+    unsigned long long out = 0;
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!_rdrand64_step(&out))
+            bench_fail++;
+        acc ^= out;
+    }
+    return acc;
+}
+
+__attribute__((target("rdseed")))
+static uint64_t b_hw_rdseed_step(size_t n) {
+    unsigned long long out = 0;
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!_rdseed64_step(&out))
+            bench_fail++;
+        acc ^= out;
+    }
+    return acc;
+}
+
+static bool bench_cpu_has(unsigned leaf, unsigned bit_reg, unsigned bit) {
+    unsigned a, b, c, d;
+    if (!__get_cpuid_count(leaf, 0, &a, &b, &c, &d))
+        return false;
+    return ((bit_reg == 1 ? b : c) >> bit) & 1;
+}
+#endif
+
+/* ===============================================================
+ * TABELA DE MEDIÇÕES
+ * =============================================================== */
+
+typedef enum bench_req {
+    BENCH_ANY,
+    BENCH_SECURE,
+    BENCH_RDRAND,
+    BENCH_RDSEED,
+} bench_req_t;
+
+typedef struct bench_case {
+    const char *group;
+    const char *name;
+    const char *param;
+    uint64_t (*fn)(size_t n);
+    size_t bytes_per_op;
+    bench_req_t req;
+} bench_case_t;
+
+static const bench_case_t bench_cases[] = {
+    {"next", "rand32_next", "", b_next_r32, 0, BENCH_ANY},
+    {"next", "rand64_next", "", b_next_r64, 0, BENCH_ANY},
+    {"next", "rand_float_next", "", b_next_rf, 0, BENCH_ANY},
+    {"next", "rand_double_next", "", b_next_rd, 0, BENCH_ANY},
+    {"next", "rand_wy_next", "", b_next_wy, 0, BENCH_ANY},
+    {"next", "rand_secure_next", "", b_next_sec, 0, BENCH_SECURE},
+
+    {"bulk", "rand32_next", "64KiB", b_bulk_r32, sizeof(uint32_t), BENCH_ANY},
+    {"bulk", "rand64_next", "64KiB", b_bulk_r64, sizeof(uint64_t), BENCH_ANY},
+    {"bulk", "rand_float_next", "64KiB", b_bulk_rf, sizeof(float), BENCH_ANY},
+    {"bulk", "rand_double_next", "64KiB", b_bulk_rd, sizeof(double), BENCH_ANY},
+    {"bulk", "rand_wy_next", "64KiB", b_bulk_wy, sizeof(uint64_t), BENCH_ANY},
+    {"bulk", "rand_secure_fill", "64KiB", b_bulk_sec, BENCH_BUF_BYTES, BENCH_SECURE},
+    {"bulk", "rand_hw_fill", "64KiB", b_bulk_hw, BENCH_BUF_BYTES, BENCH_ANY},
+
+    {"bound", "rand32_bound", "100", b_bound_r32_small, 0, BENCH_ANY},
+    {"bound", "rand32_bound", "2^31+1", b_bound_r32_adv, 0, BENCH_ANY},
+    {"bound", "rand32_range", "2^31+1", b_range_r32_adv, 0, BENCH_ANY},
+    {"bound", "rand64_bound", "100", b_bound_r64_small, 0, BENCH_ANY},
+    {"bound", "rand64_bound", "2^63+1", b_bound_r64_adv, 0, BENCH_ANY},
+    {"bound", "rand64_range", "2^63+1", b_range_r64_adv, 0, BENCH_ANY},
+    {"bound", "rand_float_bound", "100.0", b_bound_rf, 0, BENCH_ANY},
+    {"bound", "rand_float_range", "[-1,1)", b_range_rf, 0, BENCH_ANY},
+    {"bound", "rand_double_bound", "100.0", b_bound_rd, 0, BENCH_ANY},
+    {"bound", "rand_double_range", "[-1,1)", b_range_rd, 0, BENCH_ANY},
+    {"bound", "rand_wy_bound", "100", b_bound_wy_small, 0, BENCH_ANY},
+    {"bound", "rand_wy_bound", "2^63+1", b_bound_wy_adv, 0, BENCH_ANY},
+    {"bound", "rand_secure_bound", "2^63+1", b_bound_sec_adv, 0, BENCH_SECURE},
+
+    {"jump", "rand32_jump", "2^64", b_jump_r32, 0, BENCH_ANY},
+    {"jump", "rand64_jump", "2^128", b_jump_r64, 0, BENCH_ANY},
+    {"jump", "rand_float_jump", "2^64", b_jump_rf, 0, BENCH_ANY},
+    {"jump", "rand_double_jump", "2^64", b_jump_rd, 0, BENCH_ANY},
+    {"jump", "rand_wy_jump", "2^32", b_jump_wy, 0, BENCH_ANY},
+
+    {"init", "rand32_init", "", b_init_r32, 0, BENCH_ANY},
+    {"init", "rand64_init", "", b_init_r64, 0, BENCH_ANY},
+    {"init", "rand_float_init", "", b_init_rf, 0, BENCH_ANY},
+    {"init", "rand_double_init", "", b_init_rd, 0, BENCH_ANY},
+    {"init", "rand_wy_init", "", b_init_wy, 0, BENCH_ANY},
+    {"init", "rand_secure_init", "", b_init_sec, 0, BENCH_ANY},
+
+    {"inline", "hash32_int", "call", b_hash32_int_call, 0, BENCH_ANY},
+    {"inline", "hash32_int", "inline", b_hash32_int_inline, 0, BENCH_ANY},
+    {"inline", "hash64_int", "call", b_hash64_int_call, 0, BENCH_ANY},
+    {"inline", "hash64_int", "inline", b_hash64_int_inline, 0, BENCH_ANY},
+    {"inline", "hash64_mem", "call 16B", b_hash64_mem_call, 0, BENCH_ANY},
+    {"inline", "hash64_mem", "inline 16B", b_hash64_mem_inline, 0, BENCH_ANY},
+    {"inline", "rand64_next", "call", b_rand64_next_call, 0, BENCH_ANY},
+    {"inline", "rand64_next", "inline", b_rand64_next_inline, 0, BENCH_ANY},
+    {"inline", "rand64_bound", "call 100", b_rand64_bound_call, 0, BENCH_ANY},
+    {"inline", "rand64_bound", "inline 100", b_rand64_bound_inline, 0, BENCH_ANY},
+
+#if defined(__x86_64__) || defined(_M_X64)
+    {"hw", "rand32_hw_fast", "", b_hw_fast32, 0, BENCH_ANY},
+    {"hw", "rand64_hw_fast", "", b_hw_fast64, 0, BENCH_ANY},
+    {"hw", "rand32_hw_entropy", "", b_hw_entropy32, 0, BENCH_ANY},
+    {"hw", "rand64_hw_entropy", "", b_hw_entropy64, 0, BENCH_ANY},
+    {"hw", "rand32_hw_seed", "", b_hw_seed32, 0, BENCH_ANY},
+    {"hw", "rand64_hw_seed", "", b_hw_seed64, 0, BENCH_ANY},
+    {"hw", "rdrand64_step", "1 try", b_hw_rdrand_step, 0, BENCH_RDRAND},
+    {"hw", "rdseed64_step", "1 try", b_hw_rdseed_step, 0, BENCH_RDSEED},
+#endif
+};
+
+/* ===============================================================
+ * HARNESS (Calibração + Mediana)
+ * =============================================================== */
+
+typedef struct bench_result {
+    double ns_med;
+    double ns_min;
+    double fail_rate;
+} bench_result_t;
+
+static int bench_cmp_double(const void *a, const void *b) {
+    const double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static bench_result_t bench_run(const bench_case_t *bc, double target_ns, int runs) {
+    size_t n = 1;
+    for (;;) {
+        const double t0 = bench_now_ns();
+        bench_sink ^= bc->fn(n);
+        const double dt = bench_now_ns() - t0;
+        if (dt >= target_ns / 4 || n >= ((size_t)1 << 40))
+            break;
+        n *= dt < target_ns / 64 ? 8 : 2;
+    }
+
+    double samples[64];
+    uint64_t calls = 0;
+    bench_fail = 0;
+    for (int r = 0; r < runs; r++) {
+        const double t0 = bench_now_ns();
+        bench_sink ^= bc->fn(n);
+        samples[r] = (bench_now_ns() - t0) / (double)n;
+        calls += n;
+    }
+    qsort(samples, (size_t)runs, sizeof(double), bench_cmp_double);
+
+    bench_result_t res;
+    res.ns_med = samples[runs / 2];
+    res.ns_min = samples[0];
+    res.fail_rate = (double)bench_fail / (double)calls;
+    return res;
+}
+
+static bool bench_supported(bench_req_t req, bool secure_ok) {
+    switch (req) {
+    case BENCH_SECURE:
+        return secure_ok;
+#if defined(__x86_64__) || defined(_M_X64)
+    case BENCH_RDRAND:
+        return bench_cpu_has(1, 2, 30);
+    case BENCH_RDSEED:
+        return bench_cpu_has(7, 1, 18);
+#else
+    case BENCH_RDRAND:
+    case BENCH_RDSEED:
+        return false;
+#endif
+    default:
+        return true;
+    }
+}
+
+int main(int argc, char **argv) {
+    bool json = false;
+    double target_ms = 20.0;
+    int runs = 5;
+    const char *filter = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            json = false;
+        } else if (strcmp(argv[i], "--ms") == 0 && i + 1 < argc) {
+            target_ms = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            fprintf(stderr, "uso: %s [--csv|--json] [--ms N] [--runs N] [--filter TEXTO]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (runs < 1)
+        runs = 1;
+    if (runs > 64)
+        runs = 64;
+
+    /* O modo inline tem de produzir exatamente os mesmos valores. */
+    for (size_t i = 0; i + 1 < sizeof(bench_cases) / sizeof(bench_cases[0]); i++) {
+        const bench_case_t *call = &bench_cases[i], *inl = &bench_cases[i + 1];
+        if (strcmp(call->group, "inline") == 0 && strcmp(call->name, inl->name) == 0 &&
+            call->fn(4096) != inl->fn(4096)) {
+            fprintf(stderr, "%s: STDFRIGO_INLINE diverge da biblioteca\n", call->name);
+            return 1;
+        }
+    }
+
+    const bool secure_ok = rand_secure_init(&bench_secure);
+    const size_t count = sizeof(bench_cases) / sizeof(bench_cases[0]);
+    bool first = true;
+
+    if (json)
+        printf("{\"target_ms\": %.1f, \"runs\": %d, \"results\": [\n", target_ms, runs);
+    else
+        printf("group,name,param,ns_per_op,ns_min,gb_per_s,fail_rate\n");
+
+    for (size_t i = 0; i < count; i++) {
+        const bench_case_t *bc = &bench_cases[i];
+        if (filter && !strstr(bc->name, filter) && !strstr(bc->group, filter))
+            continue;
+        if (!bench_supported(bc->req, secure_ok))
+            continue;
+
+        const bench_result_t r = bench_run(bc, target_ms * 1e6, runs);
+        const double gbps = bc->bytes_per_op ? (double)bc->bytes_per_op / r.ns_med : 0.0;
+
+        if (json) {
+            printf(
+                "%s  {\"group\": \"%s\", \"name\": \"%s\", \"param\": \"%s\", \"ns_per_op\": %.3f, "
+                "\"ns_min\": %.3f, \"gb_per_s\": %.3f, \"fail_rate\": %.6f}",
+                first ? "" : ",\n", bc->group, bc->name, bc->param, r.ns_med, r.ns_min, gbps,
+                r.fail_rate
+            );
+        } else {
+            printf(
+                "%s,%s,%s,%.3f,%.3f,%.3f,%.6f\n", bc->group, bc->name, bc->param, r.ns_med, r.ns_min,
+                gbps, r.fail_rate
+            );
+        }
+        fflush(stdout);
+        first = false;
+    }
+
+    if (json)
+        printf("\n]}\n");
+    if (secure_ok)
+        rand_secure_wipe(&bench_secure);
+    return 0;
+}
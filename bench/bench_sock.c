@@ -0,0 +1,552 @@
+/* ==========================================================================
+ * STDFRIGO BENCHMARK SUITE (stdsock)
+ * ==========================================================================
+ * Compilar: make bench_sock                (CSV na saída padrão)
+ *           make bench_sock BENCH_ARGS=--json
+ * Opções:   --csv | --json          Formato de saída
+ *           --ms N                  Duração de cada medição (padrão 1000)
+ *           --size N                Bytes por requisição (padrão 64)
+ *           --backend B             loop | uring | epoll | timers | udp | all
+ *                                   (padrão all)
+ *           --sqpoll                io_uring com thread de submissão
+ *
+ * Um servidor echo roda em outra thread, sobre loopback, em cada
+ * backend: net_loop_t (reactor) ou net_aio_t (io_uring ou o fallback
+ * epoll). O cliente usa sockets bloqueantes simples para que o custo
+ * medido seja o do servidor mais o do kernel:
+ *   connect_rate:  connect + 1 requisição + close, em conexões/s.
+ *   echo_latency:  idas e voltas numa conexão persistente; latência
+ *                  p50/p99/p99.9 em microssegundos e requisições/s.
+ *   syscalls:      (só net_aio_t) syscalls do servidor por conexão e
+ *                  por requisição, via net_aio_syscalls.
+ *   timers.*:      (--backend timers) custo de rearmar um timer com
+ *                  10^4, 10^5 e 10^6 timers ativos no net_loop_t, em
+ *                  ns por net_timer_start, e de cancelar + armar.
+ *   udp.*:         datagramas/s sobre loopback, rajadas de 32: um
+ *                  sendto/recvfrom por pacote (single), sendmmsg +
+ *                  recvmmsg (batch) e uma mensagem UDP_SEGMENT
+ *                  recebida com UDP_GRO (gso).
+ * ========================================================================== */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <netinet/tcp.h>
+
+#include "stdsock.h"
+#include "stdmem.h"
+
+#define BENCH_MAX_SIZE 65536
+
+typedef struct bench_conn {
+    net_handle_t handle;
+    net_aio_req_t recv;
+    net_aio_req_t close;
+} bench_conn_t;
+
+typedef struct bench_send {
+    net_aio_req_t req;
+    void *buf;
+} bench_send_t;
+
+static mem_pool_t *bench_conns;
+static mem_pool_t *bench_sends;
+static net_handle_t bench_listener;
+static net_aio_req_t bench_accept;
+
+static inline double bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static int bench_cmp_double(const void *a, const void *b) {
+    const double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* ===============================================================
+ * SERVIDOR ECHO (net_loop_t)
+ * =============================================================== */
+
+static void bench_close(net_loop_t *loop, net_handle_t *handle) {
+    net_loop_del(loop, handle);
+    CLOSESOCKET(handle->fd);
+    mem_pool_release(bench_conns, handle);
+}
+
+static void bench_on_read(net_loop_t *loop, net_handle_t *handle, uint32_t events) {
+    (void)events;
+    static char buf[BENCH_MAX_SIZE];
+    for (;;) {
+        const ptrdiff_t n = net_recv(handle->fd, buf, sizeof(buf));
+        if (n == NET_AGAIN)
+            return;
+        if (n <= 0 || net_send(handle->fd, buf, (size_t)n) != n) {
+            bench_close(loop, handle);
+            return;
+        }
+    }
+}
+
+static void bench_on_accept(net_loop_t *loop, net_handle_t *handle, uint32_t events) {
+    (void)events;
+    socket_t sock;
+    while (ISVALIDSOCKET(sock = net_accept(handle->fd))) {
+        bench_conn_t *conn = mem_pool_alloc(bench_conns);
+        if (!conn) {
+            CLOSESOCKET(sock);
+            continue;
+        }
+        conn->handle = (net_handle_t){.fd = sock, .on_read = bench_on_read};
+        if (!net_loop_add(loop, &conn->handle, NET_EVENT_READ))
+            bench_close(loop, &conn->handle);
+    }
+}
+
+static void *bench_server(void *arg) {
+    net_loop_run(arg);
+    return NULL;
+}
+
+/* ===============================================================
+ * SERVIDOR ECHO (net_aio_t)
+ * ===============================================================
+ * O eco sai direto do buffer provido do recv (sem cópia); o buffer
+ * volta ao anel quando o send conclui.
+ * =============================================================== */
+
+static void bench_aio_on_close(net_aio_t *aio, net_aio_req_t *req, const net_aio_event_t *ev) {
+    (void)aio;
+    (void)ev;
+    mem_pool_release(bench_conns, req->ctx);
+}
+
+static void bench_aio_on_send(net_aio_t *aio, net_aio_req_t *req, const net_aio_event_t *ev) {
+    bench_send_t *send = (bench_send_t *)req;
+    if (ev->res > 0 && (size_t)ev->res < req->len) {
+        /* Envio parcial: reenvia o restante com o mesmo pedido. */
+        const size_t left = req->len - (size_t)ev->res;
+        if (net_aio_send(aio, req, req->fd, (char *)req->buf + ev->res, left, 0, bench_aio_on_send, NULL))
+            return;
+    }
+    net_aio_buffer_release(aio, send->buf);
+    mem_pool_release(bench_sends, send);
+}
+
+static void bench_aio_on_recv(net_aio_t *aio, net_aio_req_t *req, const net_aio_event_t *ev) {
+    bench_conn_t *conn = req->ctx;
+    if (!(ev->flags & NET_AIO_MORE)) {
+        if (ev->buf)
+            net_aio_buffer_release(aio, ev->buf);
+        net_aio_close(aio, &conn->close, req->fd, bench_aio_on_close, conn);
+        return;
+    }
+    bench_send_t *send = mem_pool_alloc(bench_sends);
+    if (!send) {
+        net_aio_buffer_release(aio, ev->buf);
+        return;
+    }
+    memset(send, 0, sizeof(*send));
+    send->buf = ev->buf;
+    if (!net_aio_send(aio, &send->req, req->fd, ev->buf, (size_t)ev->res, 0, bench_aio_on_send, NULL)) {
+        net_aio_buffer_release(aio, ev->buf);
+        mem_pool_release(bench_sends, send);
+    }
+}
+
+static void bench_aio_on_accept(net_aio_t *aio, net_aio_req_t *req, const net_aio_event_t *ev) {
+    (void)req;
+    if (ev->res < 0)
+        return;
+    bench_conn_t *conn = mem_pool_alloc(bench_conns);
+    if (!conn) {
+        CLOSESOCKET((socket_t)ev->res);
+        return;
+    }
+    memset(conn, 0, sizeof(*conn));
+    net_set_nodelay((socket_t)ev->res, true);
+    if (!net_aio_recv(aio, &conn->recv, (socket_t)ev->res, bench_aio_on_recv, conn)) {
+        CLOSESOCKET((socket_t)ev->res);
+        mem_pool_release(bench_conns, conn);
+    }
+}
+
+static void *bench_aio_server(void *arg) {
+    net_aio_run(arg);
+    return NULL;
+}
+
+/* ===============================================================
+ * CLIENTE (Bloqueante)
+ * =============================================================== */
+
+static socket_t bench_dial(uint16_t port) {
+    socket_t sock = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(port)};
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    const int one = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        CLOSESOCKET(sock);
+        return INVALID_SOCKET;
+    }
+    return sock;
+}
+
+static bool bench_roundtrip(socket_t sock, char *buf, size_t size) {
+    if (send(sock, buf, size, MSG_NOSIGNAL) != (ssize_t)size)
+        return false;
+    for (size_t got = 0; got < size;) {
+        const ssize_t n = recv(sock, buf + got, size - got, 0);
+        if (n <= 0)
+            return false;
+        got += (size_t)n;
+    }
+    return true;
+}
+
+static void bench_print(bool json, bool *first, const char *name, const char *metric, double value,
+                        const char *unit) {
+    if (json) {
+        printf("%s  {\"name\": \"%s\", \"metric\": \"%s\", \"value\": %.3f, \"unit\": \"%s\"}",
+               *first ? "" : ",\n", name, metric, value, unit);
+    } else {
+        printf("%s,%s,%.3f,%s\n", name, metric, value, unit);
+    }
+    *first = false;
+}
+
+/* ===============================================================
+ * MEDIÇÕES
+ * =============================================================== */
+
+typedef struct bench_server {
+    const char *name;
+    net_loop_t *loop;
+    net_aio_t *aio;
+    socket_t listener;
+    pthread_t thread;
+} bench_server_t;
+
+static void bench_start(bench_server_t *srv) {
+    if (srv->aio)
+        pthread_create(&srv->thread, NULL, bench_aio_server, srv->aio);
+    else
+        pthread_create(&srv->thread, NULL, bench_server, srv->loop);
+}
+
+/* Parar entre as fases deixa ler net_aio_syscalls sem corrida. */
+static uint64_t bench_stop(bench_server_t *srv) {
+    if (srv->aio)
+        net_aio_stop(srv->aio);
+    else
+        net_loop_stop(srv->loop);
+    pthread_join(srv->thread, NULL);
+    return srv->aio ? net_aio_syscalls(srv->aio) : 0;
+}
+
+static bool bench_setup(bench_server_t *srv, const char *name, net_aio_backend_t backend, bool sqpoll) {
+    memset(srv, 0, sizeof(*srv));
+    srv->name = name;
+    srv->listener = net_listen_tcp("127.0.0.1", 0, 0, 0);
+    if (!ISVALIDSOCKET(srv->listener))
+        return false;
+    if (backend == NET_AIO_AUTO) {
+        srv->loop = net_loop_init(0);
+        bench_listener = (net_handle_t){.fd = srv->listener, .on_read = bench_on_accept};
+        return srv->loop && net_loop_add(srv->loop, &bench_listener, NET_EVENT_READ);
+    }
+    net_aio_config_t config = {.backend = backend, .sqpoll = sqpoll, .buffer_size = BENCH_MAX_SIZE};
+    srv->aio = net_aio_init(&config);
+    memset(&bench_accept, 0, sizeof(bench_accept));
+    return srv->aio && net_aio_accept(srv->aio, &bench_accept, srv->listener, bench_aio_on_accept, NULL) &&
+           net_aio_submit(srv->aio);
+}
+
+static void bench_teardown(bench_server_t *srv) {
+    CLOSESOCKET(srv->listener);
+    net_loop_free(srv->loop);
+    net_aio_free(srv->aio);
+}
+
+static bool bench_measure(bench_server_t *srv, bool json, bool *first, double target_ms, char *buf, size_t size) {
+    const uint16_t port = net_local_port(srv->listener);
+    char name[64];
+
+    /* Conexões curtas: mede accept + registro + close no servidor. */
+    bench_start(srv);
+    uint64_t conns = 0;
+    double t0 = bench_now_ns(), elapsed;
+    do {
+        socket_t sock = bench_dial(port);
+        if (!ISVALIDSOCKET(sock) || !bench_roundtrip(sock, buf, size)) {
+            fprintf(stderr, "bench_sock: conexão falhou (%s)\n", srv->name);
+            return false;
+        }
+        CLOSESOCKET(sock);
+        conns++;
+        elapsed = bench_now_ns() - t0;
+    } while (elapsed < target_ms * 1e6);
+    const uint64_t conn_calls = bench_stop(srv);
+    snprintf(name, sizeof(name), "%s.connect_rate", srv->name);
+    bench_print(json, first, name, "conn_per_s", (double)conns / (elapsed / 1e9), "1/s");
+
+    /* Conexão persistente: latência por requisição. */
+    bench_start(srv);
+    socket_t sock = bench_dial(port);
+    size_t cap = 1 << 16, count = 0;
+    double *lat = malloc(cap * sizeof(double));
+    t0 = bench_now_ns();
+    do {
+        const double start = bench_now_ns();
+        if (!ISVALIDSOCKET(sock) || !bench_roundtrip(sock, buf, size)) {
+            fprintf(stderr, "bench_sock: echo falhou (%s)\n", srv->name);
+            return false;
+        }
+        const double end = bench_now_ns();
+        if (count == cap) {
+            cap *= 2;
+            lat = realloc(lat, cap * sizeof(double));
+        }
+        lat[count++] = end - start;
+        elapsed = end - t0;
+    } while (elapsed < target_ms * 1e6);
+    CLOSESOCKET(sock);
+    const uint64_t echo_calls = bench_stop(srv) - conn_calls;
+    qsort(lat, count, sizeof(double), bench_cmp_double);
+    snprintf(name, sizeof(name), "%s.echo_latency", srv->name);
+    bench_print(json, first, name, "req_per_s", (double)count / (elapsed / 1e9), "1/s");
+    bench_print(json, first, name, "p50", lat[count / 2] / 1e3, "us");
+    bench_print(json, first, name, "p99", lat[count * 99 / 100] / 1e3, "us");
+    bench_print(json, first, name, "p99.9", lat[count * 999 / 1000] / 1e3, "us");
+    free(lat);
+
+    if (srv->aio) {
+        snprintf(name, sizeof(name), "%s.syscalls", srv->name);
+        bench_print(json, first, name, "per_conn", (double)conn_calls / (double)conns, "calls");
+        bench_print(json, first, name, "per_req", (double)echo_calls / (double)count, "calls");
+    }
+    return true;
+}
+
+/* ===============================================================
+ * TIMERS
+ * =============================================================== */
+
+static void bench_timer_fire(net_loop_t *loop, net_timer_t *timer) {
+    (void)loop;
+    (void)timer;
+}
+
+/* Rearma timers espalhados (passo ímpar sobre o vetor) como um
+ * servidor que renova o timeout de ociosidade a cada pacote. */
+static bool bench_timers(bool json, bool *first, double target_ms) {
+    static const size_t counts[] = {10000, 100000, 1000000};
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        const size_t n = counts[c];
+        net_loop_t *loop = net_loop_init(0);
+        net_timer_t *timers = calloc(n, sizeof(net_timer_t));
+        if (!loop || !timers) {
+            fprintf(stderr, "bench_sock: falha ao criar %zu timers\n", n);
+            return false;
+        }
+        net_loop_run_once(loop, 0);
+        for (size_t i = 0; i < n; i++) {
+            net_timer_init(&timers[i], bench_timer_fire, NULL);
+            net_timer_start(loop, &timers[i], 10000 + (i * 7919) % 50000);
+        }
+        char name[64];
+        for (int cancel = 0; cancel < 2; cancel++) {
+            uint64_t ops = 0;
+            size_t i = 0;
+            const double t0 = bench_now_ns();
+            double elapsed;
+            do {
+                for (int k = 0; k < 1024; k++) {
+                    i = (i + 104729) % n;
+                    if (cancel)
+                        net_timer_stop(loop, &timers[i]);
+                    net_timer_start(loop, &timers[i], 30000 + (ops & 1023));
+                    ops++;
+                }
+                elapsed = bench_now_ns() - t0;
+            } while (elapsed < target_ms * 1e6);
+            snprintf(name, sizeof(name), "timers.%s_%zu", cancel ? "stop_start" : "rearm", n);
+            bench_print(json, first, name, "ns_per_op", elapsed / (double)ops, "ns");
+        }
+        net_loop_free(loop);
+        free(timers);
+    }
+    return true;
+}
+
+/* ===============================================================
+ * DATAGRAMAS
+ * =============================================================== */
+
+#define BENCH_UDP_BURST 32
+#define BENCH_UDP_MAX 1400
+
+typedef enum { BENCH_UDP_SINGLE, BENCH_UDP_BATCH, BENCH_UDP_GSO } bench_udp_mode_t;
+
+/* Envia uma rajada e recebe até ela voltar inteira; devolve os
+ * datagramas lógicos recebidos (ou 0 se algo falhou). */
+static unsigned bench_udp_burst(bench_udp_mode_t mode, socket_t tx, socket_t rx, net_dgram_batch_t *out,
+                                net_dgram_batch_t *in, char *buf, size_t size) {
+    const size_t want = size * BENCH_UDP_BURST;
+    if (mode == BENCH_UDP_SINGLE) {
+        for (unsigned i = 0; i < BENCH_UDP_BURST; i++)
+            if (net_send(tx, buf, size) != (ptrdiff_t)size)
+                return 0;
+    } else if (net_dgram_send(tx, out, mode == BENCH_UDP_GSO ? 1u : BENCH_UDP_BURST) <= 0) {
+        return 0;
+    }
+    size_t got = 0;
+    while (got < want) {
+        if (mode == BENCH_UDP_SINGLE) {
+            const ptrdiff_t n = recv(rx, buf, size, MSG_DONTWAIT);
+            if (n > 0)
+                got += (size_t)n;
+            else if (n < 0 && errno != EAGAIN)
+                return 0;
+            continue;
+        }
+        const int n = net_dgram_recv(rx, in);
+        if (n == NET_ERROR)
+            return 0;
+        for (int i = 0; i < n; i++)
+            got += in->msgs[i].len;
+    }
+    return BENCH_UDP_BURST;
+}
+
+static bool bench_udp(bool json, bool *first, double target_ms, char *buf, size_t size) {
+    static const char *const names[] = {"udp.single", "udp.batch", "udp.gso"};
+    if (size > BENCH_UDP_MAX)
+        size = BENCH_UDP_MAX;
+    socket_t rx = net_udp_bind("127.0.0.1", 0, 0);
+    socket_t tx = ISVALIDSOCKET(rx) ? net_udp_connect("127.0.0.1", net_local_port(rx)) : INVALID_SOCKET;
+    net_dgram_batch_t *out = net_dgram_batch_init(BENCH_UDP_BURST, size * BENCH_UDP_BURST);
+    net_dgram_batch_t *in = net_dgram_batch_init(BENCH_UDP_BURST, 65536);
+    bool ok = ISVALIDSOCKET(tx) && out && in;
+    if (ok) {
+        net_set_rcvbuf(rx, 4 << 20);
+        net_set_sndbuf(tx, 4 << 20);
+        for (unsigned i = 0; i < BENCH_UDP_BURST; i++)
+            memset(out->msgs[i].data, 'x', size * BENCH_UDP_BURST);
+    }
+    for (int mode = BENCH_UDP_SINGLE; ok && mode <= BENCH_UDP_GSO; mode++) {
+        for (unsigned i = 0; i < BENCH_UDP_BURST; i++) {
+            out->msgs[i].len = size;
+            out->msgs[i].segment = 0;
+        }
+        if (mode == BENCH_UDP_GSO) {
+            if (!net_udp_set_gro(rx, true))
+                break;
+            out->msgs[0].len = size * BENCH_UDP_BURST;
+            out->msgs[0].segment = (uint16_t)size;
+        }
+        uint64_t packets = 0;
+        const double t0 = bench_now_ns();
+        double elapsed;
+        do {
+            const unsigned n = bench_udp_burst((bench_udp_mode_t)mode, tx, rx, out, in, buf, size);
+            if (!n) {
+                fprintf(stderr, "bench_sock: rajada UDP falhou (%s)\n", names[mode]);
+                ok = false;
+                break;
+            }
+            packets += n;
+            elapsed = bench_now_ns() - t0;
+        } while (elapsed < target_ms * 1e6);
+        if (ok)
+            bench_print(json, first, names[mode], "pkt_per_s", (double)packets / (elapsed / 1e9), "1/s");
+    }
+    net_dgram_batch_free(out);
+    net_dgram_batch_free(in);
+    if (ISVALIDSOCKET(tx))
+        CLOSESOCKET(tx);
+    if (ISVALIDSOCKET(rx))
+        CLOSESOCKET(rx);
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    bool json = false, sqpoll = false;
+    double target_ms = 1000.0;
+    size_t size = 64;
+    const char *backend = "all";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            json = false;
+        } else if (strcmp(argv[i], "--ms") == 0 && i + 1 < argc) {
+            target_ms = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            size = (size_t)atol(argv[++i]);
+        } else if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc) {
+            backend = argv[++i];
+        } else if (strcmp(argv[i], "--sqpoll") == 0) {
+            sqpoll = true;
+        } else {
+            fprintf(stderr,
+                    "uso: %s [--csv|--json] [--ms N] [--size N] [--backend loop|uring|epoll|timers|udp|all] [--sqpoll]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (size < 1 || size > BENCH_MAX_SIZE)
+        size = 64;
+
+    bench_conns = mem_pool_init(sizeof(bench_conn_t), 0);
+    bench_sends = mem_pool_init(sizeof(bench_send_t), 0);
+    if (!bench_conns || !bench_sends) {
+        fprintf(stderr, "bench_sock: falha ao criar os pools\n");
+        return 1;
+    }
+
+    static char buf[BENCH_MAX_SIZE];
+    memset(buf, 'x', size);
+    bool first = true;
+    if (json)
+        printf("{\"target_ms\": %.1f, \"size\": %zu, \"results\": [\n", target_ms, size);
+    else
+        printf("name,metric,value,unit\n");
+
+    static const struct {
+        const char *name;
+        net_aio_backend_t backend;
+    } backends[] = {{"loop", NET_AIO_AUTO}, {"uring", NET_AIO_URING}, {"epoll", NET_AIO_EPOLL}};
+    for (size_t i = 0; i < sizeof(backends) / sizeof(backends[0]); i++) {
+        if (strcmp(backend, "all") != 0 && strcmp(backend, backends[i].name) != 0)
+            continue;
+        bench_server_t srv;
+        if (!bench_setup(&srv, backends[i].name, backends[i].backend, sqpoll)) {
+            fprintf(stderr, "bench_sock: backend %s indisponível\n", backends[i].name);
+            bench_teardown(&srv);
+            continue;
+        }
+        const bool ok = bench_measure(&srv, json, &first, target_ms, buf, size);
+        bench_teardown(&srv);
+        if (!ok)
+            return 1;
+    }
+
+    if ((strcmp(backend, "all") == 0 || strcmp(backend, "timers") == 0) && !bench_timers(json, &first, target_ms))
+        return 1;
+    if ((strcmp(backend, "all") == 0 || strcmp(backend, "udp") == 0) && !bench_udp(json, &first, target_ms, buf, size))
+        return 1;
+
+    if (json)
+        printf("\n]}\n");
+
+    mem_pool_free(bench_sends);
+    mem_pool_free(bench_conns);
+    return 0;
+}
@@ -6,5 +6,8 @@
 #include <stdrand.h>
 #include <stdhash.h>
 #include <stdconst.h>
+#include <stdthrd.h>
+#include <stdmem.h>
+#include <stdprof.h>
 
 #endif
@@ -0,0 +1,313 @@
+#ifndef STDFRIGO_HPP
+#define STDFRIGO_HPP
+
+#ifndef __cplusplus
+#error "stdfrigo.hpp requer um compilador C++ (use stdfrigo.h em C)."
+#endif
+
+#include <stdfrigo.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace frigo {
+
+/* ===============================================================
+ * TRAÇOS DOS GERADORES (Detalhe Interno)
+ * ===============================================================
+ * Cada gerador expõe apenas bits inteiros uniformes: rand_float_t
+ * entrega os 24 bits da mantissa e rand_double_t os 53 bits, o que
+ * mantém as distribuições de <random> exatas.
+ * =============================================================== */
+
+namespace detail {
+
+template <typename State> struct rand_traits;
+
+template <> struct rand_traits<rand32_t> {
+    using result_type = uint32_t;
+    static constexpr result_type max = UINT32_MAX;
+    static rand32_t init(uint64_t seed) { return rand32_init(seed); }
+    static result_type next(rand32_t *rng) { return rand32_next(rng); }
+    static void jump(rand32_t *rng) { rand32_jump(rng); }
+};
+
+template <> struct rand_traits<rand64_t> {
+    using result_type = uint64_t;
+    static constexpr result_type max = UINT64_MAX;
+    static rand64_t init(uint64_t seed) { return rand64_init(seed); }
+    static result_type next(rand64_t *rng) { return rand64_next(rng); }
+    static void jump(rand64_t *rng) { rand64_jump(rng); }
+};
+
+template <> struct rand_traits<rand_float_t> {
+    using result_type = uint32_t;
+    static constexpr result_type max = (UINT32_C(1) << 24) - 1;
+    static rand_float_t init(uint64_t seed) { return rand_float_init(seed); }
+    static result_type next(rand_float_t *rng) {
+        return static_cast<result_type>(rand_float_next(rng) * 0x1.0p24f);
+    }
+    static void jump(rand_float_t *rng) { rand_float_jump(rng); }
+};
+
+template <> struct rand_traits<rand_double_t> {
+    using result_type = uint64_t;
+    static constexpr result_type max = (UINT64_C(1) << 53) - 1;
+    static rand_double_t init(uint64_t seed) { return rand_double_init(seed); }
+    static result_type next(rand_double_t *rng) {
+        return static_cast<result_type>(rand_double_next(rng) * 0x1.0p53);
+    }
+    static void jump(rand_double_t *rng) { rand_double_jump(rng); }
+};
+
+template <> struct rand_traits<rand_wy_t> {
+    using result_type = uint64_t;
+    static constexpr result_type max = UINT64_MAX;
+    static rand_wy_t init(uint64_t seed) { return rand_wy_init(seed); }
+    static result_type next(rand_wy_t *rng) { return rand_wy_next(rng); }
+    static void jump(rand_wy_t *rng) { rand_wy_jump(rng); }
+};
+
+} // namespace detail
+
+/* ===============================================================
+ * UNIFORM RANDOM BIT GENERATORS
+ * ===============================================================
+ * Adaptadores compatíveis com std::shuffle, std::sample e as
+ * distribuições de <random>. discard(n) é O(1) no wyrand (contador
+ * de Weyl) e O(n) nos xoshiro; jump() avança 2^64/2^128 passos
+ * (ver rand_jump) e split() devolve um fluxo independente.
+ * =============================================================== */
+
+template <typename State> class rand_engine {
+    using traits = detail::rand_traits<State>;
+
+  public:
+    using state_type = State;
+    using result_type = typename traits::result_type;
+
+    static constexpr uint64_t default_seed = 0x853c49e6748fea9bULL;
+
+    rand_engine() : rand_engine(default_seed) {}
+    explicit rand_engine(uint64_t seed) : state_(traits::init(seed)) {}
+    explicit rand_engine(const State &state) : state_(state) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return traits::max; }
+
+    result_type operator()() { return traits::next(&state_); }
+
+    void seed(uint64_t seed = default_seed) { state_ = traits::init(seed); }
+
+    void discard(unsigned long long count) {
+        if constexpr (std::is_same_v<State, rand_wy_t>) {
+            state_.s += static_cast<uint64_t>(count) * _STDRAND_WY_P0_;
+        } else {
+            while (count--) {
+                traits::next(&state_);
+            }
+        }
+    }
+
+    void jump() { traits::jump(&state_); }
+
+    rand_engine split() {
+        rand_engine child = *this;
+        traits::jump(&state_);
+        return child;
+    }
+
+    State *native() { return &state_; }
+    const State *native() const { return &state_; }
+
+  private:
+    State state_;
+};
+
+using rand32_engine = rand_engine<rand32_t>;
+using rand64_engine = rand_engine<rand64_t>;
+using rand_float_engine = rand_engine<rand_float_t>;
+using rand_double_engine = rand_engine<rand_double_t>;
+using rand_wy_engine = rand_engine<rand_wy_t>;
+
+/* ===============================================================
+ * URBG CRIPTOGRÁFICO (rand_secure_t)
+ * ===============================================================
+ * Não copiável (duplicar o estado repetiria o fluxo). Lança
+ * std::runtime_error se não houver fonte de entropia e apaga a
+ * chave no destrutor.
+ * =============================================================== */
+
+class secure_engine {
+  public:
+    using state_type = rand_secure_t;
+    using result_type = uint64_t;
+
+    secure_engine() {
+        if (!rand_secure_init(&state_)) {
+            throw std::runtime_error("frigo::secure_engine: nenhuma fonte de entropia");
+        }
+    }
+    ~secure_engine() { rand_secure_wipe(&state_); }
+
+    secure_engine(const secure_engine &) = delete;
+    secure_engine &operator=(const secure_engine &) = delete;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()() { return rand_secure_next(&state_); }
+
+    void discard(unsigned long long count) {
+        while (count--) {
+            rand_secure_next(&state_);
+        }
+    }
+
+    bool reseed() { return rand_secure_reseed(&state_); }
+    void fill(void *buf, size_t size) { rand_secure_fill(&state_, buf, size); }
+
+    rand_secure_t *native() { return &state_; }
+
+  private:
+    rand_secure_t state_;
+};
+
+/* ===============================================================
+ * FUNCTOR DE HASH (Drop-in para Containers da STL)
+ * ===============================================================
+ * frigo::hash<T> substitui std::hash<T> (identidade para inteiros
+ * na libstdc++) por hash64_int, e usa hash64_mem para strings.
+ * Todos são transparentes: combinados com std::equal_to<> permitem
+ * buscar em unordered_map<std::string, V> com string_view ou
+ * const char* sem construir std::string temporária.
+ * =============================================================== */
+
+template <typename T, typename = void> struct hash;
+
+template <typename T>
+struct hash<T, std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>>> {
+    using is_transparent = void;
+
+    template <typename U, typename = std::enable_if_t<std::is_integral_v<U> || std::is_enum_v<U>>>
+    size_t operator()(U num) const noexcept {
+        return static_cast<size_t>(hash64_int(static_cast<uint64_t>(num)));
+    }
+};
+
+namespace detail {
+
+template <typename Char, typename Traits> struct string_hash {
+    using is_transparent = void;
+
+    size_t operator()(std::basic_string_view<Char, Traits> str) const noexcept {
+        return static_cast<size_t>(hash64_mem(str.data(), str.size() * sizeof(Char)));
+    }
+};
+
+} // namespace detail
+
+template <typename Char, typename Traits, typename Alloc>
+struct hash<std::basic_string<Char, Traits, Alloc>> : detail::string_hash<Char, Traits> {};
+
+template <typename Char, typename Traits>
+struct hash<std::basic_string_view<Char, Traits>> : detail::string_hash<Char, Traits> {};
+
+/* ===============================================================
+ * MEMORY RESOURCE SOBRE mem_arena_t (std::pmr)
+ * ===============================================================
+ * Containers std::pmr alocam por bump-pointer na arena; deallocate
+ * é no-op e a memória volta em bloco com reset() ou no destrutor.
+ * Lança std::bad_alloc se o mmap falhar. arena_checkpoint é um
+ * guard RAII que restaura a arena ao sair do escopo.
+ * =============================================================== */
+
+class arena_resource : public std::pmr::memory_resource {
+  public:
+    explicit arena_resource(size_t chunk_size = 0, unsigned flags = 0) {
+        if (!mem_arena_init(&arena_, chunk_size, flags)) {
+            throw std::bad_alloc();
+        }
+    }
+    ~arena_resource() override { mem_arena_free(&arena_); }
+
+    arena_resource(const arena_resource &) = delete;
+    arena_resource &operator=(const arena_resource &) = delete;
+
+    void reset() noexcept { mem_arena_reset(&arena_); }
+    void trim() noexcept { mem_arena_trim(&arena_); }
+    mem_arena_mark_t save() const noexcept { return mem_arena_save(&arena_); }
+    void restore(mem_arena_mark_t mark) noexcept { mem_arena_restore(&arena_, mark); }
+
+    mem_arena_t *native() noexcept { return &arena_; }
+
+  private:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        void *ptr = mem_arena_alloc_aligned(&arena_, bytes, alignment);
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+    void do_deallocate(void *, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+    mem_arena_t arena_;
+};
+
+class arena_checkpoint {
+  public:
+    explicit arena_checkpoint(mem_arena_t *arena) noexcept
+        : arena_(arena), mark_(mem_arena_save(arena)) {}
+    explicit arena_checkpoint(arena_resource &resource) noexcept
+        : arena_checkpoint(resource.native()) {}
+    ~arena_checkpoint() { mem_arena_restore(arena_, mark_); }
+
+    arena_checkpoint(const arena_checkpoint &) = delete;
+    arena_checkpoint &operator=(const arena_checkpoint &) = delete;
+
+  private:
+    mem_arena_t *arena_;
+    mem_arena_mark_t mark_;
+};
+
+/* ===============================================================
+ * SONDA RAII (stdprof)
+ * ===============================================================
+ * prof_scope lê o relógio no construtor e registra no site ao sair
+ * do escopo, inclusive por exceção ou return antecipado.
+ * FRIGO_PROF_SCOPE(name) declara o site estático e o guard.
+ * =============================================================== */
+
+class prof_scope {
+  public:
+    explicit prof_scope(prof_site_t &site) noexcept : site_(&site), start_(prof_ticks()) {}
+    ~prof_scope() { prof_record(site_, prof_ticks() - start_); }
+
+    prof_scope(const prof_scope &) = delete;
+    prof_scope &operator=(const prof_scope &) = delete;
+
+  private:
+    prof_site_t *site_;
+    uint64_t start_;
+};
+
+} // namespace frigo
+
+#if defined(STDPROF_DISABLE)
+#define FRIGO_PROF_SCOPE(name) static_cast<void>(0)
+#else
+#define FRIGO_PROF_SCOPE(name)                                                 \
+    static prof_site_t _prof_site_##name = {#name, __FILE__, __LINE__, 0};     \
+    frigo::prof_scope _prof_scope_##name(_prof_site_##name)
+#endif
+
+#endif
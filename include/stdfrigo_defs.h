@@ -27,4 +27,20 @@
 
 #define STDFRIGO_VERSION_HEX ((STDFRIGO_VER_MAJOR << 16) | (STDFRIGO_VER_MINOR << 8) | (STDFRIGO_VER_PATCH))
 
+/* ===============================================================
+ * MODO INLINE (STDFRIGO_INLINE)
+ * ===============================================================
+ * Definido antes do primeiro #include da suíte, expõe as primitivas
+ * curtas de hash e rand como static inline nos headers, para que
+ * inlinem no chamador sem depender de LTO. A biblioteca continua
+ * exportando os mesmos símbolos, compilados do mesmo código; as
+ * duas formas podem coexistir no mesmo programa.
+ * =============================================================== */
+
+#if defined(STDFRIGO_INLINE)
+#define STDFRIGO_INLINE_API static inline
+#else
+#define STDFRIGO_INLINE_API
+#endif
+
 #endif
@@ -0,0 +1,216 @@
+#ifndef STDMEM_H
+#define STDMEM_H
+
+#include <stdfrigo_defs.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef __cplusplus
+#include <stdalign.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ===============================================================
+ * ARENA (Bump-Pointer por Região)
+ * ===============================================================
+ * Cada alocação apenas avança um ponteiro dentro do chunk atual;
+ * não há free individual. Chunks vêm direto do mmap (opcionalmente
+ * em huge pages) e formam uma lista: quando o chunk acaba, a arena
+ * passa ao próximo já mapeado ou mapeia outro.
+ *
+ * mem_arena_save/restore: Checkpoint (chunk + ponteiro). Restaurar
+ *                         libera de uma vez tudo o que foi alocado
+ *                         depois do save.
+ * mem_arena_reset:        O(1). Volta ao início do primeiro chunk e
+ *                         mantém os chunks mapeados para reuso.
+ * mem_arena_trim:         Devolve ao sistema os chunks livres.
+ * mem_arena_free:         Desmapeia tudo.
+ * =============================================================== */
+
+#define MEM_ARENA_HUGE_PAGES 0x1u
+
+typedef struct mem_chunk mem_chunk_t;
+
+typedef struct mem_arena {
+    unsigned char *ptr;
+    unsigned char *end;
+    mem_chunk_t *chunk;
+    mem_chunk_t *head;
+    size_t chunk_size;
+    size_t mapped;
+    unsigned flags;
+} mem_arena_t;
+
+typedef struct mem_arena_mark {
+    mem_chunk_t *chunk;
+    unsigned char *ptr;
+} mem_arena_mark_t;
+
+bool mem_arena_init(mem_arena_t *arena, size_t chunk_size, unsigned flags);
+void mem_arena_free(mem_arena_t *arena);
+void mem_arena_reset(mem_arena_t *arena);
+void mem_arena_trim(mem_arena_t *arena);
+void *mem_arena_grow(mem_arena_t *arena, size_t size, size_t align);
+
+/* Caminho rápido inline: alinhar, comparar e avançar o ponteiro.
+ * align deve ser potência de 2. Devolve NULL se o mmap falhar. */
+static inline void *mem_arena_alloc_aligned(mem_arena_t *arena, size_t size, size_t align) {
+    const uintptr_t ptr = ((uintptr_t)arena->ptr + (align - 1)) & ~(uintptr_t)(align - 1);
+    if (ptr <= (uintptr_t)arena->end && size <= (uintptr_t)arena->end - ptr) {
+        arena->ptr = (unsigned char *)ptr + size;
+        return (void *)ptr;
+    }
+    return mem_arena_grow(arena, size, align);
+}
+
+static inline void *mem_arena_alloc(mem_arena_t *arena, size_t size) {
+    return mem_arena_alloc_aligned(arena, size, alignof(max_align_t));
+}
+
+static inline mem_arena_mark_t mem_arena_save(const mem_arena_t *arena) {
+    mem_arena_mark_t mark = {arena->chunk, arena->ptr};
+    return mark;
+}
+
+void mem_arena_restore(mem_arena_t *arena, mem_arena_mark_t mark);
+
+/* ===============================================================
+ * POOL DE OBJETOS DE TAMANHO FIXO (Slab + Magazines)
+ * ===============================================================
+ * Slots alinhados a 64 bytes (o tamanho é arredondado para a linha
+ * de cache). Cada thread guarda dois magazines (pilhas de até 64
+ * objetos livres): alloc e release só tocam memória da própria
+ * thread, sem lock nem atômico. Magazines cheios ou vazios trocam
+ * de mãos por um depósito global lock-free, que rebalanceia
+ * objetos entre threads produtoras e consumidoras. Ao sair, a
+ * thread devolve seus magazines ao depósito.
+ *
+ * MEM_POOL_POISON: Depuração. release preenche o slot com 0xDD e
+ * alloc confere o padrão (escrita após free aborta o processo) e
+ * entrega o slot preenchido com 0xCD.
+ * =============================================================== */
+
+#define MEM_POOL_POISON 0x1u
+
+typedef struct mem_pool mem_pool_t;
+
+mem_pool_t *mem_pool_init(size_t size, unsigned flags);
+void mem_pool_free(mem_pool_t *pool);
+size_t mem_pool_slot_size(const mem_pool_t *pool);
+
+void *mem_pool_alloc(mem_pool_t *pool);
+void mem_pool_release(mem_pool_t *pool, void *obj);
+void mem_pool_flush(mem_pool_t *pool);
+
+/* ===============================================================
+ * BUFFERS COM CONTAGEM DE REFERÊNCIAS E CADEIAS
+ * ===============================================================
+ * mem_buf_t: Bloco opaco com contador atômico. new aloca os dados
+ *            junto do cabeçalho; wrap adota memória do chamador e
+ *            chama release(data, ctx) quando a última referência
+ *            cai (release NULL: memória estática). ref/unref podem
+ *            vir de threads diferentes.
+ * mem_chain_t: Fila de fatias (buf, data, len) que referenciam
+ *            pedaços de buffers sem copiar. Montar uma resposta é
+ *            anexar cabeçalho, corpo e rodapé; o envio
+ *            (net_send_chain em stdsock.h) faz um writev e consome
+ *            o que saiu, soltando as referências. splice move os
+ *            primeiros bytes de uma cadeia para outra (uma fatia
+ *            cortada ao meio passa a ser compartilhada). O vetor de
+ *            fatias é reaproveitado: em regime não há realocação.
+ * =============================================================== */
+
+typedef struct mem_buf mem_buf_t;
+
+typedef struct mem_slice {
+    mem_buf_t *buf;
+    const unsigned char *data;
+    size_t len;
+} mem_slice_t;
+
+typedef struct mem_chain {
+    mem_slice_t *slices;
+    size_t head;
+    size_t count;
+    size_t cap;
+    size_t bytes;
+} mem_chain_t;
+
+mem_buf_t *mem_buf_new(size_t cap);
+mem_buf_t *mem_buf_wrap(void *data, size_t cap, void (*release)(void *data, void *ctx), void *ctx);
+mem_buf_t *mem_buf_ref(mem_buf_t *buf);
+void mem_buf_unref(mem_buf_t *buf);
+void *mem_buf_data(const mem_buf_t *buf);
+size_t mem_buf_cap(const mem_buf_t *buf);
+
+void mem_chain_init(mem_chain_t *chain);
+void mem_chain_free(mem_chain_t *chain);
+bool mem_chain_append(mem_chain_t *chain, mem_buf_t *buf, size_t offset, size_t len);
+bool mem_chain_append_static(mem_chain_t *chain, const void *data, size_t len);
+bool mem_chain_splice(mem_chain_t *dst, mem_chain_t *src, size_t len);
+void mem_chain_consume(mem_chain_t *chain, size_t len);
+size_t mem_chain_copy(const mem_chain_t *chain, size_t offset, void *dst, size_t len);
+
+/* ===============================================================
+ * ANEL ESPELHADO (memfd + mmap duplo)
+ * ===============================================================
+ * O mesmo arquivo em memória é mapeado duas vezes em sequência, então
+ * base[i] e base[i + size] são o mesmo byte: a região legível e a
+ * gravável são sempre contíguas, mesmo quando dão a volta no fim.
+ * Um frame que cruza o fim do anel é lido (e parseado no lugar) com
+ * um único ponteiro, e um recv preenche todo o espaço livre de uma
+ * vez. size é arredondado para múltiplo da página.
+ *
+ * Produtor: escreve até writable bytes em write_ptr e chama produce.
+ * Consumidor: lê até readable bytes em read_ptr e chama consume.
+ * Sem sincronização: uma thread por anel.
+ * =============================================================== */
+
+typedef struct mem_ring {
+    unsigned char *base;
+    size_t size;
+    size_t head;
+    size_t used;
+} mem_ring_t;
+
+bool mem_ring_init(mem_ring_t *ring, size_t size);
+void mem_ring_free(mem_ring_t *ring);
+
+static inline size_t mem_ring_readable(const mem_ring_t *ring) {
+    return ring->used;
+}
+
+static inline size_t mem_ring_writable(const mem_ring_t *ring) {
+    return ring->size - ring->used;
+}
+
+static inline unsigned char *mem_ring_read_ptr(const mem_ring_t *ring) {
+    return ring->base + ring->head;
+}
+
+/* head + used < 2 * size: cai no espelho quando dá a volta. */
+static inline unsigned char *mem_ring_write_ptr(const mem_ring_t *ring) {
+    return ring->base + ring->head + ring->used;
+}
+
+static inline void mem_ring_produce(mem_ring_t *ring, size_t len) {
+    ring->used += len;
+}
+
+static inline void mem_ring_consume(mem_ring_t *ring, size_t len) {
+    ring->head += len;
+    if (ring->head >= ring->size)
+        ring->head -= ring->size;
+    ring->used -= len;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
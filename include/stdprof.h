@@ -0,0 +1,244 @@
+#ifndef STDPROF_H
+#define STDPROF_H
+
+#include <stdfrigo_defs.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#if defined(__GNUC__) || defined(__clang__)
+#include <x86intrin.h>
+#else
+#include <intrin.h>
+#endif
+#elif !defined(__aarch64__)
+#include <time.h>
+#endif
+
+#ifdef __cplusplus
+#define _STDPROF_TLS_ thread_local
+extern "C" {
+#else
+#define _STDPROF_TLS_ _Thread_local
+#endif
+
+/* ===============================================================
+ * RELÓGIO DE CICLOS
+ * ===============================================================
+ * prof_ticks: rdtsc no x86 (sem serialização: custa poucas dezenas
+ *             de ciclos, mas instruções vizinhas podem cruzar a
+ *             leitura), cntvct_el0 no ARM64 e CLOCK_MONOTONIC em ns
+ *             nos demais. Exige TSC invariante (constant_tsc) para
+ *             comparar leituras de núcleos diferentes.
+ * prof_ticks_per_ns: Calibrado uma vez contra CLOCK_MONOTONIC
+ *             (~20 ms na primeira chamada; prof_calibrate força).
+ * =============================================================== */
+
+static inline uint64_t prof_ticks(void) {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+    return (uint64_t)__rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+double prof_calibrate(void);
+double prof_ticks_per_ns(void);
+double prof_ticks_to_ns(uint64_t ticks);
+
+/* ===============================================================
+ * SONDAS (PROF_BEGIN / PROF_END)
+ * ===============================================================
+ * Cada PROF_END tem um prof_site_t estático (nome, arquivo, linha)
+ * que recebe um id na primeira passagem. Cada thread acumula em seu
+ * próprio vetor de PROF_MAX_SITES contadores (calls, ticks, min,
+ * max), sem atômico nem lock: o caminho quente é duas leituras do
+ * relógio, um acesso TLS e quatro operações na linha de cache do
+ * site. Threads que terminam devolvem o vetor (com os totais) para
+ * reuso, então a memória é limitada pelo pico de threads vivas.
+ * O id 0 marca site ainda não registrado; sites além do limite
+ * dividem o último slot, exibido como "(overflow)".
+ *
+ * PROF_BEGIN(name); ...; PROF_END(name);   mesmo escopo, name é um
+ *                                          identificador.
+ * Com STDPROF_DISABLE definido, as macros não geram código.
+ *
+ * prof_collect: Soma as threads por site (ordem de registro).
+ * prof_dump:    CSV (uma linha por site, com ns) ou binário compacto
+ *               (formato em docs/STDPROF.md). Os contadores de
+ *               threads em atividade são lidos sem sincronização:
+ *               o resultado é aproximado até elas pararem.
+ * prof_reset:   Zera os contadores de todas as threads.
+ * prof_overhead: Ticks que um par BEGIN/END vazio acrescenta a um
+ *               intervalo (mediana), para descontar de sites curtos.
+ * =============================================================== */
+
+#define PROF_MAX_SITES 256u
+
+#define PROF_FORMAT_CSV 0u
+#define PROF_FORMAT_BINARY 1u
+
+typedef struct prof_site {
+    const char *name;
+    const char *file;
+    uint32_t line;
+    uint32_t id;
+} prof_site_t;
+
+typedef struct prof_slot {
+    uint64_t calls;
+    uint64_t ticks;
+    uint64_t min;
+    uint64_t max;
+} prof_slot_t;
+
+typedef struct prof_thread {
+    prof_slot_t slots[PROF_MAX_SITES];
+    struct prof_thread *next;
+    bool alive;
+} prof_thread_t;
+
+typedef struct prof_stat {
+    const char *name;
+    const char *file;
+    uint32_t line;
+    uint64_t calls;
+    uint64_t ticks;
+    uint64_t min;
+    uint64_t max;
+} prof_stat_t;
+
+extern _STDPROF_TLS_ prof_thread_t *_stdprof_self_;
+
+void prof_record_slow(prof_site_t *site, uint64_t ticks);
+
+static inline void prof_slot_add(prof_slot_t *slot, uint64_t ticks) {
+    slot->calls++;
+    slot->ticks += ticks;
+    if (ticks < slot->min)
+        slot->min = ticks;
+    if (ticks > slot->max)
+        slot->max = ticks;
+}
+
+static inline void prof_record(prof_site_t *site, uint64_t ticks) {
+    prof_thread_t *self = _stdprof_self_;
+    uint32_t id = __atomic_load_n(&site->id, __ATOMIC_ACQUIRE);
+    if (!self || !id) {
+        prof_record_slow(site, ticks);
+        return;
+    }
+    prof_slot_add(&self->slots[id], ticks);
+}
+
+size_t prof_collect(prof_stat_t *out, size_t max);
+bool prof_dump(const char *path, unsigned format);
+bool prof_dump_file(FILE *file, unsigned format);
+void prof_reset(void);
+uint64_t prof_overhead(void);
+
+/* ===============================================================
+ * HISTOGRAMA LOG-LINEAR (HDR)
+ * ===============================================================
+ * Mesmo layout do HdrHistogram (unit magnitude 0): 2^sub_bits
+ * sub-buckets lineares por potência de 2, com sub_bits escolhido
+ * para manter `digits` dígitos significativos (erro relativo
+ * < 10^-digits). O índice sai de um clz, um shift e uma soma;
+ * registrar é O(1) e não aloca.
+ *
+ * prof_hist_t tem um único escritor e não usa atômicos. Para
+ * várias threads, prof_hist_set_t entrega a cada uma o seu shard
+ * (prof_hist_local, guarde o ponteiro no laço) e soma todos em
+ * prof_hist_set_merge; shards de threads encerradas mantêm as
+ * contagens e são herdados por threads novas.
+ *
+ * Valores acima de `highest` saturam no último bucket (max guarda
+ * o valor real). Leituras concorrentes com a gravação, como em
+ * prof_collect, são aproximadas.
+ *
+ * prof_hist_encode: Serialização compacta (varints, sequências de
+ *                   zeros colapsadas). Devolve o tamanho necessário
+ *                   e só grava se couber em cap.
+ * prof_hist_decode: Inicializa hist a partir do buffer.
+ * =============================================================== */
+
+typedef struct prof_hist {
+    uint64_t *counts;
+    size_t len;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    uint64_t highest;
+    uint32_t sub_bits;
+    uint32_t digits;
+} prof_hist_t;
+
+typedef struct prof_hist_set prof_hist_set_t;
+
+bool prof_hist_init(prof_hist_t *hist, uint64_t highest, unsigned digits);
+void prof_hist_free(prof_hist_t *hist);
+void prof_hist_reset(prof_hist_t *hist);
+
+static inline size_t prof_hist_index(const prof_hist_t *hist, uint64_t value) {
+    if (value > hist->highest)
+        value = hist->highest;
+    const uint64_t half = (uint64_t)1 << (hist->sub_bits - 1u);
+    const unsigned bucket =
+        64u - (unsigned)__builtin_clzll(value | (((uint64_t)1 << hist->sub_bits) - 1u)) - hist->sub_bits;
+    return (size_t)(((uint64_t)(bucket + 1u) << (hist->sub_bits - 1u)) + (value >> bucket) - half);
+}
+
+static inline void prof_hist_record_n(prof_hist_t *hist, uint64_t value, uint64_t count) {
+    hist->counts[prof_hist_index(hist, value)] += count;
+    hist->total += count;
+    if (value < hist->min)
+        hist->min = value;
+    if (value > hist->max)
+        hist->max = value;
+}
+
+static inline void prof_hist_record(prof_hist_t *hist, uint64_t value) {
+    prof_hist_record_n(hist, value, 1);
+}
+
+uint64_t prof_hist_lowest_at(const prof_hist_t *hist, size_t index);
+uint64_t prof_hist_highest_at(const prof_hist_t *hist, size_t index);
+uint64_t prof_hist_percentile(const prof_hist_t *hist, double percentile);
+double prof_hist_mean(const prof_hist_t *hist);
+bool prof_hist_merge(prof_hist_t *dst, const prof_hist_t *src);
+
+size_t prof_hist_encode(const prof_hist_t *hist, uint8_t *buf, size_t cap);
+bool prof_hist_decode(prof_hist_t *hist, const uint8_t *buf, size_t len);
+
+prof_hist_set_t *prof_hist_set_init(uint64_t highest, unsigned digits);
+void prof_hist_set_free(prof_hist_set_t *set);
+prof_hist_t *prof_hist_local(prof_hist_set_t *set);
+bool prof_hist_set_merge(prof_hist_set_t *set, prof_hist_t *out);
+void prof_hist_set_reset(prof_hist_set_t *set);
+
+#if defined(STDPROF_DISABLE)
+#define PROF_BEGIN(name) ((void)0)
+#define PROF_END(name) ((void)0)
+#else
+#define PROF_BEGIN(name) const uint64_t _prof_t0_##name = prof_ticks()
+#define PROF_END(name)                                                         \
+    do {                                                                       \
+        static prof_site_t _prof_site_##name = {#name, __FILE__, __LINE__, 0}; \
+        prof_record(&_prof_site_##name, prof_ticks() - _prof_t0_##name);      \
+    } while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -7,6 +7,11 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#pragma intrinsic(_umul128)
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -31,15 +36,19 @@ typedef struct rand_double {
     uint64_t s[2];
 } rand_double_t;
 
+typedef struct rand_wy {
+    uint64_t s;
+} rand_wy_t;
+
 /* ===============================================================
  * PROTÓTIPOS DE INICIALIZAÇÃO E GERAÇÃO
  * =============================================================== */
 
 rand32_t rand32_init(uint64_t seed);
-uint32_t rand32_next(rand32_t *rng);
+STDFRIGO_INLINE_API uint32_t rand32_next(rand32_t *rng);
 
 rand64_t rand64_init(uint64_t seed);
-uint64_t rand64_next(rand64_t *rng);
+STDFRIGO_INLINE_API uint64_t rand64_next(rand64_t *rng);
 
 rand_float_t rand_float_init(uint64_t seed);
 float rand_float_next(rand_float_t *rng);
@@ -61,8 +70,8 @@ void rand64_jump(rand64_t *rng);
 void rand_float_jump(rand_float_t *rng);
 void rand_double_jump(rand_double_t *rng);
 
-uint32_t rand32_bound(rand32_t *rng, uint32_t limit);
-uint64_t rand64_bound(rand64_t *rng, uint64_t limit);
+STDFRIGO_INLINE_API uint32_t rand32_bound(rand32_t *rng, uint32_t limit);
+STDFRIGO_INLINE_API uint64_t rand64_bound(rand64_t *rng, uint64_t limit);
 float rand_float_bound(rand_float_t *rng, float limit);
 double rand_double_bound(rand_double_t *rng, double limit);
 
@@ -71,6 +80,316 @@ uint64_t rand64_range(rand64_t *rng, uint64_t min, uint64_t max);
 float rand_float_range(rand_float_t *rng, float min, float max);
 double rand_double_range(rand_double_t *rng, double min, double max);
 
+/* ===============================================================
+ * RAND WY (Algoritmo: wyrand) - HEADER INLINE
+ * ===============================================================
+ * Estado: 64 bits (contador de Weyl + mistura 64x64=128 bits)
+ * Periodo: 2^64
+ * Uso: Laços quentes que precisam de ~1 número por operação e não
+ * podem pagar 256 bits de estado por objeto nem uma chamada fora
+ * de linha. Todas as funções são static inline.
+ * =============================================================== */
+
+#define _STDRAND_WY_P0_ 0xa0761d6478bd642fULL
+#define _STDRAND_WY_P1_ 0xe7037ed1a0b428dbULL
+
+static inline uint64_t _stdrand_mul128_(uint64_t x, uint64_t y, uint64_t *high) {
+#if defined(__GNUC__) || defined(__clang__)
+    __extension__ unsigned __int128 r = (unsigned __int128)x * (unsigned __int128)y;
+    *high = (uint64_t)(r >> 64);
+    return (uint64_t)r;
+#else
+    return (uint64_t)_umul128(x, y, high);
+#endif
+}
+
+static inline uint64_t _stdrand_wy_mix_(uint64_t x, uint64_t y) {
+    uint64_t high;
+    const uint64_t low = _stdrand_mul128_(x, y, &high);
+    return low ^ high;
+}
+
+static inline rand_wy_t rand_wy_init(uint64_t seed) {
+    rand_wy_t rng;
+    rng.s = _stdrand_wy_mix_(seed ^ _STDRAND_WY_P0_, _STDRAND_WY_P1_);
+    return rng;
+}
+
+static inline uint64_t rand_wy_next(rand_wy_t *rng) {
+    rng->s += _STDRAND_WY_P0_;
+    return _stdrand_wy_mix_(rng->s, rng->s ^ _STDRAND_WY_P1_);
+}
+
+static inline void rand_wy_seed(rand_wy_t *rng, uint64_t seed) {
+    *rng = rand_wy_init(seed);
+}
+
+static inline void rand_wy_jump(rand_wy_t *rng) {
+    rng->s += _STDRAND_WY_P0_ << 32;
+}
+
+static inline uint64_t rand_wy_bound(rand_wy_t *rng, uint64_t limit) {
+    uint64_t h;
+    uint64_t l = _stdrand_mul128_(rand_wy_next(rng), limit, &h);
+    if (l < limit) {
+        const uint64_t t = (0 - limit) % limit;
+        while (l < t) {
+            l = _stdrand_mul128_(rand_wy_next(rng), limit, &h);
+        }
+    }
+    return h;
+}
+
+static inline uint64_t rand_wy_range(rand_wy_t *rng, uint64_t min, uint64_t max) {
+    return min + rand_wy_bound(rng, max - min);
+}
+
+/* ===============================================================
+ * IMPLEMENTAÇÃO (STDFRIGO_INLINE / stdrand.c)
+ * ===============================================================
+ * rand32/64_next (xoshiro128** / xoshiro256**) e rand32/64_bound
+ * (Lemire). Com STDFRIGO_INLINE viram static inline aqui; sem ele,
+ * só stdrand.c (_STDRAND_IMPL_) compila este bloco, gerando os
+ * símbolos da biblioteca. As rotações são usadas pelos dois lados.
+ * =============================================================== */
+
+static inline uint32_t _stdrand_rotl32_(const uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+static inline uint64_t _stdrand_rotl64_(const uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+#if defined(STDFRIGO_INLINE) || defined(_STDRAND_IMPL_)
+
+STDFRIGO_INLINE_API uint32_t rand32_next(rand32_t *rng) {
+    const uint32_t result = _stdrand_rotl32_(rng->s[1] * 5, 7) * 9;
+    const uint32_t t = rng->s[1] << 9;
+    rng->s[2] ^= rng->s[0];
+    rng->s[3] ^= rng->s[1];
+    rng->s[1] ^= rng->s[2];
+    rng->s[0] ^= rng->s[3];
+    rng->s[2] ^= t;
+    rng->s[3] = _stdrand_rotl32_(rng->s[3], 11);
+    return result;
+}
+
+STDFRIGO_INLINE_API uint64_t rand64_next(rand64_t *rng) {
+    const uint64_t result = _stdrand_rotl64_(rng->s[1] * 5, 7) * 9;
+    const uint64_t t = rng->s[1] << 17;
+    rng->s[2] ^= rng->s[0];
+    rng->s[3] ^= rng->s[1];
+    rng->s[1] ^= rng->s[2];
+    rng->s[0] ^= rng->s[3];
+    rng->s[2] ^= t;
+    rng->s[3] = _stdrand_rotl64_(rng->s[3], 45);
+    return result;
+}
+
+STDFRIGO_INLINE_API uint32_t rand32_bound(rand32_t *rng, uint32_t limit) {
+    uint32_t x = rand32_next(rng);
+    uint64_t m = (uint64_t)x * (uint64_t)limit;
+    uint32_t l = (uint32_t)m;
+    if (l < limit) {
+        uint32_t t = -limit % limit;
+        while (l < t) {
+            x = rand32_next(rng);
+            m = (uint64_t)x * (uint64_t)limit;
+            l = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+STDFRIGO_INLINE_API uint64_t rand64_bound(rand64_t *rng, uint64_t limit) {
+    uint64_t x = rand64_next(rng);
+    uint64_t h;
+    uint64_t l = _stdrand_mul128_(x, limit, &h);
+    if (l < limit) {
+        uint64_t t = -limit % limit;
+        while (l < t) {
+            x = rand64_next(rng);
+            l = _stdrand_mul128_(x, limit, &h);
+        }
+    }
+    return h;
+}
+
+#endif
+
+/* ===============================================================
+ * AMOSTRAGEM DISCRETA PONDERADA (Alias de Vose)
+ * ===============================================================
+ * Construção O(n), amostragem O(1) com um único rand64_next.
+ * Pesos podem ser alterados com rand_alias_update (O(1), só
+ * registra) e aplicados em lote com rand_alias_rebuild. O rebuild
+ * não é incremental: refaz a tabela inteira em O(n), mesmo que um
+ * único peso tenha mudado; só evita realocar memória. Acumule as
+ * mudanças e reconstrua uma vez por lote.
+ * =============================================================== */
+
+typedef struct rand_alias_slot {
+    uint64_t prob;
+    uint32_t alias;
+} rand_alias_slot_t;
+
+typedef struct rand_alias {
+    rand_alias_slot_t *slot;
+    double *weight;
+    double *scaled;
+    uint32_t *work;
+    size_t size;
+    bool dirty;
+} rand_alias_t;
+
+bool rand_alias_init(rand_alias_t *table, const double *weights, size_t size);
+void rand_alias_free(rand_alias_t *table);
+bool rand_alias_update(rand_alias_t *table, size_t index, double weight);
+bool rand_alias_rebuild(rand_alias_t *table);
+size_t rand_alias_next(const rand_alias_t *table, rand64_t *rng);
+void rand_alias_fill(const rand_alias_t *table, rand64_t *rng, size_t *out, size_t count);
+
+/* ===============================================================
+ * AMOSTRAGEM EM FLUXO (Reservoir Sampling)
+ * ===============================================================
+ * rand_reservoir_t:  Uniforme (Algoritmo L, saltos geométricos).
+ * rand_wreservoir_t: Ponderada (A-ExpJ, saltos exponenciais).
+ * Itens são copiados (elem_size bytes) para o reservatório; o
+ * resultado fica em items[0..count). Reservatórios por thread
+ * podem ser combinados com *_merge e continuar recebendo itens.
+ * =============================================================== */
+
+typedef struct rand_reservoir {
+    void *items;
+    size_t elem_size;
+    size_t capacity;
+    size_t count;
+    uint64_t seen;
+    uint64_t next;
+    double w;
+    rand_double_t rng;
+} rand_reservoir_t;
+
+typedef struct rand_wreservoir_key {
+    double key;
+    size_t slot;
+} rand_wreservoir_key_t;
+
+typedef struct rand_wreservoir {
+    void *items;
+    rand_wreservoir_key_t *heap;
+    size_t elem_size;
+    size_t capacity;
+    size_t count;
+    double skip;
+    rand_double_t rng;
+} rand_wreservoir_t;
+
+bool rand_reservoir_init(rand_reservoir_t *res, size_t capacity, size_t elem_size, uint64_t seed);
+void rand_reservoir_free(rand_reservoir_t *res);
+void rand_reservoir_offer(rand_reservoir_t *res, const void *items, size_t count);
+bool rand_reservoir_merge(rand_reservoir_t *dst, const rand_reservoir_t *src);
+
+bool rand_wreservoir_init(rand_wreservoir_t *res, size_t capacity, size_t elem_size, uint64_t seed);
+void rand_wreservoir_free(rand_wreservoir_t *res);
+void rand_wreservoir_offer(
+    rand_wreservoir_t *res, const void *items, const double *weights, size_t count
+);
+bool rand_wreservoir_merge(rand_wreservoir_t *dst, const rand_wreservoir_t *src);
+
+/* ===============================================================
+ * AMOSTRAGEM SEM REPOSIÇÃO E PERMUTAÇÕES (Espaços Enormes)
+ * ===============================================================
+ * rand_sample_floyd: k índices distintos de [0, n) em O(k) memória,
+ *                    devolvidos em ordem crescente.
+ * rand_sample_t:     Algoritmo D de Vitter, fluxo crescente de k
+ *                    índices com O(1) memória e O(k) sorteios.
+ * rand_perm_t:       Bijeção pseudoaleatória sobre [0, n) (Feistel
+ *                    com cycle-walking); percorre [0, n) em ordem
+ *                    aleatória com O(1) memória e tem inversa.
+ *                    map/unmap exigem argumento < n; fora disso
+ *                    devolvem o próprio argumento (>= n) sem
+ *                    permutar.
+ * =============================================================== */
+
+typedef struct rand_sample {
+    uint64_t remaining;
+    uint64_t wanted;
+    uint64_t pos;
+    double vprime;
+    bool method_d;
+    rand64_t rng;
+} rand_sample_t;
+
+#define RAND_PERM_ROUNDS 4
+
+typedef struct rand_perm {
+    uint64_t size;
+    uint64_t mask;
+    unsigned half;
+    uint64_t key[RAND_PERM_ROUNDS];
+} rand_perm_t;
+
+bool rand_sample_floyd(rand64_t *rng, uint64_t n, uint64_t k, uint64_t *out);
+
+bool rand_sample_init(rand_sample_t *sample, uint64_t n, uint64_t k, uint64_t seed);
+bool rand_sample_next(rand_sample_t *sample, uint64_t *out);
+
+bool rand_perm_init(rand_perm_t *perm, uint64_t n, uint64_t seed);
+uint64_t rand_perm_map(const rand_perm_t *perm, uint64_t index);
+uint64_t rand_perm_unmap(const rand_perm_t *perm, uint64_t value);
+
+/* ===============================================================
+ * MONTE CARLO PARALELO DETERMINÍSTICO
+ * ===============================================================
+ * rand_parallel_for: fn(task, rng, ctx) para cada task em
+ *                    [0, n_tasks), em todos os núcleos com
+ *                    work-stealing. rng é um fluxo próprio da
+ *                    tarefa, derivado só de (seed, task).
+ * rand_parallel_sum/kahan/hist: reduções do valor devolvido por
+ *                    cada tarefa, combinadas em ordem fixa.
+ * rand_parallel_threads: Troca o pool usado pelas chamadas seguintes
+ *                    por um próprio com `threads` threads (0 volta
+ *                    ao tpool_default). Pode ser chamada de qualquer
+ *                    thread, inclusive durante execuções: as que já
+ *                    começaram terminam no pool antigo, liberado
+ *                    quando a última delas retorna.
+ * As funções rand_parallel_* podem ser chamadas de várias threads
+ * ao mesmo tempo; ctx deve ser somente leitura ou escrito em
+ * posições exclusivas da tarefa.
+ * O resultado é bit a bit idêntico para qualquer número de
+ * threads e em qualquer máquina (IEEE 754, sem -ffast-math).
+ * =============================================================== */
+
+typedef void (*rand_task_fn)(uint64_t task, rand64_t *rng, void *ctx);
+typedef double (*rand_value_fn)(uint64_t task, rand64_t *rng, void *ctx);
+
+typedef struct rand_hist {
+    uint64_t *counts;
+    size_t bins;
+    double min;
+    double max;
+    uint64_t underflow;
+    uint64_t overflow;
+    uint64_t nan;
+} rand_hist_t;
+
+rand64_t rand_parallel_stream(uint64_t seed, uint64_t task);
+void rand_parallel_threads(unsigned threads);
+
+bool rand_parallel_for(uint64_t n_tasks, uint64_t seed, rand_task_fn fn, void *ctx);
+bool rand_parallel_sum(uint64_t n_tasks, uint64_t seed, rand_value_fn fn, void *ctx, double *sum);
+bool rand_parallel_kahan(uint64_t n_tasks, uint64_t seed, rand_value_fn fn, void *ctx, double *sum);
+bool rand_parallel_hist(
+    uint64_t n_tasks, uint64_t seed, rand_value_fn fn, void *ctx, rand_hist_t *hist
+);
+
+bool rand_hist_init(rand_hist_t *hist, size_t bins, double min, double max);
+void rand_hist_free(rand_hist_t *hist);
+void rand_hist_add(rand_hist_t *hist, double value);
+bool rand_hist_merge(rand_hist_t *dst, const rand_hist_t *src);
+
 /* ===============================================================
  * HARDWARE RANDOM (x86-64 ONLY)
  * =============================================================== */
@@ -84,6 +403,59 @@ uint32_t rand32_hw_seed(void);
 uint64_t rand64_hw_seed(void);
 #endif
 
+/* ===============================================================
+ * ENTROPIA EM MASSA (Hardware + Fallback do SO)
+ * =============================================================== */
+
+bool rand_hw_fill(void *buf, size_t size);
+
+/* ===============================================================
+ * RAND SECURE (ChaCha20 CSPRNG)
+ * ===============================================================
+ * Gerador criptograficamente seguro com buffer interno, kernels
+ * SIMD, reseed periódico e proteção contra fork. A seed vem sempre
+ * do sistema/hardware (rand_secure_init retorna false se nenhuma
+ * fonte de entropia estiver disponível).
+ * =============================================================== */
+
+#define RAND_SECURE_BUFFER 1024
+
+typedef struct rand_secure {
+    uint32_t key[8];
+    uint8_t buf[RAND_SECURE_BUFFER];
+    size_t pos;
+    uint64_t reseed_left;
+    unsigned fork_gen;
+} rand_secure_t;
+
+bool rand_secure_init(rand_secure_t *rng);
+bool rand_secure_reseed(rand_secure_t *rng);
+void rand_secure_wipe(rand_secure_t *rng);
+uint64_t rand_secure_next(rand_secure_t *rng);
+uint64_t rand_secure_bound(rand_secure_t *rng, uint64_t limit);
+uint64_t rand_secure_range(rand_secure_t *rng, uint64_t min, uint64_t max);
+void rand_secure_fill(rand_secure_t *rng, void *buf, size_t size);
+
+/* ===============================================================
+ * BLOCOS CHACHA20 (Kernel Explícito)
+ * ===============================================================
+ * rand_chacha_blocks: Grava `blocks` blocos de 64 bytes do estado
+ *                     `in` (constantes, chave, contador em in[12],
+ *                     nonce em in[13..15], como na RFC 8439). O
+ *                     contador é de 32 bits e dá a volta. Retorna
+ *                     false se o kernel não existe neste build ou
+ *                     nesta CPU. RAND_CHACHA_AUTO é o kernel usado
+ *                     por rand_secure_t; o escalar é a referência.
+ * =============================================================== */
+
+#define RAND_CHACHA_SCALAR 0u
+#define RAND_CHACHA_SSE2 1u
+#define RAND_CHACHA_AVX2 2u
+#define RAND_CHACHA_AVX512 3u
+#define RAND_CHACHA_AUTO UINT32_MAX
+
+bool rand_chacha_blocks(const uint32_t in[16], void *out, size_t blocks, unsigned kernel);
+
 #ifdef __cplusplus
 }
 #endif
@@ -103,12 +475,18 @@ static inline uint32_t rand_next(rand32_t *rng) {
 static inline uint64_t rand_next(rand64_t *rng) {
     return rand64_next(rng);
 }
-static inline uint32_t rand_next(rand_float_t *rng) {
+static inline float rand_next(rand_float_t *rng) {
     return rand_float_next(rng);
 }
-static inline uint64_t rand_next(rand_double_t *rng) {
+static inline double rand_next(rand_double_t *rng) {
     return rand_double_next(rng);
 }
+static inline uint64_t rand_next(rand_wy_t *rng) {
+    return rand_wy_next(rng);
+}
+static inline uint64_t rand_next(rand_secure_t *rng) {
+    return rand_secure_next(rng);
+}
 
 static inline void rand_init(uint64_t seed, rand32_t *out) {
     *out = rand32_init(seed);
@@ -122,6 +500,9 @@ static inline void rand_init(uint64_t seed, rand_float_t *out) {
 static inline void rand_init(uint64_t seed, rand_double_t *out) {
     *out = rand_double_init(seed);
 }
+static inline void rand_init(uint64_t seed, rand_wy_t *out) {
+    *out = rand_wy_init(seed);
+}
 
 static inline void rand_seed(rand32_t *rng, uint64_t seed) {
     rand32_seed(rng, seed);
@@ -135,6 +516,9 @@ static inline void rand_seed(rand_float_t *rng, uint64_t seed) {
 static inline void rand_seed(rand_double_t *rng, uint64_t seed) {
     rand_double_seed(rng, seed);
 }
+static inline void rand_seed(rand_wy_t *rng, uint64_t seed) {
+    rand_wy_seed(rng, seed);
+}
 
 static inline void rand_jump(rand32_t *rng) {
     rand32_jump(rng);
@@ -148,6 +532,9 @@ static inline void rand_jump(rand_float_t *rng) {
 static inline void rand_jump(rand_double_t *rng) {
     rand_double_jump(rng);
 }
+static inline void rand_jump(rand_wy_t *rng) {
+    rand_wy_jump(rng);
+}
 
 static inline uint32_t rand_bound(rand32_t *rng, uint32_t limit) {
     return rand32_bound(rng, limit);
@@ -161,6 +548,12 @@ static inline float rand_bound(rand_float_t *rng, float limit) {
 static inline double rand_bound(rand_double_t *rng, double limit) {
     return rand_double_bound(rng, limit);
 }
+static inline uint64_t rand_bound(rand_wy_t *rng, uint64_t limit) {
+    return rand_wy_bound(rng, limit);
+}
+static inline uint64_t rand_bound(rand_secure_t *rng, uint64_t limit) {
+    return rand_secure_bound(rng, limit);
+}
 
 static inline uint32_t rand_range(rand32_t *rng, uint32_t min, uint32_t max) {
     return rand32_range(rng, min, max);
@@ -174,18 +567,24 @@ static inline float rand_range(rand_float_t *rng, float min, float max) {
 static inline double rand_range(rand_double_t *rng, double min, double max) {
     return rand_double_range(rng, min, max);
 }
+static inline uint64_t rand_range(rand_wy_t *rng, uint64_t min, uint64_t max) {
+    return rand_wy_range(rng, min, max);
+}
+static inline uint64_t rand_range(rand_secure_t *rng, uint64_t min, uint64_t max) {
+    return rand_secure_range(rng, min, max);
+}
 
 #if defined(__x86_64__) || defined(_M_X64)
-static inline uint32_t rand_hw_fast(uint32_t *out) {
+static inline bool rand_hw_fast(uint32_t *out) {
     return rand32_hw_fast(out);
 }
-static inline uint64_t rand_hw_fast(uint64_t *out) {
+static inline bool rand_hw_fast(uint64_t *out) {
     return rand64_hw_fast(out);
 }
-static inline uint32_t rand_hw_entropy(uint32_t *out) {
+static inline bool rand_hw_entropy(uint32_t *out) {
     return rand32_hw_entropy(out);
 }
-static inline uint64_t rand_hw_entropy(uint64_t *out) {
+static inline bool rand_hw_entropy(uint64_t *out) {
     return rand64_hw_entropy(out);
 }
 static inline void rand_hw_seed(uint32_t *out) {
@@ -207,42 +606,51 @@ static inline void rand_hw_seed(uint64_t *out) {
     rand32_t *:      rand32_next,      \
     rand64_t *:      rand64_next,      \
     rand_float_t *:  rand_float_next,  \
-    rand_double_t *: rand_double_next  \
+    rand_double_t *: rand_double_next, \
+    rand_wy_t *:     rand_wy_next,     \
+    rand_secure_t *: rand_secure_next  \
 )(rng)
 
-#define rand_init(seed, out) _Generic((out), \
-    rand32_t *:      (void)(*out = rand32_init(seed)),      \
-    rand64_t *:      (void)(*out = rand64_init(seed)),      \
-    rand_float_t *:  (void)(*out = rand_float_init(seed)),  \
-    rand_double_t *: (void)(*out = rand_double_init(seed))  \
-)
+#define rand_init(seed, out) (void)(*(out) = _Generic((out), \
+    rand32_t *:      rand32_init,                                \
+    rand64_t *:      rand64_init,                                \
+    rand_float_t *:  rand_float_init,                            \
+    rand_double_t *: rand_double_init,                           \
+    rand_wy_t *:     rand_wy_init                                \
+)(seed))
 
 #define rand_seed(rng, seed) _Generic((rng), \
     rand32_t *:      rand32_seed,            \
     rand64_t *:      rand64_seed,            \
     rand_float_t *:  rand_float_seed,        \
-    rand_double_t *: rand_double_seed        \
+    rand_double_t *: rand_double_seed,       \
+    rand_wy_t *:     rand_wy_seed            \
 )(rng, seed)
 
 #define rand_jump(rng) _Generic((rng), \
     rand32_t *:      rand32_jump,      \
     rand64_t *:      rand64_jump,      \
     rand_float_t *:  rand_float_jump,  \
-    rand_double_t *: rand_double_jump  \
+    rand_double_t *: rand_double_jump, \
+    rand_wy_t *:     rand_wy_jump      \
 )(rng)
 
 #define rand_bound(rng, limit) _Generic((rng), \
     rand32_t *:      rand32_bound,             \
     rand64_t *:      rand64_bound,             \
     rand_float_t *:  rand_float_bound,         \
-    rand_double_t *: rand_double_bound         \
+    rand_double_t *: rand_double_bound,        \
+    rand_wy_t *:     rand_wy_bound,            \
+    rand_secure_t *: rand_secure_bound         \
 )(rng, limit)
 
 #define rand_range(rng, min, max) _Generic((rng), \
     rand32_t *:      rand32_range,                \
     rand64_t *:      rand64_range,                \
     rand_float_t *:  rand_float_range,            \
-    rand_double_t *: rand_double_range            \
+    rand_double_t *: rand_double_range,           \
+    rand_wy_t *:     rand_wy_range,               \
+    rand_secure_t *: rand_secure_range            \
 )(rng, min, max)
 
 #if defined(__x86_64__) || defined(_M_X64)
@@ -1,6 +1,13 @@
 #ifndef NET_COMPAT_H
 #define NET_COMPAT_H
 
+#include <stdfrigo_defs.h>
+#include <stdmem.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
 #ifdef _WIN32
 #include <winsock2.h>
 #include <ws2tcpip.h>
@@ -19,6 +26,7 @@ typedef SOCKET socket_t;
 #include <netdb.h>
 #include <unistd.h>
 #include <errno.h>
+#include <sys/uio.h>
 
 typedef int socket_t;
 #define ISVALIDSOCKET(s) ((s) >= 0)
@@ -27,8 +35,6 @@ typedef int socket_t;
 #define GETSOCKETERRNO() (errno)
 #endif
 
-#endif
-
 static inline int net_init(void) {
     #ifdef _WIN32
     WSADATA wsa_data;
@@ -43,3 +49,444 @@ static inline void net_quit(void) {
     WSACleanup();
     #endif
 }
+
+#ifndef _WIN32
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ===============================================================
+ * CONFIGURAÇÃO DE SOCKETS
+ * ===============================================================
+ * Todos os sockets criados aqui são não bloqueantes e CLOEXEC.
+ * net_recv/net_send repetem EINTR e traduzem EAGAIN para NET_AGAIN,
+ * então o tratamento de "esgotou" é o mesmo em todo serviço:
+ *   > 0        bytes transferidos
+ *   0          (só net_recv) o par fechou a conexão
+ *   NET_AGAIN  o kernel não tem mais dados/espaço; espere o evento
+ *   NET_ERROR  erro fatal (errno preservado)
+ * =============================================================== */
+
+#define NET_AGAIN (-1)
+#define NET_ERROR (-2)
+
+#define NET_LISTEN_REUSEPORT 0x1u
+#define NET_LISTEN_IPV6 0x2u
+
+bool net_set_nonblocking(socket_t sock);
+bool net_set_nodelay(socket_t sock, bool on);
+bool net_set_reuseport(socket_t sock, bool on);
+
+socket_t net_listen_tcp(const char *host, uint16_t port, int backlog, unsigned flags);
+socket_t net_connect_tcp(const char *host, uint16_t port);
+socket_t net_accept(socket_t listener);
+uint16_t net_local_port(socket_t sock);
+
+ptrdiff_t net_recv(socket_t sock, void *buf, size_t size);
+ptrdiff_t net_send(socket_t sock, const void *buf, size_t size);
+
+/* ===============================================================
+ * ENVIO SEM CÓPIA (sendfile, splice/tee, MSG_ZEROCOPY)
+ * ===============================================================
+ * Mesmo contrato de net_send (> 0, NET_AGAIN, NET_ERROR). Onde o
+ * caminho sem cópia não existe (outro SO, fd sem suporte a splice
+ * ou sendfile, socket sem SO_ZEROCOPY), cada função cai sozinha
+ * para read/recv + send com um buffer em espaço de usuário.
+ *
+ * net_sendfile: Arquivo -> socket a partir de *offset (avançado
+ *               pelo que foi enviado). 0 indica fim do arquivo.
+ * net_pipe_t:   Pipe do kernel entre dois sockets. fill move do
+ *               socket para o pipe, drain do pipe para o socket e
+ *               tee duplica o início de um pipe em outro sem
+ *               consumi-lo (como tee(2): faça logo após o fill e
+ *               antes do drain). net_splice = drain + fill + drain;
+ *               0 é EOF na origem com o pipe vazio, e NET_AGAIN com
+ *               net_pipe_pending > 0 significa esperar escrita no
+ *               destino (senão, leitura na origem). count > 0.
+ * net_zc_t:     send com MSG_ZEROCOPY: as páginas do buffer vão
+ *               direto para a placa, então o buffer só pode ser
+ *               reusado quando net_zc_done(zc, id) for verdadeiro.
+ *               As notificações chegam pela fila de erros do socket
+ *               (EPOLLERR, NET_EVENT_ERROR no event loop): chame
+ *               net_zc_reap. Envios pequenos, sem suporte, com a
+ *               janela de 64 envios cheia ou que o kernel acaba
+ *               copiando (loopback) viram send comum com id 0.
+ *
+ * splice e sendfile para um socket fechado geram SIGPIPE (não há
+ * MSG_NOSIGNAL): servidores que os usam devem ignorar o sinal.
+ * =============================================================== */
+
+typedef struct net_pipe {
+    int fds[2];
+    size_t pending;
+    unsigned char *buf;
+    size_t head;
+    size_t cap;
+} net_pipe_t;
+
+typedef struct net_zc {
+    socket_t sock;
+    bool enabled;
+    uint32_t next;
+    uint32_t completed;
+    uint64_t window;
+    unsigned copied;
+} net_zc_t;
+
+ptrdiff_t net_sendfile(socket_t sock, int fd, uint64_t *offset, size_t count);
+
+bool net_pipe_init(net_pipe_t *np, size_t capacity);
+void net_pipe_free(net_pipe_t *np);
+size_t net_pipe_pending(const net_pipe_t *np);
+ptrdiff_t net_pipe_fill(net_pipe_t *np, socket_t from, size_t count);
+ptrdiff_t net_pipe_drain(net_pipe_t *np, socket_t to, size_t count);
+ptrdiff_t net_pipe_tee(const net_pipe_t *src, net_pipe_t *dst, size_t count);
+ptrdiff_t net_splice(socket_t from, socket_t to, net_pipe_t *np, size_t count);
+
+bool net_zc_init(net_zc_t *zc, socket_t sock);
+ptrdiff_t net_zc_send(net_zc_t *zc, const void *buf, size_t len, uint32_t *id);
+int net_zc_reap(net_zc_t *zc);
+bool net_zc_done(const net_zc_t *zc, uint32_t id);
+
+/* ===============================================================
+ * DATAGRAMAS EM LOTE (recvmmsg/sendmmsg, GSO/GRO)
+ * ===============================================================
+ * net_dgram_batch_t pré-aloca, para count mensagens, os buffers de
+ * size bytes, os iovecs, os cabeçalhos e o espaço de controle: um
+ * net_dgram_recv/net_dgram_send move o lote inteiro numa syscall
+ * sem alocar.
+ *
+ * recv: Preenche msgs[0..n) e devolve n (ou NET_AGAIN/NET_ERROR).
+ *       data aponta para o buffer da mensagem, válido até o próximo
+ *       recv. Com GRO ligado, uma mensagem pode trazer vários
+ *       datagramas do mesmo remetente coalescidos: segment > 0 é o
+ *       tamanho de cada um (o último pode ser menor); use size de
+ *       64 KiB. NET_DGRAM_TRUNC: o datagrama não coube no buffer.
+ * send: Envia msgs[0..count) (data/len/addr preenchidos pelo
+ *       chamador; addr_len 0 em socket conectado) e devolve quantas
+ *       mensagens saíram. segment > 0 pede GSO (UDP_SEGMENT): len
+ *       bytes viram datagramas de segment bytes, cortados pelo
+ *       kernel (ou pela placa). Sem suporte a GSO, a mensagem é
+ *       cortada aqui e enviada datagrama a datagrama.
+ *
+ * Metadados por pacote (ligados por socket): net_set_timestamps
+ * (timestamp_ns do kernel na chegada, CLOCK_REALTIME) e
+ * net_set_drop_counter (drops = datagramas descartados pelo socket
+ * até então, por buffer de recepção cheio).
+ * =============================================================== */
+
+#define NET_DGRAM_TRUNC 0x1u
+
+typedef struct net_dgram {
+    void *data;
+    size_t len;
+    uint16_t segment;
+    unsigned flags;
+    uint64_t timestamp_ns;
+    uint32_t drops;
+    socklen_t addr_len;
+    struct sockaddr_storage addr;
+} net_dgram_t;
+
+typedef struct net_dgram_batch {
+    net_dgram_t *msgs;
+    unsigned count;
+    size_t size;
+    unsigned char *buffers;
+    void *hdrs;
+    struct iovec *iov;
+    unsigned char *control;
+} net_dgram_batch_t;
+
+socket_t net_udp_bind(const char *host, uint16_t port, unsigned flags);
+socket_t net_udp_connect(const char *host, uint16_t port);
+
+int net_set_rcvbuf(socket_t sock, int bytes);
+int net_set_sndbuf(socket_t sock, int bytes);
+bool net_set_timestamps(socket_t sock, bool on);
+bool net_set_drop_counter(socket_t sock, bool on);
+bool net_udp_set_gro(socket_t sock, bool on);
+
+net_dgram_batch_t *net_dgram_batch_init(unsigned count, size_t size);
+void net_dgram_batch_free(net_dgram_batch_t *batch);
+int net_dgram_recv(socket_t sock, net_dgram_batch_t *batch);
+int net_dgram_send(socket_t sock, net_dgram_batch_t *batch, unsigned count);
+
+/* ===============================================================
+ * I/O VETORIAL (readv/writev, cadeias e anel espelhado)
+ * ===============================================================
+ * Mesmo contrato de net_recv/net_send.
+ *
+ * net_sendv/net_recvv: Um sendmsg/readv sobre count iovecs; o envio
+ *                      não gera SIGPIPE.
+ * net_send_chain:      writev das fatias da cadeia (até 64 por
+ *                      chamada) e mem_chain_consume do que saiu:
+ *                      cabeçalho e corpo em buffers separados vão
+ *                      juntos sem concatenar. Cadeia vazia devolve 0.
+ * net_recv_ring:       recv direto no espaço livre do anel (contíguo
+ *                      pelo espelhamento) e mem_ring_produce. Anel
+ *                      cheio devolve NET_AGAIN com errno ENOBUFS:
+ *                      consuma antes de esperar novo evento.
+ * net_send_ring:       send do que há para ler no anel e
+ *                      mem_ring_consume. Anel vazio devolve 0.
+ * =============================================================== */
+
+ptrdiff_t net_sendv(socket_t sock, const struct iovec *iov, int count);
+ptrdiff_t net_recvv(socket_t sock, const struct iovec *iov, int count);
+ptrdiff_t net_send_chain(socket_t sock, mem_chain_t *chain);
+ptrdiff_t net_recv_ring(socket_t sock, mem_ring_t *ring);
+ptrdiff_t net_send_ring(socket_t sock, mem_ring_t *ring);
+
+#if defined(__linux__)
+
+/* ===============================================================
+ * EVENT LOOP (Reactor epoll Edge-Triggered)
+ * ===============================================================
+ * net_handle_t e net_timer_t pertencem ao chamador (embutidos na
+ * struct da conexão), então registrar não aloca. Os eventos são
+ * edge-triggered: o callback deve ler/escrever até NET_AGAIN, senão
+ * não haverá nova notificação. epoll_wait busca até max_events de
+ * uma vez.
+ *
+ * on_read:  Dados, EOF ou erro (NET_EVENT_READ, NET_EVENT_CLOSE,
+ *           NET_EVENT_ERROR). Se for NULL, esses eventos vão para
+ *           on_write.
+ * on_write: Espaço no buffer de envio (NET_EVENT_WRITE).
+ * Um handle removido com net_loop_del (ou liberado após o del)
+ * dentro de um callback não recebe mais eventos do lote atual.
+ *
+ * Timers: one-shot em milissegundos sobre o relógio monotônico
+ * cacheado a cada iteração (net_loop_now), numa roda hierárquica:
+ * armar, cancelar e rearmar são O(1) com qualquer número de timers
+ * ativos, e os que vencem no mesmo tick disparam em lote.
+ * Reiniciar um timer ativo o rearma. net_loop_set_tick troca a
+ * resolução (padrão 1 ms; só com nenhum timer ativo): um tick
+ * maior agrupa mais vencimentos e acorda o loop menos vezes, e um
+ * timer dispara até um tick depois do prazo, nunca antes.
+ *
+ * net_loop_wakeup e net_loop_stop podem ser chamados de qualquer
+ * thread (eventfd).
+ * =============================================================== */
+
+#define NET_EVENT_READ 0x1u
+#define NET_EVENT_WRITE 0x4u
+#define NET_EVENT_ERROR 0x8u
+#define NET_EVENT_CLOSE 0x10u
+
+typedef struct net_loop net_loop_t;
+typedef struct net_handle net_handle_t;
+typedef struct net_timer net_timer_t;
+
+typedef void (*net_io_fn)(net_loop_t *loop, net_handle_t *handle, uint32_t events);
+typedef void (*net_timer_fn)(net_loop_t *loop, net_timer_t *timer);
+
+struct net_handle {
+    socket_t fd;
+    net_io_fn on_read;
+    net_io_fn on_write;
+    void *ctx;
+};
+
+struct net_timer {
+    uint64_t deadline;
+    net_timer_fn fn;
+    void *ctx;
+    net_timer_t *next;
+    net_timer_t **pprev;
+};
+
+net_loop_t *net_loop_init(unsigned max_events);
+void net_loop_free(net_loop_t *loop);
+
+bool net_loop_add(net_loop_t *loop, net_handle_t *handle, uint32_t events);
+bool net_loop_mod(net_loop_t *loop, net_handle_t *handle, uint32_t events);
+void net_loop_del(net_loop_t *loop, net_handle_t *handle);
+
+int net_loop_run_once(net_loop_t *loop, int timeout_ms);
+void net_loop_run(net_loop_t *loop);
+void net_loop_stop(net_loop_t *loop);
+void net_loop_wakeup(net_loop_t *loop);
+uint64_t net_loop_now(const net_loop_t *loop);
+bool net_loop_set_tick(net_loop_t *loop, unsigned tick_ms);
+
+void net_timer_init(net_timer_t *timer, net_timer_fn fn, void *ctx);
+bool net_timer_start(net_loop_t *loop, net_timer_t *timer, uint64_t timeout_ms);
+void net_timer_stop(net_loop_t *loop, net_timer_t *timer);
+bool net_timer_active(const net_timer_t *timer);
+
+/* ===============================================================
+ * I/O ASSÍNCRONO POR CONCLUSÃO (io_uring, Fallback epoll)
+ * ===============================================================
+ * Em vez de avisar que o socket está pronto, net_aio_t executa a
+ * operação e entrega o resultado no callback do net_aio_req_t
+ * (struct do chamador, viva até a conclusão final).
+ *
+ * io_uring:  Submissões acumulam no SQ e vão ao kernel num único
+ *            io_uring_enter por iteração (ou nenhum, com SQPOLL).
+ *            accept e recv são multishot: um pedido gera uma
+ *            conclusão por conexão/pacote (NET_AIO_MORE indica que
+ *            continua armado). recv escolhe o buffer de um anel de
+ *            buffers providos, então não há buffer preso por conexão
+ *            ociosa. read/write em regiões de net_aio_register_buffers
+ *            usam as variantes FIXED (sem mapear páginas por chamada).
+ * epoll:     Mesma semântica emulada com epoll edge-triggered e
+ *            syscalls não bloqueantes; usado quando io_uring não
+ *            existe, está desabilitado ou NET_AIO_EPOLL é pedido.
+ *
+ * ev->res: bytes, fd aceito ou -errno. ev->buf: buffer provido do
+ * recv, devolvido com net_aio_buffer_release. NET_AIO_LINK encadeia
+ * o próximo pedido: ele só começa se este concluir por completo,
+ * senão termina com -ECANCELED. Feche um fd só depois de cancelar
+ * (ou ver terminar) seus accept/recv multishot.
+ * =============================================================== */
+
+#define NET_AIO_MORE 0x1u
+#define NET_AIO_LINK 0x1u
+
+typedef enum net_aio_backend {
+    NET_AIO_AUTO = 0,
+    NET_AIO_URING,
+    NET_AIO_EPOLL,
+} net_aio_backend_t;
+
+typedef struct net_aio_config {
+    unsigned entries;
+    unsigned buffers;
+    unsigned buffer_size;
+    bool sqpoll;
+    net_aio_backend_t backend;
+} net_aio_config_t;
+
+typedef struct net_aio net_aio_t;
+typedef struct net_aio_req net_aio_req_t;
+
+typedef struct net_aio_event {
+    int64_t res;
+    void *buf;
+    unsigned flags;
+} net_aio_event_t;
+
+typedef void (*net_aio_fn)(net_aio_t *aio, net_aio_req_t *req, const net_aio_event_t *ev);
+
+struct net_aio_req {
+    net_aio_fn fn;
+    void *ctx;
+    socket_t fd;
+    unsigned flags;
+    void *buf;
+    size_t len;
+    uint64_t offset;
+    int64_t result;
+    uint32_t op;
+    uint32_t state;
+    net_aio_req_t *next;
+    net_aio_req_t *link;
+};
+
+net_aio_t *net_aio_init(const net_aio_config_t *config);
+void net_aio_free(net_aio_t *aio);
+net_aio_backend_t net_aio_backend(const net_aio_t *aio);
+uint64_t net_aio_syscalls(const net_aio_t *aio);
+
+bool net_aio_register_buffers(net_aio_t *aio, const struct iovec *iov, unsigned count);
+void net_aio_buffer_release(net_aio_t *aio, void *buf);
+
+bool net_aio_accept(net_aio_t *aio, net_aio_req_t *req, socket_t listener, net_aio_fn fn, void *ctx);
+bool net_aio_recv(net_aio_t *aio, net_aio_req_t *req, socket_t sock, net_aio_fn fn, void *ctx);
+bool net_aio_send(
+    net_aio_t *aio, net_aio_req_t *req, socket_t sock, const void *buf, size_t len, unsigned flags,
+    net_aio_fn fn, void *ctx
+);
+bool net_aio_read(
+    net_aio_t *aio, net_aio_req_t *req, int fd, void *buf, size_t len, uint64_t offset,
+    unsigned flags, net_aio_fn fn, void *ctx
+);
+bool net_aio_write(
+    net_aio_t *aio, net_aio_req_t *req, int fd, const void *buf, size_t len, uint64_t offset,
+    unsigned flags, net_aio_fn fn, void *ctx
+);
+bool net_aio_close(net_aio_t *aio, net_aio_req_t *req, int fd, net_aio_fn fn, void *ctx);
+bool net_aio_cancel(net_aio_t *aio, net_aio_req_t *req);
+
+bool net_aio_submit(net_aio_t *aio);
+int net_aio_run_once(net_aio_t *aio, int timeout_ms);
+void net_aio_run(net_aio_t *aio);
+void net_aio_stop(net_aio_t *aio);
+
+/* ===============================================================
+ * SERVIDOR MULTI-ACCEPTOR (SO_REUSEPORT, Um Loop por Núcleo)
+ * ===============================================================
+ * Cada shard tem seu próprio socket de escuta no mesmo endereço
+ * (SO_REUSEPORT), seu net_loop_t e sua thread, opcionalmente fixada
+ * num núcleo. O kernel distribui as conexões entre os listeners, e
+ * on_accept roda na thread do shard que aceitou: o estado da
+ * conexão é criado e usado só ali (shard->loop, shard->ctx), sem
+ * lock nem linha de cache compartilhada entre núcleos.
+ *
+ * NET_SERVER_PIN:   Shard i fixado na i-ésima CPU permitida (módulo
+ *                   o número de CPUs). Loop e estado do shard são
+ *                   alocados já na thread fixada (first touch).
+ * NET_SERVER_STEER: Programa BPF clássico no grupo reuseport que
+ *                   escolhe o shard por hash32_int sobre a 4-tupla,
+ *                   em vez do hash interno do kernel; a mesma conta
+ *                   em espaço de usuário é net_server_steer (para
+ *                   prever o shard de um cliente). Sem suporte, o
+ *                   init falha.
+ *
+ * shards = 0 usa um por CPU permitida. port = 0 escolhe uma porta
+ * livre (net_server_port). on_start/on_stop rodam na thread de cada
+ * shard, antes do primeiro e depois do último evento.
+ * =============================================================== */
+
+#define NET_SERVER_PIN 0x100u
+#define NET_SERVER_STEER 0x200u
+
+typedef struct net_server net_server_t;
+typedef struct net_shard net_shard_t;
+
+typedef void (*net_accept_fn)(net_shard_t *shard, socket_t sock);
+typedef void (*net_shard_fn)(net_shard_t *shard);
+
+struct net_shard {
+    net_server_t *server;
+    unsigned index;
+    int cpu;
+    net_loop_t *loop;
+    net_handle_t listener;
+    uint64_t accepted;
+    void *ctx;
+};
+
+typedef struct net_server_config {
+    const char *host;
+    uint16_t port;
+    unsigned shards;
+    int backlog;
+    unsigned flags;
+    net_accept_fn on_accept;
+    net_shard_fn on_start;
+    net_shard_fn on_stop;
+    void *ctx;
+} net_server_config_t;
+
+net_server_t *net_server_init(const net_server_config_t *config);
+void net_server_free(net_server_t *server);
+bool net_server_start(net_server_t *server);
+void net_server_stop(net_server_t *server);
+
+unsigned net_server_shards(const net_server_t *server);
+net_shard_t *net_server_shard(net_server_t *server, unsigned index);
+uint16_t net_server_port(const net_server_t *server);
+void *net_server_ctx(const net_server_t *server);
+unsigned net_server_steer(const struct sockaddr *client, const struct sockaddr *server, unsigned shards);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif
@@ -0,0 +1,270 @@
+#ifndef STDTHRD_H
+#define STDTHRD_H
+
+#include <stdfrigo_defs.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/* ===============================================================
+ * ATÔMICOS COMPARTILHADOS ENTRE C E C++
+ * ===============================================================
+ * As estruturas públicas embutem atômicos para dispensar alocação
+ * (latch e future vivem na pilha do chamador). Em C++ usa-se
+ * std::atomic<T>, com o mesmo layout de _Atomic(T) no GCC/Clang.
+ * Campos escritos por threads diferentes ficam em linhas de cache
+ * separadas (alignas(64)) para evitar false sharing.
+ * =============================================================== */
+
+#ifdef __cplusplus
+#include <atomic>
+#define _STDTHRD_ATOMIC_(T) std::atomic<T>
+#else
+#include <stdalign.h>
+#include <stdatomic.h>
+#define _STDTHRD_ATOMIC_(T) _Atomic(T)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ===============================================================
+ * LATCH (Contador Regressivo de Uso Único)
+ * ===============================================================
+ * latch_wait bloqueia (futex no Linux) até que count_down leve o
+ * contador a zero. O contador é de 64 bits para acompanhar
+ * iterações de um parallel-for inteiro.
+ * =============================================================== */
+
+typedef struct latch {
+    _STDTHRD_ATOMIC_(int64_t) count;
+    _STDTHRD_ATOMIC_(uint32_t) state;
+} latch_t;
+
+void latch_init(latch_t *latch, int64_t count);
+void latch_count_down(latch_t *latch, int64_t n);
+bool latch_try_wait(latch_t *latch);
+void latch_wait(latch_t *latch);
+
+/* ===============================================================
+ * THREAD POOL COM WORK-STEALING
+ * ===============================================================
+ * Cada worker tem um deque Chase-Lev: empilha e desempilha pelo
+ * fundo (LIFO, cache quente) e os demais roubam pelo topo (FIFO).
+ * Submissões de threads externas entram numa fila de injeção.
+ *
+ * tpool_submit:       Tarefa sem retorno (fire-and-forget).
+ * tpool_async:        Tarefa com retorno num tpool_future_t do
+ *                     chamador; tpool_future_wait devolve o valor.
+ * tpool_parallel_for: fn(begin, end, ctx) sobre [0, n), dividindo
+ *                     a faixa ao meio sob demanda até o grão
+ *                     (grain = 0 escolhe n / (8 * workers)).
+ * Esperas feitas dentro de um worker executam outras tarefas em
+ * vez de bloquear, então paralelismo aninhado não trava o pool.
+ * =============================================================== */
+
+typedef void (*tpool_fn)(void *arg);
+typedef void *(*tpool_value_fn)(void *arg);
+typedef void (*tpool_range_fn)(uint64_t begin, uint64_t end, void *ctx);
+
+typedef enum tpool_affinity {
+    TPOOL_AFFINITY_NONE = 0,
+    TPOOL_AFFINITY_CORE,
+    TPOOL_AFFINITY_NUMA,
+} tpool_affinity_t;
+
+typedef struct tpool_config {
+    unsigned threads;
+    unsigned deque_size;
+    tpool_affinity_t affinity;
+} tpool_config_t;
+
+typedef struct tpool_future {
+    tpool_value_fn fn;
+    void *arg;
+    void *result;
+    latch_t done;
+} tpool_future_t;
+
+typedef struct tpool tpool_t;
+
+tpool_t *tpool_init(const tpool_config_t *config);
+void tpool_free(tpool_t *pool);
+tpool_t *tpool_default(void);
+
+unsigned tpool_size(const tpool_t *pool);
+int tpool_worker_id(const tpool_t *pool);
+
+bool tpool_submit(tpool_t *pool, tpool_fn fn, void *arg);
+bool tpool_async(tpool_t *pool, tpool_future_t *future, tpool_value_fn fn, void *arg);
+void *tpool_future_wait(tpool_t *pool, tpool_future_t *future);
+void tpool_wait(tpool_t *pool, latch_t *latch);
+
+bool tpool_parallel_for(tpool_t *pool, uint64_t n, uint64_t grain, tpool_range_fn fn, void *ctx);
+
+/* ===============================================================
+ * FILAS LOCK-FREE LIMITADAS
+ * ===============================================================
+ * queue_spsc_t:     Um produtor e um consumidor. Cada lado mantém
+ *                   uma cópia local do índice do outro e só relê
+ *                   o atômico quando ela indica fila cheia/vazia.
+ *                   queue_spsc_push_n/pop_n movem lotes com uma
+ *                   única publicação.
+ * queue_mpmc_t:     Vários produtores e consumidores (Vyukov): cada
+ *                   célula tem um número de sequência; um CAS por
+ *                   operação, sem ABA.
+ * queue_blocking_t: Envolve uma das duas; push/pop fazem spin com
+ *                   pause e depois dormem num futex. close acorda
+ *                   todos e faz pop devolver false quando esvazia.
+ * Itens são copiados (elem_size bytes); a capacidade é arredondada
+ * para potência de 2.
+ * =============================================================== */
+
+typedef struct queue_spsc {
+    alignas(64) _STDTHRD_ATOMIC_(size_t) head;
+    size_t tail_cache;
+    alignas(64) _STDTHRD_ATOMIC_(size_t) tail;
+    size_t head_cache;
+    alignas(64) unsigned char *buf;
+    size_t mask;
+    size_t elem_size;
+} queue_spsc_t;
+
+typedef struct queue_mpmc {
+    alignas(64) _STDTHRD_ATOMIC_(size_t) enqueue_pos;
+    alignas(64) _STDTHRD_ATOMIC_(size_t) dequeue_pos;
+    alignas(64) unsigned char *cells;
+    size_t mask;
+    size_t elem_size;
+    size_t stride;
+} queue_mpmc_t;
+
+typedef enum queue_kind {
+    QUEUE_SPSC = 0,
+    QUEUE_MPMC,
+} queue_kind_t;
+
+typedef struct queue_blocking {
+    queue_kind_t kind;
+    queue_spsc_t spsc;
+    queue_mpmc_t mpmc;
+    alignas(64) _STDTHRD_ATOMIC_(uint32_t) not_empty;
+    _STDTHRD_ATOMIC_(uint32_t) not_full;
+    _STDTHRD_ATOMIC_(uint32_t) pop_waiters;
+    _STDTHRD_ATOMIC_(uint32_t) push_waiters;
+    _STDTHRD_ATOMIC_(bool) closed;
+} queue_blocking_t;
+
+bool queue_spsc_init(queue_spsc_t *queue, size_t capacity, size_t elem_size);
+void queue_spsc_free(queue_spsc_t *queue);
+bool queue_spsc_push(queue_spsc_t *queue, const void *item);
+bool queue_spsc_pop(queue_spsc_t *queue, void *item);
+size_t queue_spsc_push_n(queue_spsc_t *queue, const void *items, size_t count);
+size_t queue_spsc_pop_n(queue_spsc_t *queue, void *items, size_t count);
+
+bool queue_mpmc_init(queue_mpmc_t *queue, size_t capacity, size_t elem_size);
+void queue_mpmc_free(queue_mpmc_t *queue);
+bool queue_mpmc_push(queue_mpmc_t *queue, const void *item);
+bool queue_mpmc_pop(queue_mpmc_t *queue, void *item);
+
+bool queue_blocking_init(
+    queue_blocking_t *queue, queue_kind_t kind, size_t capacity, size_t elem_size
+);
+void queue_blocking_free(queue_blocking_t *queue);
+bool queue_blocking_push(queue_blocking_t *queue, const void *item);
+bool queue_blocking_pop(queue_blocking_t *queue, void *item);
+bool queue_blocking_try_push(queue_blocking_t *queue, const void *item);
+bool queue_blocking_try_pop(queue_blocking_t *queue, void *item);
+void queue_blocking_close(queue_blocking_t *queue);
+
+/* ===============================================================
+ * LOCKS (Spin Adaptativo + Futex)
+ * ===============================================================
+ * lock_mutex_t:  Mutex adaptativo de 32 bits. Spin com backoff
+ *                exponencial de pause e, se o dono demorar, futex
+ *                (0 = livre, 1 = ocupado, 2 = com threads dormindo).
+ * lock_ticket_t: FIFO estrito; o backoff é proporcional à distância
+ *                até a vez da thread.
+ * lock_mcs_t:    Fila MCS: cada thread gira sobre o próprio nó (uma
+ *                linha de cache local), sem tráfego entre núcleos.
+ * lock_seq_t:    Seqlock para dados lidos com muita frequência;
+ *                leitores nunca escrevem em memória compartilhada.
+ * lock_rw_t:     Leitores incrementam um contador do próprio núcleo;
+ *                o escritor sinaliza pending e espera os contadores
+ *                zerarem (preferência ao escritor).
+ * =============================================================== */
+
+typedef struct lock_mutex {
+    _STDTHRD_ATOMIC_(uint32_t) state;
+} lock_mutex_t;
+
+typedef struct lock_ticket {
+    _STDTHRD_ATOMIC_(uint32_t) next;
+    _STDTHRD_ATOMIC_(uint32_t) serving;
+} lock_ticket_t;
+
+typedef struct lock_mcs_node {
+    alignas(64) _STDTHRD_ATOMIC_(struct lock_mcs_node *) next;
+    _STDTHRD_ATOMIC_(uint32_t) wait;
+} lock_mcs_node_t;
+
+typedef struct lock_mcs {
+    _STDTHRD_ATOMIC_(lock_mcs_node_t *) tail;
+} lock_mcs_t;
+
+typedef struct lock_seq {
+    _STDTHRD_ATOMIC_(uint32_t) seq;
+    lock_mutex_t writer;
+} lock_seq_t;
+
+typedef struct lock_rw_slot {
+    alignas(64) _STDTHRD_ATOMIC_(uint32_t) readers;
+} lock_rw_slot_t;
+
+typedef struct lock_rw {
+    lock_rw_slot_t *slots;
+    unsigned size;
+    lock_mutex_t writer;
+    alignas(64) _STDTHRD_ATOMIC_(uint32_t) pending;
+} lock_rw_t;
+
+#define LOCK_MUTEX_INIT {0}
+#define LOCK_TICKET_INIT {0, 0}
+#define LOCK_MCS_INIT {NULL}
+#define LOCK_SEQ_INIT {0, LOCK_MUTEX_INIT}
+
+void lock_mutex_init(lock_mutex_t *lock);
+void lock_mutex_lock(lock_mutex_t *lock);
+bool lock_mutex_trylock(lock_mutex_t *lock);
+void lock_mutex_unlock(lock_mutex_t *lock);
+
+void lock_ticket_init(lock_ticket_t *lock);
+void lock_ticket_lock(lock_ticket_t *lock);
+void lock_ticket_unlock(lock_ticket_t *lock);
+
+void lock_mcs_init(lock_mcs_t *lock);
+void lock_mcs_lock(lock_mcs_t *lock, lock_mcs_node_t *node);
+void lock_mcs_unlock(lock_mcs_t *lock, lock_mcs_node_t *node);
+
+void lock_seq_init(lock_seq_t *lock);
+uint32_t lock_seq_read_begin(lock_seq_t *lock);
+bool lock_seq_read_retry(lock_seq_t *lock, uint32_t start);
+void lock_seq_write_begin(lock_seq_t *lock);
+void lock_seq_write_end(lock_seq_t *lock);
+void lock_seq_read(lock_seq_t *lock, void *dst, const void *src, size_t size);
+void lock_seq_write(lock_seq_t *lock, void *dst, const void *src, size_t size);
+
+bool lock_rw_init(lock_rw_t *lock, unsigned slots);
+void lock_rw_free(lock_rw_t *lock);
+void lock_rw_read_lock(lock_rw_t *lock);
+void lock_rw_read_unlock(lock_rw_t *lock);
+void lock_rw_write_lock(lock_rw_t *lock);
+void lock_rw_write_unlock(lock_rw_t *lock);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,3 +1,5 @@
+#undef STDFRIGO_INLINE
+#define _STDHASH_IMPL_
 #include "stdhash.h"
 #include <string.h>
 #include <stdconst.h>
@@ -13,165 +15,6 @@
 #endif
 #endif
 
-/* ===============================================================
- * PRIMITIVAS INTERNAS (HELPERS)
- * ===============================================================
- * 1. Multiplicação portável 64x64=128 bits.
- * Retorna a parte BAIXA e armazena a ALTA.
- *
- * 2. Leituras Seguras (Unaligned).
- * Necessárias para o algoritmo WyHash processar buffers
- * sem violar regras de alinhamento.
- * =============================================================== */
-
-static inline uint64_t _stdhash_mul128_(uint64_t x, uint64_t y, uint64_t *high) {
-#if defined(__GNUC__) || defined(__clang__)
-    unsigned __int128 r = (unsigned __int128)x * (unsigned __int128)y;
-    *high = (uint64_t)(r >> 64);
-    return (uint64_t)r;
-#else
-    return (uint64_t)_umul128(x, y, high);
-#endif
-}
-
-static inline uint64_t _stdhash_read64_(const uint8_t *p) {
-    uint64_t v;
-    memcpy(&v, p, sizeof(uint64_t));
-    return v;
-}
-
-static inline uint64_t _stdhash_read_small_(const uint8_t *p, size_t k) {
-    uint64_t v = 0;
-    if (k >= 4) {
-        memcpy(&v, p, 4);
-        v <<= 32;
-        p += 4;
-        k -= 4;
-    }
-    if (k >= 2) {
-        uint16_t t;
-        memcpy(&t, p, 2);
-        v |= (uint64_t)t << 16;
-        p += 2;
-        k -= 2;
-    }
-    if (k >= 1) {
-        v |= *p;
-    }
-    return v;
-}
-
-/* ===============================================================
- * INTEGER HASH MIXERS
- * ===============================================================
- * Algoritmos de mistura de bits O(1) estatisticamente superiores.
- * 32-bit: "lowbias32" (Chris Wellons).
- * 64-bit: "Stafford Mix 13".
- * =============================================================== */
-
-uint32_t hash32_int(uint32_t num) {
-    const uint32_t c1 = 0x7feb352dU;
-    const uint32_t c2 = 0x846ca68bU;
-
-    num ^= num >> 16;
-    num *= c1;
-    num ^= num >> 15;
-    num *= c2;
-    num ^= num >> 16;
-    return num;
-}
-
-uint64_t hash64_int(uint64_t num) {
-    const uint64_t c1 = 0xbf58476d1ce4e5b9ULL;
-    const uint64_t c2 = 0x94d049bb133111ebULL;
-
-    num ^= num >> 30;
-    num *= c1;
-    num ^= num >> 27;
-    num *= c2;
-    num ^= num >> 31;
-    return num;
-}
-
-/* ===============================================================
- * MEMORY HASH (WyHash Variant)
- * ===============================================================
- * O novo "Padrão Ouro" para hashing de software.
- * Substitui FNV-1a e Jenkins.
- * Vantagem: Usa matemática de 128 bits e leituras de 64 bits.
- * Extremamente rápido e passa no SMHasher.
- * =============================================================== */
-
-uint64_t hash64_mem(const void *mem, size_t size) {
-    const uint8_t *p = (const uint8_t *)mem;
-    uint64_t seed = PHI_INV_HASH_64 ^ size;
-    uint64_t see1 = seed;
-    uint64_t high;
-    uint64_t low;
-
-    const uint64_t _wyp0 = 0xa0761d6478bd642fULL;
-    const uint64_t _wyp1 = 0xe7037ed1a0b428dbULL;
-    const uint64_t _wyp2 = 0x8ebc6af09c88c6e3ULL;
-    const uint64_t _wyp3 = 0x589965cc75374cc3ULL;
-    const uint64_t _wyp4 = 0x1d8e4e27c47d124fULL;
-
-    while (size >= 16) {
-        uint64_t v1 = _stdhash_read64_(p);
-        uint64_t v2 = _stdhash_read64_(p + 8);
-
-        low = _stdhash_mul128_(seed ^ v1 ^ _wyp0, _wyp1, &high);
-        seed = low ^ high;
-
-        low = _stdhash_mul128_(see1 ^ v2 ^ _wyp2, _wyp3, &high);
-        see1 = low ^ high;
-
-        p += 16;
-        size -= 16;
-    }
-
-    if (size >= 8) {
-        uint64_t v1 = _stdhash_read64_(p);
-        uint64_t v2 = _stdhash_read64_(p + size - 8);
-
-        low = _stdhash_mul128_(seed ^ v1 ^ _wyp0, _wyp1, &high);
-        seed = low ^ high;
-
-        low = _stdhash_mul128_(see1 ^ v2 ^ _wyp2, _wyp3, &high);
-        see1 = low ^ high;
-    } else if (size > 0) {
-        uint64_t v1 = _stdhash_read_small_(p, size);
-        low = _stdhash_mul128_(seed ^ v1 ^ _wyp0, _wyp1, &high);
-        seed = low ^ high;
-    }
-
-    low = _stdhash_mul128_(seed, _wyp1, &high);
-    uint64_t a = low ^ high;
-
-    low = _stdhash_mul128_(see1, _wyp1, &high);
-    uint64_t b = low ^ high;
-
-    low = _stdhash_mul128_(a ^ b, _wyp4, &high);
-    return low ^ high;
-}
-
-uint32_t hash32_mem(const void *mem, size_t size) {
-    return (uint32_t)hash64_mem(mem, size);
-}
-
-/* ===============================================================
- * AUXILIAR: COMBINE HASH
- * ===============================================================
- * Combina uma seed existente com um novo valor.
- * =============================================================== */
-
-uint32_t hash32_combine(uint32_t seed, uint32_t next_hash) {
-    return seed ^ (next_hash + PHI_INV_HASH_32 + (seed << 6) + (seed >> 2));
-}
-
-uint64_t hash64_combine(uint64_t seed, uint64_t next_hash) {
-    return seed ^ (next_hash + PHI_INV_HASH_64 + (seed << 6) + (seed >> 2));
-}
-
 /* ===============================================================
  * HARDWARE HASHING (X86-64 ONLY)
  * ===============================================================
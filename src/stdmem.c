@@ -0,0 +1,766 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "stdmem.h"
+#include "stdthrd.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* ===============================================================
+ * CHUNKS (mmap)
+ * ===============================================================
+ * O cabeçalho ocupa a primeira linha de cache do chunk, então os
+ * dados começam alinhados a 64 bytes. Com MEM_ARENA_HUGE_PAGES o
+ * tamanho é múltiplo de 2 MiB: tenta-se MAP_HUGETLB (páginas
+ * reservadas) e, se não houver, mapeia-se com folga para alinhar a
+ * 2 MiB e pede-se Transparent Huge Pages via madvise.
+ * =============================================================== */
+
+#define _STDMEM_HEADER_ 64u
+#define _STDMEM_HUGE_PAGE_ ((size_t)2 << 20)
+#define _STDMEM_DEFAULT_CHUNK_ ((size_t)64 << 10)
+
+struct mem_chunk {
+    mem_chunk_t *next;
+    size_t size;
+};
+
+static inline unsigned char *_stdmem_begin_(mem_chunk_t *chunk) {
+    return (unsigned char *)chunk + _STDMEM_HEADER_;
+}
+
+static inline unsigned char *_stdmem_end_(mem_chunk_t *chunk) {
+    return (unsigned char *)chunk + chunk->size;
+}
+
+static size_t _stdmem_granule_(unsigned flags) {
+    if (flags & MEM_ARENA_HUGE_PAGES)
+        return _STDMEM_HUGE_PAGE_;
+    const long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? (size_t)page : 4096;
+}
+
+static void *_stdmem_map_huge_(size_t size) {
+    void *mem = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+    mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (mem != MAP_FAILED)
+        return mem;
+#endif
+    const size_t padded = size + _STDMEM_HUGE_PAGE_;
+    unsigned char *raw = mmap(NULL, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+        return MAP_FAILED;
+    const uintptr_t base = ((uintptr_t)raw + _STDMEM_HUGE_PAGE_ - 1) & ~(uintptr_t)(_STDMEM_HUGE_PAGE_ - 1);
+    const size_t head = (size_t)(base - (uintptr_t)raw);
+    if (head)
+        munmap(raw, head);
+    if (padded - head > size)
+        munmap((unsigned char *)base + size, padded - head - size);
+#if defined(MADV_HUGEPAGE)
+    madvise((void *)base, size, MADV_HUGEPAGE);
+#endif
+    return (void *)base;
+}
+
+static mem_chunk_t *_stdmem_map_(mem_arena_t *arena, size_t size) {
+    void *mem = (arena->flags & MEM_ARENA_HUGE_PAGES)
+                    ? _stdmem_map_huge_(size)
+                    : mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+        return NULL;
+    mem_chunk_t *chunk = mem;
+    chunk->next = NULL;
+    chunk->size = size;
+    arena->mapped += size;
+    return chunk;
+}
+
+static void _stdmem_unmap_(mem_arena_t *arena, mem_chunk_t *chunk) {
+    while (chunk) {
+        mem_chunk_t *next = chunk->next;
+        arena->mapped -= chunk->size;
+        munmap(chunk, chunk->size);
+        chunk = next;
+    }
+}
+
+static inline void _stdmem_enter_(mem_arena_t *arena, mem_chunk_t *chunk, unsigned char *ptr) {
+    arena->chunk = chunk;
+    arena->ptr = ptr;
+    arena->end = _stdmem_end_(chunk);
+}
+
+/* ===============================================================
+ * ARENA
+ * =============================================================== */
+
+bool mem_arena_init(mem_arena_t *arena, size_t chunk_size, unsigned flags) {
+    if (!arena)
+        return false;
+    memset(arena, 0, sizeof(*arena));
+    arena->flags = flags;
+    const size_t granule = _stdmem_granule_(flags);
+    if (!chunk_size)
+        chunk_size = _STDMEM_DEFAULT_CHUNK_;
+    if (chunk_size > SIZE_MAX - granule)
+        return false;
+    arena->chunk_size = (chunk_size + granule - 1) & ~(granule - 1);
+
+    mem_chunk_t *head = _stdmem_map_(arena, arena->chunk_size);
+    if (!head)
+        return false;
+    arena->head = head;
+    _stdmem_enter_(arena, head, _stdmem_begin_(head));
+    return true;
+}
+
+void mem_arena_free(mem_arena_t *arena) {
+    if (!arena)
+        return;
+    _stdmem_unmap_(arena, arena->head);
+    memset(arena, 0, sizeof(*arena));
+}
+
+void mem_arena_reset(mem_arena_t *arena) {
+    _stdmem_enter_(arena, arena->head, _stdmem_begin_(arena->head));
+}
+
+void mem_arena_restore(mem_arena_t *arena, mem_arena_mark_t mark) {
+    _stdmem_enter_(arena, mark.chunk, mark.ptr);
+}
+
+void mem_arena_trim(mem_arena_t *arena) {
+    _stdmem_unmap_(arena, arena->chunk->next);
+    arena->chunk->next = NULL;
+}
+
+/* Caminho lento: o chunk atual não comporta o pedido. Usa o próximo
+ * chunk já mapeado se couber; senão mapeia um novo (do tamanho
+ * padrão ou maior, para pedidos gigantes) logo após o atual, o que
+ * mantém a lista em ordem para checkpoints e reset. */
+void *mem_arena_grow(mem_arena_t *arena, size_t size, size_t align) {
+    const size_t pad = align > _STDMEM_HEADER_ ? align - _STDMEM_HEADER_ : 0;
+    const size_t granule = _stdmem_granule_(arena->flags);
+    if (size > SIZE_MAX - pad - _STDMEM_HEADER_ - granule)
+        return NULL;
+    const size_t need = size + pad + _STDMEM_HEADER_;
+
+    mem_chunk_t *chunk = arena->chunk->next;
+    if (!chunk || chunk->size < need) {
+        const size_t bytes = need > arena->chunk_size ? (need + granule - 1) & ~(granule - 1)
+                                                      : arena->chunk_size;
+        mem_chunk_t *fresh = _stdmem_map_(arena, bytes);
+        if (!fresh)
+            return NULL;
+        fresh->next = arena->chunk->next;
+        arena->chunk->next = fresh;
+        chunk = fresh;
+    }
+    _stdmem_enter_(arena, chunk, _stdmem_begin_(chunk));
+    return mem_arena_alloc_aligned(arena, size, align);
+}
+
+/* ===============================================================
+ * PILHA LOCK-FREE COM TAG (Depósito)
+ * ===============================================================
+ * Pilha de Treiber num único atômico de 64 bits: ponteiro nos bits
+ * baixos e um contador nos altos, incrementado a cada troca, para
+ * que um pop não confunda um topo reciclado com o antigo (ABA).
+ * Em 64 bits o ponteiro ocupa 48 bits (espaço de usuário do
+ * x86-64/AArch64) e a tag 16; em 32 bits, 32 e 32. Os nós nunca
+ * são devolvidos ao sistema enquanto o pool existe, então ler
+ * node->next de um nó já retirado é seguro (o CAS descarta).
+ * =============================================================== */
+
+#if UINTPTR_MAX > UINT32_MAX
+#define _STDMEM_TAG_SHIFT_ 48
+#else
+#define _STDMEM_TAG_SHIFT_ 32
+#endif
+#define _STDMEM_PTR_MASK_ ((UINT64_C(1) << _STDMEM_TAG_SHIFT_) - 1)
+
+typedef struct _stdmem_node {
+    _Atomic(struct _stdmem_node *) next;
+} _stdmem_node_t;
+
+static inline _stdmem_node_t *_stdmem_unpack_(uint64_t top) {
+    return (_stdmem_node_t *)(uintptr_t)(top & _STDMEM_PTR_MASK_);
+}
+
+static inline uint64_t _stdmem_pack_(const void *node, uint64_t old) {
+    return ((old >> _STDMEM_TAG_SHIFT_) + 1) << _STDMEM_TAG_SHIFT_ | (uint64_t)(uintptr_t)node;
+}
+
+static void _stdmem_stack_push_(_Atomic uint64_t *top, void *ptr) {
+    _stdmem_node_t *node = ptr;
+    uint64_t old = atomic_load_explicit(top, memory_order_relaxed);
+    do {
+        atomic_store_explicit(&node->next, _stdmem_unpack_(old), memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(
+        top, &old, _stdmem_pack_(node, old), memory_order_release, memory_order_relaxed
+    ));
+}
+
+static void *_stdmem_stack_pop_(_Atomic uint64_t *top) {
+    uint64_t old = atomic_load_explicit(top, memory_order_acquire);
+    for (;;) {
+        _stdmem_node_t *node = _stdmem_unpack_(old);
+        if (!node)
+            return NULL;
+        _stdmem_node_t *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+        if (atomic_compare_exchange_weak_explicit(
+                top, &old, _stdmem_pack_(next, old), memory_order_acquire, memory_order_acquire
+            ))
+            return node;
+    }
+}
+
+/* ===============================================================
+ * POOL DE OBJETOS (Bonwick & Adams, "Magazines and Vmem", 2001)
+ * ===============================================================
+ * Cada thread tem um cache com dois magazines (loaded e previous).
+ * alloc tira de loaded; se vazio, troca com previous; se ambos
+ * vazios, troca um magazine vazio por um cheio do depósito. release
+ * é o espelho. Só quando o depósito não tem nada o slab é cortado
+ * (sob lock, uma vez a cada _STDMEM_MAGAZINE_ objetos). Se faltar
+ * memória para um magazine, o objeto vai para a pilha de órfãos
+ * (usando a primeira palavra do slot) em vez de se perder.
+ * =============================================================== */
+
+#define _STDMEM_MAGAZINE_ 64u
+#define _STDMEM_LINE_ 64u
+#define _STDMEM_POISON_FREE_ 0xDD
+#define _STDMEM_POISON_ALLOC_ 0xCD
+
+typedef struct _stdmem_magazine {
+    _stdmem_node_t link;
+    unsigned count;
+    void *items[_STDMEM_MAGAZINE_];
+} _stdmem_magazine_t;
+
+typedef struct _stdmem_cache {
+    _stdmem_magazine_t *loaded;
+    _stdmem_magazine_t *previous;
+    mem_pool_t *pool;
+    struct _stdmem_cache *prev;
+    struct _stdmem_cache *next;
+} _stdmem_cache_t;
+
+struct mem_pool {
+    alignas(64) _Atomic uint64_t full;
+    alignas(64) _Atomic uint64_t empty;
+    alignas(64) _Atomic uint64_t orphans;
+    alignas(64) lock_mutex_t lock;
+    mem_arena_t slabs;
+    _stdmem_cache_t *caches;
+    pthread_key_t key;
+    size_t size;
+    size_t stride;
+    unsigned flags;
+};
+
+/* Verifica o padrão de liberação a partir da segunda palavra (a
+ * primeira pode ter servido de elo na pilha de órfãos). */
+static bool _stdmem_poisoned_(const mem_pool_t *pool, const unsigned char *obj) {
+    for (size_t i = sizeof(void *); i < pool->stride; i++) {
+        if (obj[i] != _STDMEM_POISON_FREE_)
+            return false;
+    }
+    return true;
+}
+
+static void _stdmem_poison_fault_(const mem_pool_t *pool, const void *obj, const char *what) {
+    fprintf(stderr, "stdmem: %s no slot %p (pool %p)\n", what, obj, (const void *)pool);
+    abort();
+}
+
+static _stdmem_magazine_t *_stdmem_magazine_empty_(mem_pool_t *pool) {
+    _stdmem_magazine_t *mag = _stdmem_stack_pop_(&pool->empty);
+    if (!mag) {
+        mag = malloc(sizeof(_stdmem_magazine_t));
+        if (!mag)
+            return NULL;
+    }
+    mag->count = 0;
+    return mag;
+}
+
+static void _stdmem_magazine_put_(mem_pool_t *pool, _stdmem_magazine_t *mag) {
+    _stdmem_stack_push_(mag->count ? &pool->full : &pool->empty, mag);
+}
+
+static void _stdmem_cache_destroy_(void *arg) {
+    _stdmem_cache_t *cache = arg;
+    mem_pool_t *pool = cache->pool;
+    _stdmem_magazine_put_(pool, cache->loaded);
+    _stdmem_magazine_put_(pool, cache->previous);
+
+    lock_mutex_lock(&pool->lock);
+    if (cache->prev)
+        cache->prev->next = cache->next;
+    else
+        pool->caches = cache->next;
+    if (cache->next)
+        cache->next->prev = cache->prev;
+    lock_mutex_unlock(&pool->lock);
+    free(cache);
+}
+
+static _stdmem_cache_t *_stdmem_cache_create_(mem_pool_t *pool) {
+    _stdmem_cache_t *cache = calloc(1, sizeof(_stdmem_cache_t));
+    if (!cache)
+        return NULL;
+    cache->pool = pool;
+    cache->loaded = _stdmem_magazine_empty_(pool);
+    cache->previous = _stdmem_magazine_empty_(pool);
+    if (!cache->loaded || !cache->previous || pthread_setspecific(pool->key, cache) != 0) {
+        /* Podem ter saído do depósito: voltam para ele, nunca free(). */
+        if (cache->loaded)
+            _stdmem_magazine_put_(pool, cache->loaded);
+        if (cache->previous)
+            _stdmem_magazine_put_(pool, cache->previous);
+        free(cache);
+        return NULL;
+    }
+    lock_mutex_lock(&pool->lock);
+    cache->next = pool->caches;
+    if (pool->caches)
+        pool->caches->prev = cache;
+    pool->caches = cache;
+    lock_mutex_unlock(&pool->lock);
+    return cache;
+}
+
+static inline _stdmem_cache_t *_stdmem_cache_(mem_pool_t *pool) {
+    _stdmem_cache_t *cache = pthread_getspecific(pool->key);
+    return cache ? cache : _stdmem_cache_create_(pool);
+}
+
+mem_pool_t *mem_pool_init(size_t size, unsigned flags) {
+    if (!size || size > SIZE_MAX / _STDMEM_MAGAZINE_ - _STDMEM_LINE_)
+        return NULL;
+    mem_pool_t *pool = aligned_alloc(_STDMEM_LINE_, sizeof(mem_pool_t));
+    if (!pool)
+        return NULL;
+    memset(pool, 0, sizeof(*pool));
+    pool->size = size;
+    pool->stride = (size + _STDMEM_LINE_ - 1) & ~(size_t)(_STDMEM_LINE_ - 1);
+    pool->flags = flags;
+    atomic_init(&pool->full, 0);
+    atomic_init(&pool->empty, 0);
+    atomic_init(&pool->orphans, 0);
+    lock_mutex_init(&pool->lock);
+    if (!mem_arena_init(&pool->slabs, pool->stride * _STDMEM_MAGAZINE_ * 8, 0)) {
+        free(pool);
+        return NULL;
+    }
+    if (pthread_key_create(&pool->key, _stdmem_cache_destroy_) != 0) {
+        mem_arena_free(&pool->slabs);
+        free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void mem_pool_free(mem_pool_t *pool) {
+    if (!pool)
+        return;
+    pthread_key_delete(pool->key);
+    _stdmem_magazine_t *mag;
+    while ((mag = _stdmem_stack_pop_(&pool->full)))
+        free(mag);
+    while ((mag = _stdmem_stack_pop_(&pool->empty)))
+        free(mag);
+    for (_stdmem_cache_t *cache = pool->caches, *next; cache; cache = next) {
+        next = cache->next;
+        free(cache->loaded);
+        free(cache->previous);
+        free(cache);
+    }
+    mem_arena_free(&pool->slabs);
+    free(pool);
+}
+
+size_t mem_pool_slot_size(const mem_pool_t *pool) {
+    return pool->stride;
+}
+
+/* loaded está vazio: previous, depósito, órfãos e por fim o slab. */
+static _stdmem_magazine_t *_stdmem_reload_(mem_pool_t *pool, _stdmem_cache_t *cache) {
+    _stdmem_magazine_t *mag = cache->previous;
+    if (mag->count) {
+        cache->previous = cache->loaded;
+        cache->loaded = mag;
+        return mag;
+    }
+    mag = _stdmem_stack_pop_(&pool->full);
+    if (mag) {
+        _stdmem_stack_push_(&pool->empty, cache->previous);
+        cache->previous = cache->loaded;
+        cache->loaded = mag;
+        return mag;
+    }
+
+    mag = cache->loaded;
+    void *obj;
+    while (mag->count < _STDMEM_MAGAZINE_ && (obj = _stdmem_stack_pop_(&pool->orphans))) {
+        mag->items[mag->count++] = obj;
+    }
+    if (mag->count)
+        return mag;
+
+    lock_mutex_lock(&pool->lock);
+    unsigned char *slab =
+        mem_arena_alloc_aligned(&pool->slabs, pool->stride * _STDMEM_MAGAZINE_, _STDMEM_LINE_);
+    lock_mutex_unlock(&pool->lock);
+    if (!slab)
+        return NULL;
+    if (pool->flags & MEM_POOL_POISON)
+        memset(slab, _STDMEM_POISON_FREE_, pool->stride * _STDMEM_MAGAZINE_);
+    /* Ordem reversa: os pops seguintes devolvem endereços crescentes. */
+    for (unsigned i = 0; i < _STDMEM_MAGAZINE_; i++) {
+        mag->items[i] = slab + (size_t)(_STDMEM_MAGAZINE_ - 1 - i) * pool->stride;
+    }
+    mag->count = _STDMEM_MAGAZINE_;
+    return mag;
+}
+
+/* loaded está cheio: previous vazio ou troca de um cheio no depósito. */
+static _stdmem_magazine_t *_stdmem_unload_(mem_pool_t *pool, _stdmem_cache_t *cache) {
+    _stdmem_magazine_t *mag = cache->previous;
+    if (!mag->count) {
+        cache->previous = cache->loaded;
+        cache->loaded = mag;
+        return mag;
+    }
+    mag = _stdmem_magazine_empty_(pool);
+    if (!mag)
+        return NULL;
+    _stdmem_stack_push_(&pool->full, cache->previous);
+    cache->previous = cache->loaded;
+    cache->loaded = mag;
+    return mag;
+}
+
+void *mem_pool_alloc(mem_pool_t *pool) {
+    _stdmem_cache_t *cache = _stdmem_cache_(pool);
+    if (!cache)
+        return NULL;
+    _stdmem_magazine_t *mag = cache->loaded;
+    if (!mag->count && !(mag = _stdmem_reload_(pool, cache)))
+        return NULL;
+    void *obj = mag->items[--mag->count];
+    if (pool->flags & MEM_POOL_POISON) {
+        if (!_stdmem_poisoned_(pool, obj))
+            _stdmem_poison_fault_(pool, obj, "escrita após mem_pool_release");
+        memset(obj, _STDMEM_POISON_ALLOC_, pool->stride);
+    }
+    return obj;
+}
+
+void mem_pool_release(mem_pool_t *pool, void *obj) {
+    if (!obj)
+        return;
+    if (pool->flags & MEM_POOL_POISON) {
+        if (_stdmem_poisoned_(pool, obj))
+            _stdmem_poison_fault_(pool, obj, "mem_pool_release duplicado");
+        memset(obj, _STDMEM_POISON_FREE_, pool->stride);
+    }
+    _stdmem_cache_t *cache = _stdmem_cache_(pool);
+    _stdmem_magazine_t *mag = cache ? cache->loaded : NULL;
+    if (mag && mag->count == _STDMEM_MAGAZINE_)
+        mag = _stdmem_unload_(pool, cache);
+    if (!mag) {
+        _stdmem_stack_push_(&pool->orphans, obj);
+        return;
+    }
+    mag->items[mag->count++] = obj;
+}
+
+void mem_pool_flush(mem_pool_t *pool) {
+    _stdmem_cache_t *cache = pthread_getspecific(pool->key);
+    if (!cache)
+        return;
+    pthread_setspecific(pool->key, NULL);
+    _stdmem_cache_destroy_(cache);
+}
+
+/* ===============================================================
+ * BUFFERS COM CONTAGEM DE REFERÊNCIAS
+ * ===============================================================
+ * Em mem_buf_new os dados vêm logo depois do cabeçalho, no mesmo
+ * malloc. O incremento é relaxed (quem incrementa já tem uma
+ * referência); o decremento é acq_rel para que as escritas de todas
+ * as threads sejam vistas por quem libera.
+ * =============================================================== */
+
+struct mem_buf {
+    _Atomic size_t refs;
+    size_t cap;
+    unsigned char *data;
+    void (*release)(void *data, void *ctx);
+    void *ctx;
+    alignas(max_align_t) unsigned char bytes[];
+};
+
+mem_buf_t *mem_buf_new(size_t cap) {
+    if (cap > SIZE_MAX - sizeof(mem_buf_t))
+        return NULL;
+    mem_buf_t *buf = malloc(sizeof(mem_buf_t) + cap);
+    if (!buf)
+        return NULL;
+    atomic_init(&buf->refs, 1);
+    buf->cap = cap;
+    buf->data = buf->bytes;
+    buf->release = NULL;
+    buf->ctx = NULL;
+    return buf;
+}
+
+mem_buf_t *mem_buf_wrap(void *data, size_t cap, void (*release)(void *data, void *ctx), void *ctx) {
+    mem_buf_t *buf = malloc(sizeof(mem_buf_t));
+    if (!buf)
+        return NULL;
+    atomic_init(&buf->refs, 1);
+    buf->cap = cap;
+    buf->data = data;
+    buf->release = release;
+    buf->ctx = ctx;
+    return buf;
+}
+
+mem_buf_t *mem_buf_ref(mem_buf_t *buf) {
+    atomic_fetch_add_explicit(&buf->refs, 1, memory_order_relaxed);
+    return buf;
+}
+
+void mem_buf_unref(mem_buf_t *buf) {
+    if (!buf || atomic_fetch_sub_explicit(&buf->refs, 1, memory_order_acq_rel) != 1)
+        return;
+    if (buf->release)
+        buf->release(buf->data, buf->ctx);
+    free(buf);
+}
+
+void *mem_buf_data(const mem_buf_t *buf) {
+    return buf->data;
+}
+
+size_t mem_buf_cap(const mem_buf_t *buf) {
+    return buf->cap;
+}
+
+/* ===============================================================
+ * CADEIAS DE FATIAS
+ * ===============================================================
+ * slices[head, head + count) é a fila. Quando o fim do vetor é
+ * alcançado, as fatias vivas voltam para o início (memmove) antes de
+ * se pensar em crescer; a cadeia vazia volta a head = 0. Uma fatia
+ * anexada logo depois da última, no mesmo buffer, só a estende.
+ * =============================================================== */
+
+#define _STDMEM_CHAIN_MIN_ 16u
+
+static mem_slice_t *_stdmem_chain_tail_(mem_chain_t *chain) {
+    return chain->count ? &chain->slices[chain->head + chain->count - 1] : NULL;
+}
+
+/* Não mexe em referências: o chamador já cuidou delas. Devolve
+ * false se não coube; true com *merged quando estendeu a última. */
+static bool _stdmem_chain_push_(mem_chain_t *chain, mem_buf_t *buf, const unsigned char *data, size_t len,
+                                bool *merged) {
+    mem_slice_t *tail = _stdmem_chain_tail_(chain);
+    *merged = tail && tail->buf == buf && tail->data + tail->len == data;
+    if (*merged) {
+        tail->len += len;
+        chain->bytes += len;
+        return true;
+    }
+    if (chain->head + chain->count == chain->cap) {
+        if (chain->head) {
+            memmove(chain->slices, chain->slices + chain->head, chain->count * sizeof(mem_slice_t));
+            chain->head = 0;
+        } else {
+            const size_t cap = chain->cap ? chain->cap * 2 : _STDMEM_CHAIN_MIN_;
+            mem_slice_t *slices = realloc(chain->slices, cap * sizeof(mem_slice_t));
+            if (!slices)
+                return false;
+            chain->slices = slices;
+            chain->cap = cap;
+        }
+    }
+    mem_slice_t *slice = &chain->slices[chain->head + chain->count++];
+    slice->buf = buf;
+    slice->data = data;
+    slice->len = len;
+    chain->bytes += len;
+    return true;
+}
+
+void mem_chain_init(mem_chain_t *chain) {
+    memset(chain, 0, sizeof(mem_chain_t));
+}
+
+void mem_chain_free(mem_chain_t *chain) {
+    mem_chain_consume(chain, chain->bytes);
+    free(chain->slices);
+    mem_chain_init(chain);
+}
+
+bool mem_chain_append(mem_chain_t *chain, mem_buf_t *buf, size_t offset, size_t len) {
+    if (offset > buf->cap || len > buf->cap - offset)
+        return false;
+    if (!len)
+        return true;
+    bool merged;
+    if (!_stdmem_chain_push_(chain, buf, buf->data + offset, len, &merged))
+        return false;
+    if (!merged)
+        mem_buf_ref(buf);
+    return true;
+}
+
+bool mem_chain_append_static(mem_chain_t *chain, const void *data, size_t len) {
+    bool merged;
+    return !len || _stdmem_chain_push_(chain, NULL, data, len, &merged);
+}
+
+bool mem_chain_splice(mem_chain_t *dst, mem_chain_t *src, size_t len) {
+    if (len > src->bytes)
+        return false;
+    while (len) {
+        mem_slice_t *front = &src->slices[src->head];
+        const size_t take = front->len < len ? front->len : len;
+        bool merged;
+        if (!_stdmem_chain_push_(dst, front->buf, front->data, take, &merged))
+            return false;
+        if (take < front->len) {
+            /* Fatia cortada: as duas metades seguram o buffer. */
+            if (front->buf && !merged)
+                mem_buf_ref(front->buf);
+            front->data += take;
+            front->len -= take;
+            src->bytes -= take;
+        } else {
+            /* Fatia inteira: a referência muda de cadeia. */
+            if (front->buf && merged)
+                mem_buf_unref(front->buf);
+            src->head++;
+            src->count--;
+            src->bytes -= take;
+        }
+        len -= take;
+    }
+    if (!src->count)
+        src->head = 0;
+    return true;
+}
+
+void mem_chain_consume(mem_chain_t *chain, size_t len) {
+    while (len && chain->count) {
+        mem_slice_t *front = &chain->slices[chain->head];
+        if (len < front->len) {
+            front->data += len;
+            front->len -= len;
+            chain->bytes -= len;
+            return;
+        }
+        len -= front->len;
+        chain->bytes -= front->len;
+        mem_buf_unref(front->buf);
+        chain->head++;
+        chain->count--;
+    }
+    if (!chain->count)
+        chain->head = 0;
+}
+
+size_t mem_chain_copy(const mem_chain_t *chain, size_t offset, void *dst, size_t len) {
+    unsigned char *out = dst;
+    size_t copied = 0;
+    for (size_t i = chain->head; i < chain->head + chain->count && copied < len; i++) {
+        const mem_slice_t *slice = &chain->slices[i];
+        if (offset >= slice->len) {
+            offset -= slice->len;
+            continue;
+        }
+        size_t n = slice->len - offset;
+        if (n > len - copied)
+            n = len - copied;
+        memcpy(out + copied, slice->data + offset, n);
+        copied += n;
+        offset = 0;
+    }
+    return copied;
+}
+
+/* ===============================================================
+ * ANEL ESPELHADO
+ * ===============================================================
+ * Reserva 2 * size sem acesso e mapeia o mesmo arquivo por cima das
+ * duas metades com MAP_FIXED. O arquivo é anônimo: memfd no Linux,
+ * shm_open + shm_unlink imediato nos outros POSIX.
+ * =============================================================== */
+
+static int _stdmem_ring_fd_(size_t size) {
+    int fd;
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+    fd = memfd_create("stdfrigo_ring", MFD_CLOEXEC);
+#else
+    static _Atomic unsigned seq;
+    char name[64];
+    snprintf(name, sizeof(name), "/stdfrigo_ring.%ld.%u", (long)getpid(),
+             atomic_fetch_add_explicit(&seq, 1, memory_order_relaxed));
+    fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0)
+        shm_unlink(name);
+#endif
+    if (fd >= 0 && ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+bool mem_ring_init(mem_ring_t *ring, size_t size) {
+    memset(ring, 0, sizeof(mem_ring_t));
+    const size_t page = _stdmem_granule_(0);
+    if (size > SIZE_MAX / 2 - page)
+        return false;
+    size = size ? (size + page - 1) / page * page : page;
+    const int fd = _stdmem_ring_fd_(size);
+    if (fd < 0)
+        return false;
+    unsigned char *base = mmap(NULL, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    bool ok = base != MAP_FAILED;
+    for (size_t half = 0; ok && half < 2; half++) {
+        unsigned char *at = base + half * size;
+        ok = mmap(at, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == at;
+    }
+    close(fd);
+    if (!ok) {
+        if (base != MAP_FAILED)
+            munmap(base, 2 * size);
+        return false;
+    }
+    ring->base = base;
+    ring->size = size;
+    return true;
+}
+
+void mem_ring_free(mem_ring_t *ring) {
+    if (ring->base)
+        munmap(ring->base, 2 * ring->size);
+    memset(ring, 0, sizeof(mem_ring_t));
+}
@@ -0,0 +1,624 @@
+#include "stdprof.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <math.h>
+
+/* ===============================================================
+ * ESTADO GLOBAL
+ * ===============================================================
+ * O registro de sites e a lista de threads só mudam no caminho
+ * lento (primeira passagem de um site ou de uma thread), sob um
+ * mutex. O id 0 fica reservado para "não registrado" e o último
+ * slot recebe os sites excedentes.
+ * =============================================================== */
+
+#define _STDPROF_OVERFLOW_ (PROF_MAX_SITES - 1u)
+
+_STDPROF_TLS_ prof_thread_t *_stdprof_self_ = NULL;
+
+static pthread_mutex_t _stdprof_lock_ = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t _stdprof_once_ = PTHREAD_ONCE_INIT;
+static pthread_key_t _stdprof_key_;
+static prof_site_t *_stdprof_sites_[PROF_MAX_SITES];
+static uint32_t _stdprof_count_ = 1;
+static prof_thread_t *_stdprof_threads_ = NULL;
+static _Atomic(double) _stdprof_ticks_per_ns_ = 0.0;
+
+static prof_site_t _stdprof_overflow_site_ = {"(overflow)", "", 0, _STDPROF_OVERFLOW_};
+
+static void _stdprof_slots_clear_(prof_thread_t *thread) {
+    for (size_t i = 0; i < PROF_MAX_SITES; i++) {
+        thread->slots[i].calls = 0;
+        thread->slots[i].ticks = 0;
+        thread->slots[i].min = UINT64_MAX;
+        thread->slots[i].max = 0;
+    }
+}
+
+/* A thread que termina só é marcada como livre: os totais continuam
+ * visíveis em prof_collect e o vetor é herdado pela próxima thread. */
+static void _stdprof_thread_exit_(void *arg) {
+    prof_thread_t *thread = (prof_thread_t *)arg;
+    pthread_mutex_lock(&_stdprof_lock_);
+    thread->alive = false;
+    pthread_mutex_unlock(&_stdprof_lock_);
+}
+
+static void _stdprof_init_(void) {
+    pthread_key_create(&_stdprof_key_, _stdprof_thread_exit_);
+}
+
+static prof_thread_t *_stdprof_attach_(void) {
+    pthread_once(&_stdprof_once_, _stdprof_init_);
+    prof_thread_t *thread = NULL;
+    pthread_mutex_lock(&_stdprof_lock_);
+    for (prof_thread_t *it = _stdprof_threads_; it; it = it->next) {
+        if (!it->alive) {
+            thread = it;
+            break;
+        }
+    }
+    if (!thread) {
+        thread = (prof_thread_t *)aligned_alloc(64, (sizeof(prof_thread_t) + 63u) & ~(size_t)63u);
+        if (thread) {
+            _stdprof_slots_clear_(thread);
+            thread->next = _stdprof_threads_;
+            _stdprof_threads_ = thread;
+        }
+    }
+    if (thread)
+        thread->alive = true;
+    pthread_mutex_unlock(&_stdprof_lock_);
+    if (thread)
+        pthread_setspecific(_stdprof_key_, thread);
+    return thread;
+}
+
+static void _stdprof_register_(prof_site_t *site) {
+    pthread_mutex_lock(&_stdprof_lock_);
+    if (!__atomic_load_n(&site->id, __ATOMIC_RELAXED)) {
+        uint32_t id = _STDPROF_OVERFLOW_;
+        if (_stdprof_count_ < _STDPROF_OVERFLOW_) {
+            id = _stdprof_count_++;
+            _stdprof_sites_[id] = site;
+        } else {
+            _stdprof_sites_[_STDPROF_OVERFLOW_] = &_stdprof_overflow_site_;
+        }
+        __atomic_store_n(&site->id, id, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&_stdprof_lock_);
+}
+
+void prof_record_slow(prof_site_t *site, uint64_t ticks) {
+    if (!_stdprof_self_)
+        _stdprof_self_ = _stdprof_attach_();
+    if (!__atomic_load_n(&site->id, __ATOMIC_ACQUIRE))
+        _stdprof_register_(site);
+    if (_stdprof_self_)
+        prof_slot_add(&_stdprof_self_->slots[site->id], ticks);
+}
+
+/* ===============================================================
+ * CALIBRAÇÃO
+ * ===============================================================
+ * Amostra o contador e CLOCK_MONOTONIC no início e após ~20 ms de
+ * espera ativa. As leituras de borda ficam entre dois prof_ticks
+ * para descontar a latência do clock_gettime.
+ * =============================================================== */
+
+static uint64_t _stdprof_mono_ns_(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void _stdprof_sample_(uint64_t *ticks, uint64_t *ns) {
+    uint64_t before = prof_ticks();
+    *ns = _stdprof_mono_ns_();
+    uint64_t after = prof_ticks();
+    *ticks = before + (after - before) / 2u;
+}
+
+double prof_calibrate(void) {
+    uint64_t ticks0, ns0, ticks1, ns1;
+    _stdprof_sample_(&ticks0, &ns0);
+    do {
+        _stdprof_sample_(&ticks1, &ns1);
+    } while (ns1 - ns0 < 20000000u);
+    double rate = (double)(ticks1 - ticks0) / (double)(ns1 - ns0);
+    if (!(rate > 0.0))
+        rate = 1.0;
+    atomic_store_explicit(&_stdprof_ticks_per_ns_, rate, memory_order_relaxed);
+    return rate;
+}
+
+double prof_ticks_per_ns(void) {
+    double rate = atomic_load_explicit(&_stdprof_ticks_per_ns_, memory_order_relaxed);
+    return rate > 0.0 ? rate : prof_calibrate();
+}
+
+double prof_ticks_to_ns(uint64_t ticks) {
+    return (double)ticks / prof_ticks_per_ns();
+}
+
+/* Diferença entre as medianas de um intervalo com e sem um par
+ * vazio dentro: desconta a leitura que fecha o próprio intervalo.
+ * O acúmulo vai para um slot local, para não poluir o relatório. */
+static uint64_t _stdprof_median_(uint64_t *samples, size_t count) {
+    for (size_t i = 1; i < count; i++) {
+        uint64_t value = samples[i];
+        size_t j = i;
+        for (; j > 0 && samples[j - 1] > value; j--)
+            samples[j] = samples[j - 1];
+        samples[j] = value;
+    }
+    return samples[count / 2];
+}
+
+uint64_t prof_overhead(void) {
+    enum { SAMPLES = 1023 };
+    uint64_t probe[SAMPLES], empty[SAMPLES];
+    prof_slot_t scratch = {0, 0, UINT64_MAX, 0};
+    for (size_t i = 0; i < SAMPLES; i++) {
+        uint64_t start = prof_ticks();
+        uint64_t t0 = prof_ticks();
+        prof_slot_add(&scratch, prof_ticks() - t0);
+        probe[i] = prof_ticks() - start;
+        start = prof_ticks();
+        empty[i] = prof_ticks() - start;
+    }
+    uint64_t with = _stdprof_median_(probe, SAMPLES);
+    uint64_t without = _stdprof_median_(empty, SAMPLES);
+    return with > without ? with - without : 0;
+}
+
+/* ===============================================================
+ * COLETA E RELATÓRIOS
+ * =============================================================== */
+
+size_t prof_collect(prof_stat_t *out, size_t max) {
+    size_t written = 0;
+    pthread_mutex_lock(&_stdprof_lock_);
+    for (uint32_t id = 1; id < PROF_MAX_SITES && written < max; id++) {
+        const prof_site_t *site = _stdprof_sites_[id];
+        if (!site)
+            continue;
+        prof_stat_t stat = {site->name, site->file, site->line, 0, 0, UINT64_MAX, 0};
+        for (const prof_thread_t *it = _stdprof_threads_; it; it = it->next) {
+            const prof_slot_t *slot = &it->slots[id];
+            if (!slot->calls)
+                continue;
+            stat.calls += slot->calls;
+            stat.ticks += slot->ticks;
+            if (slot->min < stat.min)
+                stat.min = slot->min;
+            if (slot->max > stat.max)
+                stat.max = slot->max;
+        }
+        if (!stat.calls)
+            stat.min = 0;
+        out[written++] = stat;
+    }
+    pthread_mutex_unlock(&_stdprof_lock_);
+    return written;
+}
+
+void prof_reset(void) {
+    pthread_mutex_lock(&_stdprof_lock_);
+    for (prof_thread_t *it = _stdprof_threads_; it; it = it->next)
+        _stdprof_slots_clear_(it);
+    pthread_mutex_unlock(&_stdprof_lock_);
+}
+
+static bool _stdprof_dump_csv_(FILE *file, const prof_stat_t *stats, size_t count) {
+    double rate = prof_ticks_per_ns();
+    if (fprintf(file, "name,file,line,calls,total_ns,mean_ns,min_ns,max_ns,total_ticks\n") < 0)
+        return false;
+    for (size_t i = 0; i < count; i++) {
+        const prof_stat_t *stat = &stats[i];
+        double total = (double)stat->ticks / rate;
+        double mean = stat->calls ? total / (double)stat->calls : 0.0;
+        if (fprintf(file, "%s,%s,%u,%llu,%.1f,%.2f,%.1f,%.1f,%llu\n", stat->name, stat->file,
+                    (unsigned)stat->line, (unsigned long long)stat->calls, total, mean,
+                    (double)stat->min / rate, (double)stat->max / rate,
+                    (unsigned long long)stat->ticks) < 0)
+            return false;
+    }
+    return true;
+}
+
+/* Inteiros gravados em little-endian independentemente do host. */
+static bool _stdprof_put_(FILE *file, uint64_t value, size_t bytes) {
+    unsigned char buf[8];
+    for (size_t i = 0; i < bytes; i++)
+        buf[i] = (unsigned char)(value >> (8u * i));
+    return fwrite(buf, 1, bytes, file) == bytes;
+}
+
+static bool _stdprof_put_str_(FILE *file, const char *text) {
+    size_t len = strlen(text);
+    if (len > UINT16_MAX)
+        len = UINT16_MAX;
+    return _stdprof_put_(file, len, 2) && fwrite(text, 1, len, file) == len;
+}
+
+static bool _stdprof_dump_binary_(FILE *file, const prof_stat_t *stats, size_t count) {
+    double rate = prof_ticks_per_ns();
+    uint64_t rate_bits;
+    memcpy(&rate_bits, &rate, sizeof(rate_bits));
+    if (fwrite("SFPROF1", 1, 8, file) != 8 || !_stdprof_put_(file, rate_bits, 8) ||
+        !_stdprof_put_(file, count, 4))
+        return false;
+    for (size_t i = 0; i < count; i++) {
+        const prof_stat_t *stat = &stats[i];
+        if (!_stdprof_put_(file, stat->calls, 8) || !_stdprof_put_(file, stat->ticks, 8) ||
+            !_stdprof_put_(file, stat->min, 8) || !_stdprof_put_(file, stat->max, 8) ||
+            !_stdprof_put_(file, stat->line, 4) || !_stdprof_put_str_(file, stat->name) ||
+            !_stdprof_put_str_(file, stat->file))
+            return false;
+    }
+    return true;
+}
+
+bool prof_dump_file(FILE *file, unsigned format) {
+    if (!file || format > PROF_FORMAT_BINARY)
+        return false;
+    prof_stat_t *stats = (prof_stat_t *)malloc(PROF_MAX_SITES * sizeof(prof_stat_t));
+    if (!stats)
+        return false;
+    size_t count = prof_collect(stats, PROF_MAX_SITES);
+    bool ok = format == PROF_FORMAT_CSV ? _stdprof_dump_csv_(file, stats, count)
+                                        : _stdprof_dump_binary_(file, stats, count);
+    free(stats);
+    return ok && fflush(file) == 0;
+}
+
+bool prof_dump(const char *path, unsigned format) {
+    FILE *file = fopen(path, format == PROF_FORMAT_BINARY ? "wb" : "w");
+    if (!file)
+        return false;
+    bool ok = prof_dump_file(file, format);
+    return fclose(file) == 0 && ok;
+}
+
+/* ===============================================================
+ * HISTOGRAMA LOG-LINEAR
+ * ===============================================================
+ * sub_bits = ceil(log2(2 * 10^digits)), como no HdrHistogram: o
+ * primeiro bucket tem resolução unitária até 2^sub_bits e cada
+ * bucket seguinte dobra a largura dos sub-buckets.
+ * =============================================================== */
+
+bool prof_hist_init(prof_hist_t *hist, uint64_t highest, unsigned digits) {
+    memset(hist, 0, sizeof(*hist));
+    if (digits < 1 || digits > 5 || highest < 2)
+        return false;
+    uint64_t single_unit = 2;
+    for (unsigned i = 0; i < digits; i++)
+        single_unit *= 10u;
+    uint32_t sub_bits = 1;
+    while (((uint64_t)1 << sub_bits) < single_unit)
+        sub_bits++;
+    hist->sub_bits = sub_bits;
+    hist->digits = digits;
+    hist->highest = highest;
+    hist->len = prof_hist_index(hist, highest) + 1u;
+    hist->counts = (uint64_t *)calloc(hist->len, sizeof(uint64_t));
+    if (!hist->counts)
+        return false;
+    hist->min = UINT64_MAX;
+    return true;
+}
+
+void prof_hist_free(prof_hist_t *hist) {
+    free(hist->counts);
+    hist->counts = NULL;
+    hist->len = 0;
+}
+
+void prof_hist_reset(prof_hist_t *hist) {
+    memset(hist->counts, 0, hist->len * sizeof(uint64_t));
+    hist->total = 0;
+    hist->min = UINT64_MAX;
+    hist->max = 0;
+}
+
+uint64_t prof_hist_lowest_at(const prof_hist_t *hist, size_t index) {
+    const uint64_t half = (uint64_t)1 << (hist->sub_bits - 1u);
+    const uint64_t bucket = (uint64_t)index >> (hist->sub_bits - 1u);
+    if (bucket <= 1u)
+        return (uint64_t)index;
+    return (((uint64_t)index & (half - 1u)) + half) << (bucket - 1u);
+}
+
+uint64_t prof_hist_highest_at(const prof_hist_t *hist, size_t index) {
+    const uint64_t bucket = (uint64_t)index >> (hist->sub_bits - 1u);
+    if (bucket <= 1u)
+        return (uint64_t)index;
+    return prof_hist_lowest_at(hist, index) + (((uint64_t)1 << (bucket - 1u)) - 1u);
+}
+
+/* Maior valor equivalente do bucket que contém o percentil, limitado
+ * a [min, max] para que p0 e p100 sejam exatos. */
+uint64_t prof_hist_percentile(const prof_hist_t *hist, double percentile) {
+    if (!hist->total)
+        return 0;
+    if (percentile <= 0.0)
+        return hist->min;
+    if (percentile > 100.0)
+        percentile = 100.0;
+    uint64_t target = (uint64_t)ceil(percentile / 100.0 * (double)hist->total);
+    if (target < 1u)
+        target = 1u;
+    if (target >= hist->total)
+        return hist->max;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < hist->len; i++) {
+        seen += hist->counts[i];
+        if (seen >= target) {
+            uint64_t value = prof_hist_highest_at(hist, i);
+            if (value > hist->max)
+                value = hist->max;
+            return value < hist->min ? hist->min : value;
+        }
+    }
+    return hist->max;
+}
+
+/* Usa o ponto médio de cada bucket, como o HdrHistogram. */
+double prof_hist_mean(const prof_hist_t *hist) {
+    if (!hist->total)
+        return 0.0;
+    double sum = 0.0;
+    for (size_t i = 0; i < hist->len; i++) {
+        if (!hist->counts[i])
+            continue;
+        uint64_t low = prof_hist_lowest_at(hist, i);
+        double mid = (double)low + (double)(prof_hist_highest_at(hist, i) - low) / 2.0;
+        sum += mid * (double)hist->counts[i];
+    }
+    return sum / (double)hist->total;
+}
+
+/* Layouts iguais somam índice a índice; precisões iguais com faixas
+ * diferentes reindexam pelo menor valor de cada bucket. */
+bool prof_hist_merge(prof_hist_t *dst, const prof_hist_t *src) {
+    if (dst->sub_bits != src->sub_bits)
+        return false;
+    if (dst->len == src->len) {
+        for (size_t i = 0; i < src->len; i++)
+            dst->counts[i] += src->counts[i];
+    } else {
+        for (size_t i = 0; i < src->len; i++) {
+            if (src->counts[i])
+                dst->counts[prof_hist_index(dst, prof_hist_lowest_at(src, i))] += src->counts[i];
+        }
+    }
+    dst->total += src->total;
+    if (src->min < dst->min)
+        dst->min = src->min;
+    if (src->max > dst->max)
+        dst->max = src->max;
+    return true;
+}
+
+/* ===============================================================
+ * SERIALIZAÇÃO
+ * ===============================================================
+ * "SFH1", varints LEB128 de digits, highest, min, max e total (que
+ * detecta truncamento), e então as contagens como no HdrHistogram
+ * V2: ZigZag LEB128, uma sequência de N zeros vira -N e os zeros
+ * finais são omitidos.
+ * =============================================================== */
+
+static size_t _stdprof_varint_(uint8_t *buf, size_t cap, size_t pos, uint64_t value) {
+    do {
+        uint8_t byte = (uint8_t)(value & 0x7fu);
+        value >>= 7;
+        if (value)
+            byte |= 0x80u;
+        if (buf && pos < cap)
+            buf[pos] = byte;
+        pos++;
+    } while (value);
+    return pos;
+}
+
+static bool _stdprof_varint_read_(const uint8_t *buf, size_t len, size_t *pos, uint64_t *value) {
+    uint64_t result = 0;
+    for (unsigned shift = 0; shift < 64u; shift += 7u) {
+        if (*pos >= len)
+            return false;
+        uint8_t byte = buf[(*pos)++];
+        result |= (uint64_t)(byte & 0x7fu) << shift;
+        if (!(byte & 0x80u)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static size_t _stdprof_hist_encode_(const prof_hist_t *hist, uint8_t *buf, size_t cap) {
+    if (buf)
+        memcpy(buf, "SFH1", 4);
+    size_t pos = 4;
+    pos = _stdprof_varint_(buf, cap, pos, hist->digits);
+    pos = _stdprof_varint_(buf, cap, pos, hist->highest);
+    pos = _stdprof_varint_(buf, cap, pos, hist->min);
+    pos = _stdprof_varint_(buf, cap, pos, hist->max);
+    pos = _stdprof_varint_(buf, cap, pos, hist->total);
+    size_t last = hist->len;
+    while (last > 0 && !hist->counts[last - 1])
+        last--;
+    for (size_t i = 0; i < last;) {
+        if (hist->counts[i]) {
+            pos = _stdprof_varint_(buf, cap, pos, hist->counts[i] << 1);
+            i++;
+            continue;
+        }
+        uint64_t run = 0;
+        for (; i < last && !hist->counts[i]; i++)
+            run++;
+        pos = _stdprof_varint_(buf, cap, pos, ((run - 1u) << 1) | 1u);
+    }
+    return pos;
+}
+
+size_t prof_hist_encode(const prof_hist_t *hist, uint8_t *buf, size_t cap) {
+    size_t need = _stdprof_hist_encode_(hist, NULL, 0);
+    if (buf && cap >= need)
+        _stdprof_hist_encode_(hist, buf, cap);
+    return need;
+}
+
+bool prof_hist_decode(prof_hist_t *hist, const uint8_t *buf, size_t len) {
+    uint64_t digits, highest, min, max, total;
+    size_t pos = 4;
+    memset(hist, 0, sizeof(*hist));
+    if (len < 4u || memcmp(buf, "SFH1", 4) != 0 || !_stdprof_varint_read_(buf, len, &pos, &digits) ||
+        !_stdprof_varint_read_(buf, len, &pos, &highest) ||
+        !_stdprof_varint_read_(buf, len, &pos, &min) || !_stdprof_varint_read_(buf, len, &pos, &max) ||
+        !_stdprof_varint_read_(buf, len, &pos, &total) || digits > 5u || !prof_hist_init(hist, highest, (unsigned)digits))
+        return false;
+    size_t index = 0;
+    while (pos < len) {
+        uint64_t value;
+        if (!_stdprof_varint_read_(buf, len, &pos, &value))
+            break;
+        if (value & 1u) {
+            uint64_t run = (value >> 1) + 1u;
+            if (run > hist->len - index)
+                break;
+            index += (size_t)run;
+        } else {
+            if (index >= hist->len)
+                break;
+            hist->counts[index++] = value >> 1;
+            hist->total += value >> 1;
+        }
+    }
+    if (pos < len || hist->total != total) {
+        prof_hist_free(hist);
+        return false;
+    }
+    hist->min = min;
+    hist->max = max;
+    return true;
+}
+
+/* ===============================================================
+ * SHARDS POR THREAD
+ * ===============================================================
+ * Mesmo esquema do mem_pool: uma pthread_key por conjunto aponta
+ * para o shard da thread. O destrutor só marca o shard como livre;
+ * as contagens continuam no merge e o próximo dono as herda.
+ * =============================================================== */
+
+typedef struct _stdprof_shard {
+    prof_hist_t hist;
+    struct _stdprof_shard *next;
+    bool owned;
+} _stdprof_shard_t;
+
+struct prof_hist_set {
+    pthread_mutex_t lock;
+    pthread_key_t key;
+    _stdprof_shard_t *shards;
+    uint64_t highest;
+    unsigned digits;
+};
+
+static void _stdprof_shard_release_(void *arg) {
+    _stdprof_shard_t *shard = (_stdprof_shard_t *)arg;
+    __atomic_store_n(&shard->owned, false, __ATOMIC_RELEASE);
+}
+
+prof_hist_set_t *prof_hist_set_init(uint64_t highest, unsigned digits) {
+    prof_hist_t probe;
+    if (!prof_hist_init(&probe, highest, digits))
+        return NULL;
+    prof_hist_free(&probe);
+    prof_hist_set_t *set = (prof_hist_set_t *)calloc(1, sizeof(prof_hist_set_t));
+    if (!set)
+        return NULL;
+    if (pthread_key_create(&set->key, _stdprof_shard_release_) != 0) {
+        free(set);
+        return NULL;
+    }
+    pthread_mutex_init(&set->lock, NULL);
+    set->highest = highest;
+    set->digits = digits;
+    return set;
+}
+
+void prof_hist_set_free(prof_hist_set_t *set) {
+    if (!set)
+        return;
+    pthread_key_delete(set->key);
+    for (_stdprof_shard_t *shard = set->shards, *next; shard; shard = next) {
+        next = shard->next;
+        prof_hist_free(&shard->hist);
+        free(shard);
+    }
+    pthread_mutex_destroy(&set->lock);
+    free(set);
+}
+
+static _stdprof_shard_t *_stdprof_shard_create_(prof_hist_set_t *set) {
+    _stdprof_shard_t *shard = NULL;
+    pthread_mutex_lock(&set->lock);
+    for (_stdprof_shard_t *it = set->shards; it; it = it->next) {
+        if (!__atomic_load_n(&it->owned, __ATOMIC_ACQUIRE)) {
+            shard = it;
+            break;
+        }
+    }
+    if (!shard) {
+        shard = (_stdprof_shard_t *)calloc(1, sizeof(_stdprof_shard_t));
+        if (shard && !prof_hist_init(&shard->hist, set->highest, set->digits)) {
+            free(shard);
+            shard = NULL;
+        }
+        if (shard) {
+            shard->next = set->shards;
+            set->shards = shard;
+        }
+    }
+    if (shard)
+        __atomic_store_n(&shard->owned, true, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&set->lock);
+    if (shard && pthread_setspecific(set->key, shard) != 0) {
+        _stdprof_shard_release_(shard);
+        return NULL;
+    }
+    return shard;
+}
+
+prof_hist_t *prof_hist_local(prof_hist_set_t *set) {
+    _stdprof_shard_t *shard = (_stdprof_shard_t *)pthread_getspecific(set->key);
+    if (!shard)
+        shard = _stdprof_shard_create_(set);
+    return shard ? &shard->hist : NULL;
+}
+
+bool prof_hist_set_merge(prof_hist_set_t *set, prof_hist_t *out) {
+    bool ok = true;
+    pthread_mutex_lock(&set->lock);
+    for (_stdprof_shard_t *shard = set->shards; shard; shard = shard->next)
+        ok = prof_hist_merge(out, &shard->hist) && ok;
+    pthread_mutex_unlock(&set->lock);
+    return ok;
+}
+
+void prof_hist_set_reset(prof_hist_set_t *set) {
+    pthread_mutex_lock(&set->lock);
+    for (_stdprof_shard_t *shard = set->shards; shard; shard = shard->next)
+        prof_hist_reset(&shard->hist);
+    pthread_mutex_unlock(&set->lock);
+}
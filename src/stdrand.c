@@ -1,12 +1,29 @@
+#undef STDFRIGO_INLINE
+#define _STDRAND_IMPL_
 #include "stdrand.h"
 #include <stdconst.h>
 #include <stdhash.h>
+#include <stdthrd.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
 
 #if defined(_MSC_VER)
 #include <intrin.h>
 #endif
 
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/random.h>
+#endif
+
 #if defined(__x86_64__) || defined(_M_X64)
 #include <immintrin.h>
 #if defined(__GNUC__) || defined(__clang__)
@@ -32,10 +49,12 @@
  * Diferente do shift (<<) que descarta bits, a rotação move os
  * bits circularmente, preservando 100% da entropia.
  * Compiladores modernos otimizam isso para uma única instrução
- * de CPU (ROL/ROR).
+ * de CPU (ROL/ROR). Definida em stdrand.h, junto com rand32/64_next
+ * e rand32/64_bound (modo STDFRIGO_INLINE).
  *
- * 3. Multiplicação portável 64x64=128 bits.
- * Retorna a parte BAIXA e armazena a ALTA
+ * 3. Multiplicação portável 64x64=128 bits (_stdrand_mul128_).
+ * Retorna a parte BAIXA e armazena a ALTA. Definida em stdrand.h
+ * por ser compartilhada com o gerador inline rand_wy_t.
  * =============================================================== */
 
 static inline uint64_t _stdrand_splitmix64_next_(uint64_t *state) {
@@ -43,24 +62,6 @@ static inline uint64_t _stdrand_splitmix64_next_(uint64_t *state) {
     return hash64_int(*state);
 }
 
-static inline uint32_t _stdrand_rotl32_(const uint32_t x, int k) {
-    return (x << k) | (x >> (32 - k));
-}
-
-static inline uint64_t _stdrand_rotl64_(const uint64_t x, int k) {
-    return (x << k) | (x >> (64 - k));
-}
-
-static inline uint64_t _stdrand_mul128_(uint64_t x, uint64_t y, uint64_t *high) {
-#if defined(__GNUC__) || defined(__clang__)
-    unsigned __int128 r = (unsigned __int128)x * (unsigned __int128)y;
-    *high = (uint64_t)(r >> 64);
-    return (uint64_t)r;
-#else
-    return (uint64_t)_umul128(x, y, high);
-#endif
-}
-
 /* ===============================================================
  * MACROS DE CONVERSÃO PARA PONTO FLUTUANTE (IEEE 754)
  * ===============================================================
@@ -101,18 +102,6 @@ rand32_t rand32_init(uint64_t seed) {
     return rng;
 }
 
-uint32_t rand32_next(rand32_t *rng) {
-    const uint32_t result = _stdrand_rotl32_(rng->s[1] * 5, 7) * 9;
-    const uint32_t t = rng->s[1] << 9;
-    rng->s[2] ^= rng->s[0];
-    rng->s[3] ^= rng->s[1];
-    rng->s[1] ^= rng->s[2];
-    rng->s[0] ^= rng->s[3];
-    rng->s[2] ^= t;
-    rng->s[3] = _stdrand_rotl32_(rng->s[3], 11);
-    return result;
-}
-
 /* ===============================================================
  * RAND64 (Algoritmo: xoshiro256**)
  * ===============================================================
@@ -132,18 +121,6 @@ rand64_t rand64_init(uint64_t seed) {
     return rng;
 }
 
-uint64_t rand64_next(rand64_t *rng) {
-    const uint64_t result = _stdrand_rotl64_(rng->s[1] * 5, 7) * 9;
-    const uint64_t t = rng->s[1] << 17;
-    rng->s[2] ^= rng->s[0];
-    rng->s[3] ^= rng->s[1];
-    rng->s[1] ^= rng->s[2];
-    rng->s[0] ^= rng->s[3];
-    rng->s[2] ^= t;
-    rng->s[3] = _stdrand_rotl64_(rng->s[3], 45);
-    return result;
-}
-
 /* ===============================================================
  * RAND FLOAT (xoshiro128+)
  * ===============================================================
@@ -318,35 +295,6 @@ void rand_double_jump(rand_double_t *rng) {
  * Retorna: [0, limit)
  * =============================================================== */
 
-uint32_t rand32_bound(rand32_t *rng, uint32_t limit) {
-    uint32_t x = rand32_next(rng);
-    uint64_t m = (uint64_t)x * (uint64_t)limit;
-    uint32_t l = (uint32_t)m;
-    if (l < limit) {
-        uint32_t t = -limit % limit;
-        while (l < t) {
-            x = rand32_next(rng);
-            m = (uint64_t)x * (uint64_t)limit;
-            l = (uint32_t)m;
-        }
-    }
-    return (uint32_t)(m >> 32);
-}
-
-uint64_t rand64_bound(rand64_t *rng, uint64_t limit) {
-    uint64_t x = rand64_next(rng);
-    uint64_t h;
-    uint64_t l = _stdrand_mul128_(x, limit, &h);
-    if (l < limit) {
-        uint64_t t = -limit % limit;
-        while (l < t) {
-            x = rand64_next(rng);
-            l = _stdrand_mul128_(x, limit, &h);
-        }
-    }
-    return h;
-}
-
 float rand_float_bound(rand_float_t *rng, float limit) {
     return rand_float_next(rng) * limit;
 }
@@ -377,6 +325,1056 @@ double rand_double_range(rand_double_t *rng, double min, double max) {
     return min + rand_double_next(rng) * (max - min);
 }
 
+/* ===============================================================
+ * AMOSTRAGEM DISCRETA PONDERADA (Alias de Vose)
+ * ===============================================================
+ * Construção: O(n). Cada índice recebe uma probabilidade própria
+ * (limiar em ponto fixo de 64 bits) e um "alias" que completa a
+ * fatia até 1/n.
+ *
+ * Amostragem: O(1). Um único rand64_next é multiplicado por n
+ * (64x64=128 bits): a parte ALTA é o índice uniforme em [0, n) e
+ * a parte BAIXA é a fração usada como limiar. O viés de ambas é
+ * no máximo n/2^64.
+ *
+ * Rebuild: rand_alias_update apenas registra o novo peso;
+ * rand_alias_rebuild refaz a tabela inteira em O(n), qualquer que
+ * seja o número de pesos alterados, reutilizando os buffers já
+ * alocados. Mudar um peso altera a soma e portanto a escala de
+ * todos os índices, e o pareamento de Vose não é local; uma
+ * atualização por bucket exigiria rejeição na amostragem.
+ * =============================================================== */
+
+static inline uint64_t _stdrand_alias_fixed_(double p) {
+    const double d = p * 0x1.0p64;
+    if (d >= 0x1.0p64)
+        return UINT64_MAX;
+    return (uint64_t)d;
+}
+
+static bool _stdrand_alias_build_(rand_alias_t *table) {
+    const size_t n = table->size;
+    double total = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        total += table->weight[i];
+    }
+    if (!(total > 0.0) || !isfinite(total))
+        return false;
+
+    const double scale = (double)n / total;
+    double *scaled = table->scaled;
+    uint32_t *work = table->work;
+    size_t small = 0;
+    size_t large = n;
+
+    for (size_t i = 0; i < n; i++) {
+        scaled[i] = table->weight[i] * scale;
+        if (scaled[i] < 1.0) {
+            work[small++] = (uint32_t)i;
+        } else {
+            work[--large] = (uint32_t)i;
+        }
+    }
+
+    while (small > 0 && large < n) {
+        const uint32_t s = work[--small];
+        const uint32_t l = work[large];
+        table->slot[s].prob = _stdrand_alias_fixed_(scaled[s]);
+        table->slot[s].alias = l;
+        scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+        if (scaled[l] < 1.0) {
+            large++;
+            work[small++] = l;
+        }
+    }
+
+    while (large < n) {
+        const uint32_t l = work[large++];
+        table->slot[l].prob = UINT64_MAX;
+        table->slot[l].alias = l;
+    }
+    while (small > 0) {
+        const uint32_t s = work[--small];
+        table->slot[s].prob = UINT64_MAX;
+        table->slot[s].alias = s;
+    }
+
+    table->dirty = false;
+    return true;
+}
+
+bool rand_alias_init(rand_alias_t *table, const double *weights, size_t size) {
+    *table = (rand_alias_t){0};
+    if (size == 0 || size > UINT32_MAX)
+        return false;
+    for (size_t i = 0; i < size; i++) {
+        if (!(weights[i] >= 0.0) || !isfinite(weights[i]))
+            return false;
+    }
+
+    table->slot = malloc(size * sizeof(rand_alias_slot_t));
+    table->weight = malloc(size * sizeof(double));
+    table->scaled = malloc(size * sizeof(double));
+    table->work = malloc(size * sizeof(uint32_t));
+    table->size = size;
+    if (!table->slot || !table->weight || !table->scaled || !table->work) {
+        rand_alias_free(table);
+        return false;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        table->weight[i] = weights[i];
+    }
+    if (!_stdrand_alias_build_(table)) {
+        rand_alias_free(table);
+        return false;
+    }
+    return true;
+}
+
+void rand_alias_free(rand_alias_t *table) {
+    free(table->slot);
+    free(table->weight);
+    free(table->scaled);
+    free(table->work);
+    *table = (rand_alias_t){0};
+}
+
+bool rand_alias_update(rand_alias_t *table, size_t index, double weight) {
+    if (index >= table->size || !(weight >= 0.0) || !isfinite(weight))
+        return false;
+    table->weight[index] = weight;
+    table->dirty = true;
+    return true;
+}
+
+bool rand_alias_rebuild(rand_alias_t *table) {
+    if (!table->dirty)
+        return true;
+    return _stdrand_alias_build_(table);
+}
+
+size_t rand_alias_next(const rand_alias_t *table, rand64_t *rng) {
+    uint64_t index;
+    const uint64_t frac = _stdrand_mul128_(rand64_next(rng), table->size, &index);
+    const rand_alias_slot_t *slot = &table->slot[index];
+    return frac < slot->prob ? (size_t)index : (size_t)slot->alias;
+}
+
+void rand_alias_fill(const rand_alias_t *table, rand64_t *rng, size_t *out, size_t count) {
+    const rand_alias_slot_t *slot = table->slot;
+    const uint64_t size = table->size;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t index;
+        const uint64_t frac = _stdrand_mul128_(rand64_next(rng), size, &index);
+        out[i] = frac < slot[index].prob ? (size_t)index : (size_t)slot[index].alias;
+    }
+}
+
+/* ===============================================================
+ * AMOSTRAGEM EM FLUXO (Reservoir Sampling)
+ * ===============================================================
+ * 1. Uniforme (Algoritmo L, Li 1994):
+ * Em vez de sortear um número por item, sorteia quantos itens
+ * pular até a próxima substituição (distribuição geométrica).
+ * Custo: O(k log(n/k)) sorteios para n itens. Itens pulados
+ * custam apenas um incremento de contador.
+ *
+ * 2. Ponderada (A-ExpJ, Efraimidis & Spirakis 2006):
+ * Cada item recebe a chave u^(1/w); o reservatório guarda as k
+ * maiores chaves em um min-heap. O salto exponencial sorteia
+ * quanto PESO pular até a próxima inserção. As chaves são
+ * mantidas em escala logarítmica (log(u)/w) para evitar underflow
+ * com pesos grandes.
+ *
+ * 3. Merge:
+ * Ponderado: une os heaps e mantém as k maiores chaves (exato).
+ * Uniforme: sorteia cada posição da união proporcionalmente à
+ * população restante de cada lado; o novo limiar W do Algoritmo L
+ * é re-amostrado como Beta(k, n - k + 1), a distribuição da k-ésima
+ * menor chave entre n uniformes.
+ * =============================================================== */
+
+static inline double _stdrand_open01_(rand_double_t *rng) {
+    return 1.0 - rand_double_next(rng);
+}
+
+static inline size_t _stdrand_index_(rand_double_t *rng, size_t size) {
+    const size_t i = (size_t)(rand_double_next(rng) * (double)size);
+    return i < size ? i : size - 1;
+}
+
+static double _stdrand_normal_(rand_double_t *rng) {
+    double u, v, s;
+    do {
+        u = 2.0 * rand_double_next(rng) - 1.0;
+        v = 2.0 * rand_double_next(rng) - 1.0;
+        s = u * u + v * v;
+    } while (s >= 1.0 || s == 0.0);
+    return u * sqrt(-2.0 * log(s) / s);
+}
+
+static double _stdrand_gamma_(rand_double_t *rng, double shape) {
+    const double d = shape - 1.0 / 3.0;
+    const double c = 1.0 / sqrt(9.0 * d);
+    for (;;) {
+        double x, v;
+        do {
+            x = _stdrand_normal_(rng);
+            v = 1.0 + c * x;
+        } while (v <= 0.0);
+        v = v * v * v;
+        if (log(_stdrand_open01_(rng)) < 0.5 * x * x + d - d * v + d * log(v))
+            return d * v;
+    }
+}
+
+static inline uint64_t _stdrand_reservoir_skip_(rand_reservoir_t *res) {
+    const double skip = floor(log(_stdrand_open01_(&res->rng)) / log1p(-res->w));
+    if (!(skip < 0x1.0p63))
+        return UINT64_MAX >> 1;
+    return (uint64_t)skip;
+}
+
+static inline void _stdrand_reservoir_advance_(rand_reservoir_t *res) {
+    res->w *= exp(log(_stdrand_open01_(&res->rng)) / (double)res->capacity);
+    res->next = res->seen + _stdrand_reservoir_skip_(res);
+}
+
+bool rand_reservoir_init(rand_reservoir_t *res, size_t capacity, size_t elem_size, uint64_t seed) {
+    *res = (rand_reservoir_t){0};
+    if (capacity == 0 || elem_size == 0 || capacity > SIZE_MAX / elem_size)
+        return false;
+    res->items = malloc(capacity * elem_size);
+    if (!res->items)
+        return false;
+    res->elem_size = elem_size;
+    res->capacity = capacity;
+    res->w = 1.0;
+    res->rng = rand_double_init(seed);
+    return true;
+}
+
+void rand_reservoir_free(rand_reservoir_t *res) {
+    free(res->items);
+    *res = (rand_reservoir_t){0};
+}
+
+void rand_reservoir_offer(rand_reservoir_t *res, const void *items, size_t count) {
+    const uint8_t *p = (const uint8_t *)items;
+    const size_t elem = res->elem_size;
+    uint8_t *dst = (uint8_t *)res->items;
+
+    while (count > 0 && res->count < res->capacity) {
+        memcpy(dst + res->count * elem, p, elem);
+        res->count++;
+        res->seen++;
+        p += elem;
+        count--;
+        if (res->count == res->capacity) {
+            _stdrand_reservoir_advance_(res);
+        }
+    }
+
+    while (count > 0) {
+        const uint64_t gap = res->next - res->seen;
+        if (gap >= count) {
+            res->seen += count;
+            return;
+        }
+        p += (size_t)gap * elem;
+        count -= (size_t)gap;
+        res->seen += gap;
+
+        memcpy(dst + _stdrand_index_(&res->rng, res->capacity) * elem, p, elem);
+        res->seen++;
+        p += elem;
+        count--;
+        _stdrand_reservoir_advance_(res);
+    }
+}
+
+bool rand_reservoir_merge(rand_reservoir_t *dst, const rand_reservoir_t *src) {
+    if (dst->elem_size != src->elem_size || dst->capacity != src->capacity)
+        return false;
+    if (src->seen == 0)
+        return true;
+
+    const size_t elem = dst->elem_size;
+    const size_t a = dst->count;
+    const size_t b = src->count;
+    uint8_t *tmp = malloc((a + b) * elem);
+    if (!tmp)
+        return false;
+    memcpy(tmp, dst->items, a * elem);
+    memcpy(tmp + a * elem, src->items, b * elem);
+
+    uint8_t *pool_a = tmp;
+    uint8_t *pool_b = tmp + a * elem;
+    size_t left_a = a;
+    size_t left_b = b;
+    uint64_t pop_a = dst->seen;
+    uint64_t pop_b = src->seen;
+    const uint64_t total = pop_a + pop_b;
+    const size_t picks = total < dst->capacity ? (size_t)total : dst->capacity;
+
+    for (size_t j = 0; j < picks; j++) {
+        const bool from_a = rand_double_next(&dst->rng) * (double)(pop_a + pop_b) < (double)pop_a;
+        uint8_t *pool = (from_a && left_a > 0) || left_b == 0 ? pool_a : pool_b;
+        size_t *left = pool == pool_a ? &left_a : &left_b;
+        uint64_t *pop = pool == pool_a ? &pop_a : &pop_b;
+
+        const size_t i = _stdrand_index_(&dst->rng, *left);
+        memcpy((uint8_t *)dst->items + j * elem, pool + i * elem, elem);
+        memcpy(pool + i * elem, pool + (*left - 1) * elem, elem);
+        (*left)--;
+        (*pop)--;
+    }
+    free(tmp);
+
+    dst->count = picks;
+    dst->seen = total;
+    if (picks == dst->capacity) {
+        const double k = (double)dst->capacity;
+        const double x = _stdrand_gamma_(&dst->rng, k);
+        const double y = _stdrand_gamma_(&dst->rng, (double)total - k + 1.0);
+        dst->w = x / (x + y);
+        dst->next = dst->seen + _stdrand_reservoir_skip_(dst);
+    }
+    return true;
+}
+
+static void _stdrand_wheap_down_(rand_wreservoir_key_t *heap, size_t size, size_t i) {
+    const rand_wreservoir_key_t top = heap[i];
+    for (;;) {
+        size_t c = 2 * i + 1;
+        if (c >= size)
+            break;
+        if (c + 1 < size && heap[c + 1].key < heap[c].key)
+            c++;
+        if (heap[c].key >= top.key)
+            break;
+        heap[i] = heap[c];
+        i = c;
+    }
+    heap[i] = top;
+}
+
+static void _stdrand_wheap_up_(rand_wreservoir_key_t *heap, size_t i) {
+    const rand_wreservoir_key_t last = heap[i];
+    while (i > 0) {
+        const size_t parent = (i - 1) / 2;
+        if (heap[parent].key <= last.key)
+            break;
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = last;
+}
+
+static inline void _stdrand_wreservoir_jump_(rand_wreservoir_t *res) {
+    res->skip = log(_stdrand_open01_(&res->rng)) / res->heap[0].key;
+}
+
+bool rand_wreservoir_init(rand_wreservoir_t *res, size_t capacity, size_t elem_size, uint64_t seed) {
+    *res = (rand_wreservoir_t){0};
+    if (capacity == 0 || elem_size == 0 || capacity > SIZE_MAX / elem_size)
+        return false;
+    res->items = malloc(capacity * elem_size);
+    res->heap = malloc(capacity * sizeof(rand_wreservoir_key_t));
+    if (!res->items || !res->heap) {
+        rand_wreservoir_free(res);
+        return false;
+    }
+    res->elem_size = elem_size;
+    res->capacity = capacity;
+    res->rng = rand_double_init(seed);
+    return true;
+}
+
+void rand_wreservoir_free(rand_wreservoir_t *res) {
+    free(res->items);
+    free(res->heap);
+    *res = (rand_wreservoir_t){0};
+}
+
+void rand_wreservoir_offer(
+    rand_wreservoir_t *res, const void *items, const double *weights, size_t count
+) {
+    const uint8_t *p = (const uint8_t *)items;
+    const size_t elem = res->elem_size;
+    uint8_t *dst = (uint8_t *)res->items;
+    size_t i = 0;
+
+    for (; i < count && res->count < res->capacity; i++) {
+        const double w = weights[i];
+        if (!(w > 0.0) || !isfinite(w))
+            continue;
+        const size_t slot = res->count++;
+        memcpy(dst + slot * elem, p + i * elem, elem);
+        res->heap[slot].key = log(_stdrand_open01_(&res->rng)) / w;
+        res->heap[slot].slot = slot;
+        _stdrand_wheap_up_(res->heap, slot);
+        if (res->count == res->capacity) {
+            _stdrand_wreservoir_jump_(res);
+        }
+    }
+
+    double skip = res->skip;
+    for (; i < count; i++) {
+        const double w = weights[i];
+        if (!(w > 0.0) || !isfinite(w))
+            continue;
+        skip -= w;
+        if (skip > 0.0)
+            continue;
+
+        const double tw = exp(w * res->heap[0].key);
+        const double r = tw + (1.0 - tw) * _stdrand_open01_(&res->rng);
+        const size_t slot = res->heap[0].slot;
+        memcpy(dst + slot * elem, p + i * elem, elem);
+        res->heap[0].key = log(r) / w;
+        _stdrand_wheap_down_(res->heap, res->capacity, 0);
+        _stdrand_wreservoir_jump_(res);
+        skip = res->skip;
+    }
+    res->skip = skip;
+}
+
+bool rand_wreservoir_merge(rand_wreservoir_t *dst, const rand_wreservoir_t *src) {
+    if (dst->elem_size != src->elem_size || dst->capacity != src->capacity)
+        return false;
+
+    const size_t elem = dst->elem_size;
+    const uint8_t *items = (const uint8_t *)src->items;
+    uint8_t *out = (uint8_t *)dst->items;
+
+    for (size_t i = 0; i < src->count; i++) {
+        const rand_wreservoir_key_t *k = &src->heap[i];
+        if (dst->count < dst->capacity) {
+            const size_t slot = dst->count++;
+            memcpy(out + slot * elem, items + k->slot * elem, elem);
+            dst->heap[slot].key = k->key;
+            dst->heap[slot].slot = slot;
+            _stdrand_wheap_up_(dst->heap, slot);
+        } else if (k->key > dst->heap[0].key) {
+            memcpy(out + dst->heap[0].slot * elem, items + k->slot * elem, elem);
+            dst->heap[0].key = k->key;
+            _stdrand_wheap_down_(dst->heap, dst->capacity, 0);
+        }
+    }
+    if (dst->count == dst->capacity) {
+        _stdrand_wreservoir_jump_(dst);
+    }
+    return true;
+}
+
+/* ===============================================================
+ * AMOSTRAGEM SEM REPOSIÇÃO E PERMUTAÇÕES
+ * ===============================================================
+ * 1. Floyd:
+ * Para j = n-k .. n-1 sorteia t em [0, j]; insere t, ou j se t já
+ * foi escolhido. Cada subconjunto de tamanho k tem a mesma
+ * probabilidade. O conjunto é uma tabela de endereçamento aberto
+ * (chave + 1, zero = vazio) com hash64_int; a saída é ordenada.
+ *
+ * 2. Vitter, Algoritmo D (1987):
+ * Sorteia diretamente o tamanho do salto S até o próximo índice
+ * escolhido, por rejeição contra uma envoltória contínua. Quando
+ * a população restante fica pequena (n <= 13k) usa o Método A
+ * (busca sequencial), mais barato nesse regime. O valor V' aceito
+ * no caminho rápido já tem a distribuição certa para o próximo
+ * passo e é reaproveitado, como no artigo original.
+ *
+ * 3. Feistel com Cycle-Walking:
+ * Rede de Feistel balanceada sobre 2h bits (2^2h >= n, logo o
+ * domínio é < 4n) com hash64_int como função de rodada. Valores
+ * fora de [0, n) são cifrados novamente até caírem no intervalo,
+ * o que preserva a bijeção (em média < 4 iterações).
+ * =============================================================== */
+
+#define _STDRAND_VITTER_ALPHA_ 13.0
+
+static int _stdrand_cmp_u64_(const void *a, const void *b) {
+    const uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Uniforme em (0, 1] com 53 bits. */
+static inline double _stdrand_u01_(rand64_t *rng) {
+    return (double)((rand64_next(rng) >> 11) + 1) * 0x1.0p-53;
+}
+
+bool rand_sample_floyd(rand64_t *rng, uint64_t n, uint64_t k, uint64_t *out) {
+    if (k > n || k > SIZE_MAX / (4 * sizeof(uint64_t)))
+        return false;
+    if (k == 0)
+        return true;
+
+    size_t cap = 16;
+    while (cap < 2 * (size_t)k)
+        cap <<= 1;
+    uint64_t *set = calloc(cap, sizeof(uint64_t));
+    if (!set)
+        return false;
+    const size_t mask = cap - 1;
+
+    size_t count = 0;
+    for (uint64_t j = n - k; j < n; j++) {
+        uint64_t t = rand64_bound(rng, j + 1);
+        size_t h = (size_t)hash64_int(t) & mask;
+        while (set[h] && set[h] != t + 1)
+            h = (h + 1) & mask;
+        if (set[h]) {
+            t = j;
+            h = (size_t)hash64_int(t) & mask;
+            while (set[h])
+                h = (h + 1) & mask;
+        }
+        set[h] = t + 1;
+        out[count++] = t;
+    }
+
+    free(set);
+    qsort(out, count, sizeof(uint64_t), _stdrand_cmp_u64_);
+    return true;
+}
+
+static uint64_t _stdrand_vitter_a_(rand_sample_t *sample) {
+    const double v = (double)(rand64_next(&sample->rng) >> 11) * 0x1.0p-53;
+    double top = (double)(sample->remaining - sample->wanted);
+    double total = (double)sample->remaining;
+    double quot = top / total;
+    uint64_t skip = 0;
+    while (quot > v) {
+        skip++;
+        top -= 1.0;
+        total -= 1.0;
+        quot *= top / total;
+    }
+    return skip;
+}
+
+static uint64_t _stdrand_vitter_d_(rand_sample_t *sample) {
+    const uint64_t big_n = sample->remaining, n = sample->wanted;
+    const double big_nreal = (double)big_n, nreal = (double)n;
+    const double ninv = 1.0 / nreal, nmin1inv = 1.0 / (nreal - 1.0);
+    const uint64_t qu1 = big_n - n + 1;
+    const double qu1real = (double)qu1;
+    double vprime = sample->vprime;
+    uint64_t skip;
+
+    for (;;) {
+        double x;
+        for (;;) {
+            x = big_nreal * (1.0 - vprime);
+            skip = (uint64_t)x;
+            if (skip < qu1)
+                break;
+            vprime = exp(log(_stdrand_u01_(&sample->rng)) * ninv);
+        }
+
+        const double u = _stdrand_u01_(&sample->rng);
+        const double neg_skip = -(double)skip;
+        const double y1 = exp(log(u * big_nreal / qu1real) * nmin1inv);
+        vprime = y1 * (1.0 - x / big_nreal) * (qu1real / (neg_skip + qu1real));
+        if (vprime <= 1.0)
+            break;
+
+        double y2 = 1.0, top = big_nreal - 1.0, bottom;
+        uint64_t limit;
+        if (n - 1 > skip) {
+            bottom = big_nreal - nreal;
+            limit = big_n - skip;
+        } else {
+            bottom = big_nreal + neg_skip - 1.0;
+            limit = qu1;
+        }
+        for (uint64_t t = big_n - 1; t >= limit; t--) {
+            y2 = y2 * top / bottom;
+            top -= 1.0;
+            bottom -= 1.0;
+        }
+        if (big_nreal / (big_nreal - x) >= y1 * exp(log(y2) * nmin1inv)) {
+            vprime = exp(log(_stdrand_u01_(&sample->rng)) * nmin1inv);
+            break;
+        }
+        vprime = exp(log(_stdrand_u01_(&sample->rng)) * ninv);
+    }
+
+    sample->vprime = vprime;
+    return skip;
+}
+
+bool rand_sample_init(rand_sample_t *sample, uint64_t n, uint64_t k, uint64_t seed) {
+    *sample = (rand_sample_t){0};
+    if (k > n)
+        return false;
+    sample->remaining = n;
+    sample->wanted = k;
+    sample->rng = rand64_init(seed);
+    return true;
+}
+
+bool rand_sample_next(rand_sample_t *sample, uint64_t *out) {
+    if (sample->wanted == 0)
+        return false;
+
+    uint64_t skip;
+    if (sample->wanted == 1) {
+        skip = rand64_bound(&sample->rng, sample->remaining);
+    } else if ((double)sample->wanted * _STDRAND_VITTER_ALPHA_ < (double)sample->remaining) {
+        if (!sample->method_d) {
+            sample->vprime = exp(log(_stdrand_u01_(&sample->rng)) / (double)sample->wanted);
+            sample->method_d = true;
+        }
+        skip = _stdrand_vitter_d_(sample);
+    } else {
+        sample->method_d = false;
+        skip = _stdrand_vitter_a_(sample);
+    }
+
+    *out = sample->pos + skip;
+    sample->pos += skip + 1;
+    sample->remaining -= skip + 1;
+    sample->wanted--;
+    return true;
+}
+
+static inline uint64_t _stdrand_perm_round_(const rand_perm_t *perm, uint64_t half, uint64_t key) {
+    return hash64_int(half ^ key) & perm->mask;
+}
+
+static inline uint64_t _stdrand_perm_encrypt_(const rand_perm_t *perm, uint64_t x) {
+    uint64_t left = x >> perm->half, right = x & perm->mask;
+    for (int i = 0; i < RAND_PERM_ROUNDS; i++) {
+        const uint64_t next = left ^ _stdrand_perm_round_(perm, right, perm->key[i]);
+        left = right;
+        right = next;
+    }
+    return (left << perm->half) | right;
+}
+
+static inline uint64_t _stdrand_perm_decrypt_(const rand_perm_t *perm, uint64_t x) {
+    uint64_t left = x >> perm->half, right = x & perm->mask;
+    for (int i = RAND_PERM_ROUNDS - 1; i >= 0; i--) {
+        const uint64_t prev = right ^ _stdrand_perm_round_(perm, left, perm->key[i]);
+        right = left;
+        left = prev;
+    }
+    return (left << perm->half) | right;
+}
+
+bool rand_perm_init(rand_perm_t *perm, uint64_t n, uint64_t seed) {
+    *perm = (rand_perm_t){0};
+    if (n == 0)
+        return false;
+
+    unsigned bits = 0;
+    while (bits < 64 && ((n - 1) >> bits) != 0)
+        bits++;
+    perm->size = n;
+    perm->half = bits < 2 ? 1 : (bits + 1) / 2;
+    perm->mask = (UINT64_C(1) << perm->half) - 1;
+    for (int i = 0; i < RAND_PERM_ROUNDS; i++) {
+        perm->key[i] = _stdrand_splitmix64_next_(&seed);
+    }
+    return true;
+}
+
+uint64_t rand_perm_map(const rand_perm_t *perm, uint64_t index) {
+    /* Fora de [0, n) o ciclo pode nunca voltar ao domínio. */
+    if (index >= perm->size)
+        return index;
+    uint64_t x = index;
+    do {
+        x = _stdrand_perm_encrypt_(perm, x);
+    } while (x >= perm->size);
+    return x;
+}
+
+uint64_t rand_perm_unmap(const rand_perm_t *perm, uint64_t value) {
+    /* Fora de [0, n) o ciclo pode nunca voltar ao domínio. */
+    if (value >= perm->size)
+        return value;
+    uint64_t x = value;
+    do {
+        x = _stdrand_perm_decrypt_(perm, x);
+    } while (x >= perm->size);
+    return x;
+}
+
+/* ===============================================================
+ * MONTE CARLO PARALELO DETERMINÍSTICO
+ * ===============================================================
+ * 1. Fluxo por Tarefa:
+ * O fluxo da tarefa t é rand64_init(hash64_int(hash64_int(seed) +
+ * (t + 1) * φ)). Ambas as camadas são bijeções, então tarefas
+ * distintas sempre recebem sementes distintas; com 256 bits de
+ * estado a sobreposição entre fluxos é desprezível. Custa O(1)
+ * por tarefa, ao contrário de aplicar t vezes rand64_jump.
+ *
+ * 2. Blocos sobre o Thread Pool:
+ * As tarefas são agrupadas em até 65536 blocos contíguos cujo
+ * tamanho depende só de n_tasks. Os blocos são distribuídos com
+ * tpool_parallel_for (work-stealing, stdthrd.h) no pool padrão da
+ * biblioteca, ou num pool próprio fixado por rand_parallel_threads.
+ * Se nenhum pool puder ser criado, tudo roda na thread chamadora.
+ * O pool próprio tem contagem de referências: cada execução segura
+ * uma desde o planejamento até o fim, e rand_parallel_threads só
+ * solta a referência global. O pool antigo é liberado pela última
+ * execução que ainda o usa.
+ *
+ * 3. Reduções Reprodutíveis:
+ * Cada bloco acumula suas tarefas em ordem num slot próprio e os
+ * slots são combinados em ordem de bloco (par a par na soma,
+ * Neumaier na soma compensada). Histogramas contam inteiros, logo
+ * somar os histogramas de cada worker é exato.
+ * =============================================================== */
+
+#define _STDRAND_PAR_BLOCKS_ 65536
+
+typedef enum _stdrand_par_kind {
+    _STDRAND_PAR_FOR_,
+    _STDRAND_PAR_SUM_,
+    _STDRAND_PAR_KAHAN_,
+    _STDRAND_PAR_HIST_,
+} _stdrand_par_kind_t;
+
+typedef struct _stdrand_par {
+    _stdrand_par_kind_t kind;
+    uint64_t n_tasks;
+    uint64_t seed;
+    uint64_t block;
+    uint64_t blocks;
+    rand_task_fn task_fn;
+    rand_value_fn value_fn;
+    void *ctx;
+    double *partial;
+    double *comp;
+    rand_hist_t *hists;
+    struct _stdrand_par_pool *ref;
+    tpool_t *pool;
+    unsigned workers;
+} _stdrand_par_t;
+
+typedef struct _stdrand_par_pool {
+    tpool_t *pool;
+    _Atomic uint32_t refs;
+} _stdrand_par_pool_t;
+
+static _stdrand_par_pool_t *_stdrand_par_pool_;
+static lock_mutex_t _stdrand_par_lock_ = LOCK_MUTEX_INIT;
+
+static void _stdrand_par_pool_release_(_stdrand_par_pool_t *ref) {
+    if (ref && atomic_fetch_sub_explicit(&ref->refs, 1, memory_order_acq_rel) == 1) {
+        tpool_free(ref->pool);
+        free(ref);
+    }
+}
+
+rand64_t rand_parallel_stream(uint64_t seed, uint64_t task) {
+    return rand64_init(hash64_int(hash64_int(seed) + (task + 1) * PHI_INV_HASH_64));
+}
+
+void rand_parallel_threads(unsigned threads) {
+    _stdrand_par_pool_t *ref = threads ? malloc(sizeof(_stdrand_par_pool_t)) : NULL;
+    if (ref) {
+        const tpool_config_t config = {.threads = threads};
+        ref->pool = tpool_init(&config);
+        atomic_init(&ref->refs, 1);
+        if (!ref->pool) {
+            free(ref);
+            ref = NULL;
+        }
+    }
+    lock_mutex_lock(&_stdrand_par_lock_);
+    _stdrand_par_pool_t *old = _stdrand_par_pool_;
+    _stdrand_par_pool_ = ref;
+    lock_mutex_unlock(&_stdrand_par_lock_);
+    _stdrand_par_pool_release_(old);
+}
+
+static inline void _stdrand_neumaier_(double *sum, double *comp, double x) {
+    const double t = *sum + x;
+    if (fabs(*sum) >= fabs(x))
+        *comp += (*sum - t) + x;
+    else
+        *comp += (x - t) + *sum;
+    *sum = t;
+}
+
+static void _stdrand_par_block_(_stdrand_par_t *par, unsigned worker, uint64_t b) {
+    const uint64_t first = b * par->block;
+    const uint64_t last = first + par->block < par->n_tasks ? first + par->block : par->n_tasks;
+    double sum = 0.0, comp = 0.0;
+
+    for (uint64_t t = first; t < last; t++) {
+        rand64_t rng = rand_parallel_stream(par->seed, t);
+        switch (par->kind) {
+        case _STDRAND_PAR_FOR_:
+            par->task_fn(t, &rng, par->ctx);
+            break;
+        case _STDRAND_PAR_SUM_:
+            sum += par->value_fn(t, &rng, par->ctx);
+            break;
+        case _STDRAND_PAR_KAHAN_:
+            _stdrand_neumaier_(&sum, &comp, par->value_fn(t, &rng, par->ctx));
+            break;
+        case _STDRAND_PAR_HIST_:
+            rand_hist_add(&par->hists[worker], par->value_fn(t, &rng, par->ctx));
+            break;
+        }
+    }
+    if (par->partial)
+        par->partial[b] = sum;
+    if (par->comp)
+        par->comp[b] = comp;
+}
+
+static void _stdrand_par_range_(uint64_t begin, uint64_t end, void *ctx) {
+    _stdrand_par_t *par = ctx;
+    const int id = tpool_worker_id(par->pool);
+    const unsigned worker = id < 0 ? 0 : (unsigned)id;
+    for (uint64_t b = begin; b < end; b++) {
+        _stdrand_par_block_(par, worker, b);
+    }
+}
+
+/* Tamanho do bloco (só depende de n_tasks) e pool de execução. A
+ * referência ao pool próprio vale até _stdrand_par_end_. */
+static void _stdrand_par_plan_(_stdrand_par_t *par) {
+    const uint64_t blocks_max = _STDRAND_PAR_BLOCKS_;
+    par->block = (par->n_tasks + blocks_max - 1) / blocks_max;
+    par->blocks = par->n_tasks ? (par->n_tasks + par->block - 1) / par->block : 0;
+    lock_mutex_lock(&_stdrand_par_lock_);
+    par->ref = _stdrand_par_pool_;
+    if (par->ref)
+        atomic_fetch_add_explicit(&par->ref->refs, 1, memory_order_relaxed);
+    lock_mutex_unlock(&_stdrand_par_lock_);
+    par->pool = par->ref ? par->ref->pool : tpool_default();
+    par->workers = tpool_size(par->pool);
+}
+
+static bool _stdrand_par_end_(_stdrand_par_t *par, bool ok) {
+    _stdrand_par_pool_release_(par->ref);
+    par->ref = NULL;
+    return ok;
+}
+
+static bool _stdrand_par_run_(_stdrand_par_t *par) {
+    return tpool_parallel_for(par->pool, par->blocks, 0, _stdrand_par_range_, par);
+}
+
+/* Soma par a par em ordem fixa: erro O(log n) e resultado reprodutível. */
+static double _stdrand_pairwise_(const double *x, uint64_t n) {
+    if (n <= 8) {
+        double sum = 0.0;
+        for (uint64_t i = 0; i < n; i++) {
+            sum += x[i];
+        }
+        return sum;
+    }
+    const uint64_t half = n / 2;
+    return _stdrand_pairwise_(x, half) + _stdrand_pairwise_(x + half, n - half);
+}
+
+bool rand_parallel_for(uint64_t n_tasks, uint64_t seed, rand_task_fn fn, void *ctx) {
+    if (!fn)
+        return false;
+    _stdrand_par_t par = {
+        .kind = _STDRAND_PAR_FOR_, .n_tasks = n_tasks, .seed = seed, .task_fn = fn, .ctx = ctx
+    };
+    _stdrand_par_plan_(&par);
+    return _stdrand_par_end_(&par, _stdrand_par_run_(&par));
+}
+
+bool rand_parallel_sum(uint64_t n_tasks, uint64_t seed, rand_value_fn fn, void *ctx, double *sum) {
+    if (!fn || !sum)
+        return false;
+    _stdrand_par_t par = {
+        .kind = _STDRAND_PAR_SUM_, .n_tasks = n_tasks, .seed = seed, .value_fn = fn, .ctx = ctx
+    };
+    *sum = 0.0;
+    if (n_tasks == 0)
+        return true;
+    _stdrand_par_plan_(&par);
+    par.partial = malloc((size_t)par.blocks * sizeof(double));
+    const bool ok = par.partial && _stdrand_par_run_(&par);
+    if (ok)
+        *sum = _stdrand_pairwise_(par.partial, par.blocks);
+    free(par.partial);
+    return _stdrand_par_end_(&par, ok);
+}
+
+bool rand_parallel_kahan(uint64_t n_tasks, uint64_t seed, rand_value_fn fn, void *ctx, double *sum) {
+    if (!fn || !sum)
+        return false;
+    _stdrand_par_t par = {
+        .kind = _STDRAND_PAR_KAHAN_, .n_tasks = n_tasks, .seed = seed, .value_fn = fn, .ctx = ctx
+    };
+    *sum = 0.0;
+    if (n_tasks == 0)
+        return true;
+    _stdrand_par_plan_(&par);
+    par.partial = malloc((size_t)par.blocks * sizeof(double));
+    par.comp = malloc((size_t)par.blocks * sizeof(double));
+    bool ok = par.partial && par.comp && _stdrand_par_run_(&par);
+    if (ok) {
+        double total = 0.0, comp = 0.0;
+        for (uint64_t b = 0; b < par.blocks; b++) {
+            _stdrand_neumaier_(&total, &comp, par.partial[b]);
+            comp += par.comp[b];
+        }
+        *sum = total + comp;
+    }
+    free(par.comp);
+    free(par.partial);
+    return _stdrand_par_end_(&par, ok);
+}
+
+bool rand_parallel_hist(
+    uint64_t n_tasks, uint64_t seed, rand_value_fn fn, void *ctx, rand_hist_t *hist
+) {
+    if (!fn || !hist || !hist->counts)
+        return false;
+    _stdrand_par_t par = {
+        .kind = _STDRAND_PAR_HIST_, .n_tasks = n_tasks, .seed = seed, .value_fn = fn, .ctx = ctx
+    };
+    _stdrand_par_plan_(&par);
+    par.hists = calloc(par.workers, sizeof(rand_hist_t));
+    if (!par.hists)
+        return _stdrand_par_end_(&par, false);
+    bool ok = true;
+    for (unsigned w = 0; w < par.workers && ok; w++) {
+        ok = rand_hist_init(&par.hists[w], hist->bins, hist->min, hist->max);
+    }
+    ok = ok && _stdrand_par_run_(&par);
+    for (unsigned w = 0; w < par.workers; w++) {
+        if (ok)
+            rand_hist_merge(hist, &par.hists[w]);
+        rand_hist_free(&par.hists[w]);
+    }
+    free(par.hists);
+    return _stdrand_par_end_(&par, ok);
+}
+
+/* ---------------------------------------------------------------
+ * Histograma de largura fixa (contagens exatas, combináveis).
+ * --------------------------------------------------------------- */
+
+bool rand_hist_init(rand_hist_t *hist, size_t bins, double min, double max) {
+    if (!hist || bins == 0 || !(min < max) || !isfinite(max - min))
+        return false;
+    *hist = (rand_hist_t){.bins = bins, .min = min, .max = max};
+    hist->counts = calloc(bins, sizeof(uint64_t));
+    return hist->counts != NULL;
+}
+
+void rand_hist_free(rand_hist_t *hist) {
+    if (!hist)
+        return;
+    free(hist->counts);
+    *hist = (rand_hist_t){0};
+}
+
+void rand_hist_add(rand_hist_t *hist, double value) {
+    if (isnan(value)) {
+        hist->nan++;
+    } else if (value < hist->min) {
+        hist->underflow++;
+    } else if (value >= hist->max) {
+        hist->overflow++;
+    } else {
+        size_t i = (size_t)((value - hist->min) / (hist->max - hist->min) * (double)hist->bins);
+        hist->counts[i < hist->bins ? i : hist->bins - 1]++;
+    }
+}
+
+bool rand_hist_merge(rand_hist_t *dst, const rand_hist_t *src) {
+    if (!dst || !src || dst->bins != src->bins || dst->min != src->min || dst->max != src->max)
+        return false;
+    for (size_t i = 0; i < dst->bins; i++) {
+        dst->counts[i] += src->counts[i];
+    }
+    dst->underflow += src->underflow;
+    dst->overflow += src->overflow;
+    dst->nan += src->nan;
+    return true;
+}
+
+/* ===============================================================
+ * ENTROPIA DO SISTEMA OPERACIONAL (Fallback)
+ * ===============================================================
+ * 1. getrandom (Linux) / getentropy (demais POSIX):
+ * CSPRNG do kernel. Usado quando RDRAND/RDSEED não existem ou
+ * esgotam as tentativas. No Windows apenas o caminho de hardware
+ * está disponível.
+ *
+ * 2. Geração de Fork:
+ * Contador incrementado no processo filho (pthread_atfork).
+ * Buffers de entropia registram o handler (_stdrand_fork_watch_)
+ * antes de guardar bytes e comparam a geração antes de entregá-los,
+ * evitando que pai e filho reutilizem a mesma saída. A leitura da
+ * geração é um único load atômico relaxado.
+ * =============================================================== */
+
+static bool _stdrand_os_fill_(void *buf, size_t size) {
+    uint8_t *p = (uint8_t *)buf;
+#if defined(__linux__)
+    while (size > 0) {
+        const ssize_t r = getrandom(p, size, 0);
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        p += r;
+        size -= (size_t)r;
+    }
+    return true;
+#elif !defined(_WIN32)
+    while (size > 0) {
+        const size_t n = size < 256 ? size : 256;
+        if (getentropy(p, n) != 0)
+            return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+#else
+    (void)p;
+    return size == 0;
+#endif
+}
+
+#if !defined(_WIN32)
+static atomic_uint _stdrand_fork_count_;
+static pthread_once_t _stdrand_fork_once_ = PTHREAD_ONCE_INIT;
+
+static void _stdrand_fork_child_(void) {
+    atomic_fetch_add_explicit(&_stdrand_fork_count_, 1, memory_order_relaxed);
+}
+
+static void _stdrand_fork_register_(void) {
+    pthread_atfork(NULL, NULL, _stdrand_fork_child_);
+}
+#endif
+
+static inline void _stdrand_fork_watch_(void) {
+#if !defined(_WIN32)
+    pthread_once(&_stdrand_fork_once_, _stdrand_fork_register_);
+#endif
+}
+
+static inline unsigned _stdrand_fork_gen_(void) {
+#if !defined(_WIN32)
+    return atomic_load_explicit(&_stdrand_fork_count_, memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
 /* ===============================================================
  * HARDWARE RANDOM (x86-64 ONLY)
  * ===============================================================
@@ -509,28 +1507,643 @@ bool rand64_hw_entropy(uint64_t *out) {
     return false;
 }
 
+/* ===============================================================
+ * LOTES DE HARDWARE (Batch RDRAND)
+ * ===============================================================
+ * Preenche um vetor de palavras com um orçamento curto de
+ * tentativas por palavra. Retorna quantas palavras foram obtidas;
+ * o chamador completa o restante com outra fonte em vez de ficar
+ * preso em _mm_pause sob contenção.
+ *
+ * RDSEED não é usado em lote: sob contenção (ou em VMs) ele falha
+ * na maioria das chamadas e custa centenas de ns mesmo falhando.
+ * =============================================================== */
+
+#define _STDRAND_HW_RETRY_ 16
+
+__STDRAND_ATTR_RDRND__
+static size_t _stdrand_rdrand_fill_(uint64_t *out, size_t count) {
+    if (!_stdrand_has_rdrand_())
+        return 0;
+    for (size_t i = 0; i < count; i++) {
+        int retry = _STDRAND_HW_RETRY_;
+        unsigned long long v;
+        while (!_rdrand64_step(&v)) {
+            if (--retry == 0)
+                return i;
+            _mm_pause();
+        }
+        out[i] = (uint64_t)v;
+    }
+    return count;
+}
+
+/* ===============================================================
+ * POOL DE ENTROPIA (Por Thread)
+ * ===============================================================
+ * Buffer thread-local reabastecido em lote: uma chave de 256 bits
+ * (RDRAND, depois getrandom e, em último caso, RDTSC misturado)
+ * expandida em 16 blocos ChaCha20. São 4 RDRAND por 128 palavras,
+ * e o passo vetorial do kernel ChaCha custa menos que um único
+ * RDRAND por palavra. A chave é apagada após a recarga; cada palavra
+ * é entregue uma única vez e apagada do buffer. Após um fork o
+ * buffer é descartado.
+ * =============================================================== */
+
+#define _STDRAND_POOL_WORDS_ 128
+#define _STDRAND_POOL_KEY_ 4
+
+typedef struct _stdrand_pool {
+    uint64_t word[_STDRAND_POOL_WORDS_];
+    unsigned pos;
+    unsigned gen;
+} _stdrand_pool_t;
+
+static _Thread_local _stdrand_pool_t _stdrand_pool_ = {.pos = _STDRAND_POOL_WORDS_};
+
+static void _stdrand_pool_refill_(_stdrand_pool_t *pool) {
+    /* Constantes "expand 32-byte k", como em _stdrand_chacha_sigma_. */
+    uint32_t in[16] = {0x61707865U, 0x3320646eU, 0x79622d32U, 0x6b206574U};
+    uint64_t key[_STDRAND_POOL_KEY_];
+    _stdrand_fork_watch_();
+    size_t got = _stdrand_rdrand_fill_(key, _STDRAND_POOL_KEY_);
+    if (got < _STDRAND_POOL_KEY_ &&
+        !_stdrand_os_fill_(key + got, (_STDRAND_POOL_KEY_ - got) * sizeof(uint64_t))) {
+        uint64_t state = (uint64_t)__rdtsc();
+        for (; got < _STDRAND_POOL_KEY_; got++) {
+            key[got] = _stdrand_splitmix64_next_(&state) ^ (uint64_t)__rdtsc();
+        }
+    }
+    memcpy(in + 4, key, sizeof(key));
+    rand_chacha_blocks(in, pool->word, _STDRAND_POOL_WORDS_ / 8, RAND_CHACHA_AUTO);
+    memset(key, 0, sizeof(key));
+    memset(in, 0, sizeof(in));
+    pool->pos = 0;
+}
+
+static inline uint64_t _stdrand_pool_next_(void) {
+    _stdrand_pool_t *pool = &_stdrand_pool_;
+    const unsigned gen = _stdrand_fork_gen_();
+    if (pool->pos == _STDRAND_POOL_WORDS_ || pool->gen != gen) {
+        _stdrand_pool_refill_(pool);
+        pool->gen = gen;
+    }
+    const uint64_t v = pool->word[pool->pos];
+    pool->word[pool->pos++] = 0;
+    return v;
+}
+
 /* ===============================================================
  * AUTO SEED (Helper)
  * ===============================================================
- * Tenta obter uma seed de entropia pura (RDSEED). Se falhar usa o
- * contador de ciclos da CPU (RDTSC) como fallback.
+ * Entrega uma seed do pool de entropia por thread. Quatro RDRAND
+ * (ou o fallback) e 16 blocos ChaCha20 rendem 128 seeds, então a
+ * seed custa poucos ns em vez de um RDRAND, sem travar em RDSEED.
+ * Entropia pura, direto do hardware, continua em *_hw_entropy.
  * =============================================================== */
 
 uint32_t rand32_hw_seed(void) {
-    uint32_t seed;
-    if (rand32_hw_entropy(&seed))
-        return seed;
-    if (rand32_hw_fast(&seed))
-        return seed;
-    return (uint32_t)hash64_int((uint64_t)__rdtsc());
+    return (uint32_t)_stdrand_pool_next_();
 }
 
 uint64_t rand64_hw_seed(void) {
-    uint64_t seed;
-    if (rand64_hw_entropy(&seed))
-        return seed;
-    if (rand64_hw_fast(&seed))
-        return seed;
-    return hash64_int((uint64_t)__rdtsc());
+    return _stdrand_pool_next_();
+}
+#endif
+
+/* ===============================================================
+ * PREENCHIMENTO EM MASSA (rand_hw_fill)
+ * ===============================================================
+ * Preenche 'size' bytes com aleatoriedade de hardware (RDRAND em
+ * lotes). Se o hardware não existir ou falhar, completa com o
+ * CSPRNG do sistema operacional. Retorna false apenas se nenhuma
+ * fonte estiver disponível.
+ * =============================================================== */
+
+bool rand_hw_fill(void *buf, size_t size) {
+    uint8_t *p = (uint8_t *)buf;
+#if defined(__x86_64__) || defined(_M_X64)
+    uint64_t block[_STDRAND_POOL_WORDS_];
+    while (size > 0) {
+        const size_t words = (size + 7) / 8 < _STDRAND_POOL_WORDS_ ? (size + 7) / 8
+                                                                   : _STDRAND_POOL_WORDS_;
+        const size_t got = _stdrand_rdrand_fill_(block, words);
+        const size_t bytes = got * 8 < size ? got * 8 : size;
+        memcpy(p, block, bytes);
+        p += bytes;
+        size -= bytes;
+        if (got < words)
+            break;
+    }
+    memset(block, 0, sizeof(block));
+#endif
+    return _stdrand_os_fill_(p, size);
+}
+
+/* ===============================================================
+ * RAND SECURE (Algoritmo: ChaCha20 CSPRNG)
+ * ===============================================================
+ * Gerador criptograficamente seguro para tokens, nonces e chaves.
+ *
+ * 1. Fast Key Erasure (Bernstein):
+ * Cada recarga gera 16 blocos (1 KiB) com a chave atual. Os
+ * primeiros 32 bytes tornam-se a nova chave e são apagados do
+ * buffer; os bytes entregues também são zerados. Comprometer o
+ * estado não revela saídas anteriores.
+ *
+ * 2. Kernels SIMD (x86-64):
+ * Layout "vertical": cada lane de 32 bits processa um bloco
+ * diferente. SSE2 = 4 blocos, AVX2 = 8 e AVX-512 = 16 por passo,
+ * seguidos de transposição para gravar blocos contíguos. O kernel
+ * é escolhido uma única vez via CPUID/XGETBV.
+ *
+ * 3. Reseed:
+ * A cada RAND_SECURE_RESEED bytes (e após fork) entropia nova é
+ * misturada à chave: getrandom, depois RDSEED, depois RDRAND.
+ * =============================================================== */
+
+#define RAND_SECURE_RESEED (1ULL << 20)
+#define _STDRAND_CHACHA_BLOCKS_ (RAND_SECURE_BUFFER / 64)
+
+typedef void (*_stdrand_chacha_fn_)(const uint32_t in[16], uint8_t *out, size_t blocks);
+
+static const uint32_t _stdrand_chacha_sigma_[4] = {
+    0x61707865U, 0x3320646eU, 0x79622d32U, 0x6b206574U};
+
+#define _STDRAND_CHACHA_QR_(x, a, b, c, d, ADD, XOR, R16, R12, R8, R7)                          \
+    x[a] = ADD(x[a], x[b]);                                                                      \
+    x[d] = R16(XOR(x[d], x[a]));                                                                 \
+    x[c] = ADD(x[c], x[d]);                                                                      \
+    x[b] = R12(XOR(x[b], x[c]));                                                                 \
+    x[a] = ADD(x[a], x[b]);                                                                      \
+    x[d] = R8(XOR(x[d], x[a]));                                                                  \
+    x[c] = ADD(x[c], x[d]);                                                                      \
+    x[b] = R7(XOR(x[b], x[c]));
+
+#define _STDRAND_CHACHA_ROUNDS_(x, ADD, XOR, R16, R12, R8, R7)                                  \
+    for (int round = 0; round < 10; round++) {                                                   \
+        _STDRAND_CHACHA_QR_(x, 0, 4, 8, 12, ADD, XOR, R16, R12, R8, R7)                          \
+        _STDRAND_CHACHA_QR_(x, 1, 5, 9, 13, ADD, XOR, R16, R12, R8, R7)                          \
+        _STDRAND_CHACHA_QR_(x, 2, 6, 10, 14, ADD, XOR, R16, R12, R8, R7)                         \
+        _STDRAND_CHACHA_QR_(x, 3, 7, 11, 15, ADD, XOR, R16, R12, R8, R7)                         \
+        _STDRAND_CHACHA_QR_(x, 0, 5, 10, 15, ADD, XOR, R16, R12, R8, R7)                         \
+        _STDRAND_CHACHA_QR_(x, 1, 6, 11, 12, ADD, XOR, R16, R12, R8, R7)                         \
+        _STDRAND_CHACHA_QR_(x, 2, 7, 8, 13, ADD, XOR, R16, R12, R8, R7)                          \
+        _STDRAND_CHACHA_QR_(x, 3, 4, 9, 14, ADD, XOR, R16, R12, R8, R7)                          \
+    }
+
+/* ---------------------------------------------------------------
+ * Kernel Escalar (Referência / Não-x86)
+ * --------------------------------------------------------------- */
+
+#define _S_ADD_(a, b) ((a) + (b))
+#define _S_XOR_(a, b) ((a) ^ (b))
+#define _S_R16_(v) _stdrand_rotl32_(v, 16)
+#define _S_R12_(v) _stdrand_rotl32_(v, 12)
+#define _S_R8_(v) _stdrand_rotl32_(v, 8)
+#define _S_R7_(v) _stdrand_rotl32_(v, 7)
+
+static void _stdrand_chacha_scalar_(const uint32_t in[16], uint8_t *out, size_t blocks) {
+    uint32_t st[16];
+    memcpy(st, in, sizeof(st));
+    for (size_t n = 0; n < blocks; n++, out += 64) {
+        uint32_t x[16];
+        memcpy(x, st, sizeof(x));
+        _STDRAND_CHACHA_ROUNDS_(x, _S_ADD_, _S_XOR_, _S_R16_, _S_R12_, _S_R8_, _S_R7_)
+        for (int j = 0; j < 16; j++) {
+            const uint32_t v = x[j] + st[j];
+            out[4 * j + 0] = (uint8_t)v;
+            out[4 * j + 1] = (uint8_t)(v >> 8);
+            out[4 * j + 2] = (uint8_t)(v >> 16);
+            out[4 * j + 3] = (uint8_t)(v >> 24);
+        }
+        st[12]++;
+    }
+}
+
+#undef _S_ADD_
+#undef _S_XOR_
+#undef _S_R16_
+#undef _S_R12_
+#undef _S_R8_
+#undef _S_R7_
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(__GNUC__) || defined(__clang__)
+#define __STDRAND_ATTR_AVX2__ __attribute__((target("avx2")))
+#define __STDRAND_ATTR_AVX512__ __attribute__((target("avx512f")))
+#define __STDRAND_ATTR_XSAVE__ __attribute__((target("xsave")))
+#else
+#define __STDRAND_ATTR_AVX2__
+#define __STDRAND_ATTR_AVX512__
+#define __STDRAND_ATTR_XSAVE__
+#endif
+
+/* ---------------------------------------------------------------
+ * Kernel SSE2 (4 blocos por passo, baseline x86-64)
+ * --------------------------------------------------------------- */
+
+#define _X4_ADD_(a, b) _mm_add_epi32(a, b)
+#define _X4_XOR_(a, b) _mm_xor_si128(a, b)
+#define _X4_ROT_(v, n) _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+#define _X4_R16_(v) _X4_ROT_(v, 16)
+#define _X4_R12_(v) _X4_ROT_(v, 12)
+#define _X4_R8_(v) _X4_ROT_(v, 8)
+#define _X4_R7_(v) _X4_ROT_(v, 7)
+
+static void _stdrand_chacha_sse2_(const uint32_t in[16], uint8_t *out, size_t blocks) {
+    for (size_t n = 0; n < blocks; n += 4, out += 4 * 64) {
+        __m128i s[16], x[16];
+        for (int j = 0; j < 16; j++) {
+            s[j] = _mm_set1_epi32((int)in[j]);
+        }
+        s[12] = _mm_add_epi32(s[12], _mm_set_epi32((int)n + 3, (int)n + 2, (int)n + 1, (int)n));
+        memcpy(x, s, sizeof(x));
+        _STDRAND_CHACHA_ROUNDS_(x, _X4_ADD_, _X4_XOR_, _X4_R16_, _X4_R12_, _X4_R8_, _X4_R7_)
+        for (int j = 0; j < 16; j++) {
+            x[j] = _mm_add_epi32(x[j], s[j]);
+        }
+        for (int g = 0; g < 4; g++) {
+            const __m128i t0 = _mm_unpacklo_epi32(x[4 * g + 0], x[4 * g + 1]);
+            const __m128i t1 = _mm_unpacklo_epi32(x[4 * g + 2], x[4 * g + 3]);
+            const __m128i t2 = _mm_unpackhi_epi32(x[4 * g + 0], x[4 * g + 1]);
+            const __m128i t3 = _mm_unpackhi_epi32(x[4 * g + 2], x[4 * g + 3]);
+            _mm_storeu_si128((__m128i *)(out + 0 * 64 + 16 * g), _mm_unpacklo_epi64(t0, t1));
+            _mm_storeu_si128((__m128i *)(out + 1 * 64 + 16 * g), _mm_unpackhi_epi64(t0, t1));
+            _mm_storeu_si128((__m128i *)(out + 2 * 64 + 16 * g), _mm_unpacklo_epi64(t2, t3));
+            _mm_storeu_si128((__m128i *)(out + 3 * 64 + 16 * g), _mm_unpackhi_epi64(t2, t3));
+        }
+    }
+}
+
+/* ---------------------------------------------------------------
+ * Kernel AVX2 (8 blocos por passo)
+ * --------------------------------------------------------------- */
+
+#define _X8_ADD_(a, b) _mm256_add_epi32(a, b)
+#define _X8_XOR_(a, b) _mm256_xor_si256(a, b)
+#define _X8_R16_(v) _mm256_shuffle_epi8(v, rot16)
+#define _X8_R12_(v) _mm256_or_si256(_mm256_slli_epi32(v, 12), _mm256_srli_epi32(v, 20))
+#define _X8_R8_(v) _mm256_shuffle_epi8(v, rot8)
+#define _X8_R7_(v) _mm256_or_si256(_mm256_slli_epi32(v, 7), _mm256_srli_epi32(v, 25))
+
+__STDRAND_ATTR_AVX2__
+static void _stdrand_chacha_avx2_(const uint32_t in[16], uint8_t *out, size_t blocks) {
+    const __m256i rot16 = _mm256_set_epi8(
+        13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2, 13, 12, 15, 14, 9, 8, 11, 10, 5, 4,
+        7, 6, 1, 0, 3, 2
+    );
+    const __m256i rot8 = _mm256_set_epi8(
+        14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3, 14, 13, 12, 15, 10, 9, 8, 11, 6, 5,
+        4, 7, 2, 1, 0, 3
+    );
+    for (size_t n = 0; n < blocks; n += 8, out += 8 * 64) {
+        __m256i s[16], x[16], r[4][4];
+        for (int j = 0; j < 16; j++) {
+            s[j] = _mm256_set1_epi32((int)in[j]);
+        }
+        s[12] = _mm256_add_epi32(
+            s[12],
+            _mm256_set_epi32(
+                (int)n + 7, (int)n + 6, (int)n + 5, (int)n + 4, (int)n + 3, (int)n + 2,
+                (int)n + 1, (int)n
+            )
+        );
+        memcpy(x, s, sizeof(x));
+        _STDRAND_CHACHA_ROUNDS_(x, _X8_ADD_, _X8_XOR_, _X8_R16_, _X8_R12_, _X8_R8_, _X8_R7_)
+        for (int j = 0; j < 16; j++) {
+            x[j] = _mm256_add_epi32(x[j], s[j]);
+        }
+        for (int g = 0; g < 4; g++) {
+            const __m256i t0 = _mm256_unpacklo_epi32(x[4 * g + 0], x[4 * g + 1]);
+            const __m256i t1 = _mm256_unpacklo_epi32(x[4 * g + 2], x[4 * g + 3]);
+            const __m256i t2 = _mm256_unpackhi_epi32(x[4 * g + 0], x[4 * g + 1]);
+            const __m256i t3 = _mm256_unpackhi_epi32(x[4 * g + 2], x[4 * g + 3]);
+            r[g][0] = _mm256_unpacklo_epi64(t0, t1);
+            r[g][1] = _mm256_unpackhi_epi64(t0, t1);
+            r[g][2] = _mm256_unpacklo_epi64(t2, t3);
+            r[g][3] = _mm256_unpackhi_epi64(t2, t3);
+        }
+        for (int b = 0; b < 4; b++) {
+            uint8_t *lo = out + b * 64;
+            uint8_t *hi = out + (b + 4) * 64;
+            _mm256_storeu_si256((__m256i *)(lo + 0), _mm256_permute2x128_si256(r[0][b], r[1][b], 0x20));
+            _mm256_storeu_si256((__m256i *)(lo + 32), _mm256_permute2x128_si256(r[2][b], r[3][b], 0x20));
+            _mm256_storeu_si256((__m256i *)(hi + 0), _mm256_permute2x128_si256(r[0][b], r[1][b], 0x31));
+            _mm256_storeu_si256((__m256i *)(hi + 32), _mm256_permute2x128_si256(r[2][b], r[3][b], 0x31));
+        }
+    }
+}
+
+/* ---------------------------------------------------------------
+ * Kernel AVX-512 (16 blocos por passo)
+ * --------------------------------------------------------------- */
+
+#define _X16_ADD_(a, b) _mm512_add_epi32(a, b)
+#define _X16_XOR_(a, b) _mm512_xor_si512(a, b)
+#define _X16_R16_(v) _mm512_rol_epi32(v, 16)
+#define _X16_R12_(v) _mm512_rol_epi32(v, 12)
+#define _X16_R8_(v) _mm512_rol_epi32(v, 8)
+#define _X16_R7_(v) _mm512_rol_epi32(v, 7)
+
+__STDRAND_ATTR_AVX512__
+static void _stdrand_chacha_avx512_(const uint32_t in[16], uint8_t *out, size_t blocks) {
+    for (size_t n = 0; n < blocks; n += 16, out += 16 * 64) {
+        __m512i s[16], x[16], r[4][4];
+        for (int j = 0; j < 16; j++) {
+            s[j] = _mm512_set1_epi32((int)in[j]);
+        }
+        s[12] = _mm512_add_epi32(
+            s[12],
+            _mm512_add_epi32(
+                _mm512_set1_epi32((int)n),
+                _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+            )
+        );
+        memcpy(x, s, sizeof(x));
+        _STDRAND_CHACHA_ROUNDS_(x, _X16_ADD_, _X16_XOR_, _X16_R16_, _X16_R12_, _X16_R8_, _X16_R7_)
+        for (int j = 0; j < 16; j++) {
+            x[j] = _mm512_add_epi32(x[j], s[j]);
+        }
+        for (int g = 0; g < 4; g++) {
+            const __m512i t0 = _mm512_unpacklo_epi32(x[4 * g + 0], x[4 * g + 1]);
+            const __m512i t1 = _mm512_unpacklo_epi32(x[4 * g + 2], x[4 * g + 3]);
+            const __m512i t2 = _mm512_unpackhi_epi32(x[4 * g + 0], x[4 * g + 1]);
+            const __m512i t3 = _mm512_unpackhi_epi32(x[4 * g + 2], x[4 * g + 3]);
+            r[g][0] = _mm512_unpacklo_epi64(t0, t1);
+            r[g][1] = _mm512_unpackhi_epi64(t0, t1);
+            r[g][2] = _mm512_unpacklo_epi64(t2, t3);
+            r[g][3] = _mm512_unpackhi_epi64(t2, t3);
+        }
+        for (int b = 0; b < 4; b++) {
+            const __m512i x0 = _mm512_shuffle_i32x4(r[0][b], r[1][b], _MM_SHUFFLE(1, 0, 1, 0));
+            const __m512i x1 = _mm512_shuffle_i32x4(r[0][b], r[1][b], _MM_SHUFFLE(3, 2, 3, 2));
+            const __m512i x2 = _mm512_shuffle_i32x4(r[2][b], r[3][b], _MM_SHUFFLE(1, 0, 1, 0));
+            const __m512i x3 = _mm512_shuffle_i32x4(r[2][b], r[3][b], _MM_SHUFFLE(3, 2, 3, 2));
+            _mm512_storeu_si512(out + (b + 0) * 64, _mm512_shuffle_i32x4(x0, x2, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm512_storeu_si512(out + (b + 4) * 64, _mm512_shuffle_i32x4(x0, x2, _MM_SHUFFLE(3, 1, 3, 1)));
+            _mm512_storeu_si512(out + (b + 8) * 64, _mm512_shuffle_i32x4(x1, x3, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm512_storeu_si512(out + (b + 12) * 64, _mm512_shuffle_i32x4(x1, x3, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+    }
+}
+
+/* ---------------------------------------------------------------
+ * Seleção de Kernel (CPUID + XGETBV)
+ * ---------------------------------------------------------------
+ * AVX2/AVX-512 exigem suporte da CPU E do sistema operacional
+ * (registradores salvos no contexto, bits de XCR0).
+ * --------------------------------------------------------------- */
+
+__STDRAND_ATTR_XSAVE__
+static unsigned _stdrand_chacha_detect_(void) {
+    const unsigned base = 1u << RAND_CHACHA_SCALAR | 1u << RAND_CHACHA_SSE2;
+    int info[4] = {0};
+#if defined(__GNUC__) || defined(__clang__)
+    __cpuid(0, info[0], info[1], info[2], info[3]);
+#else
+    __cpuid(info, 0);
+#endif
+    if (info[0] < 7)
+        return base;
+#if defined(__GNUC__) || defined(__clang__)
+    __cpuid(1, info[0], info[1], info[2], info[3]);
+#else
+    __cpuid(info, 1);
+#endif
+    if (!(info[2] & (1 << 27)))
+        return base;
+    const uint64_t xcr0 = (uint64_t)_xgetbv(0);
+#if defined(__GNUC__) || defined(__clang__)
+    __cpuid_count(7, 0, info[0], info[1], info[2], info[3]);
+#else
+    __cpuidex(info, 7, 0);
+#endif
+    unsigned caps = base;
+    if ((info[1] & (1 << 5)) && (xcr0 & 0x6) == 0x6)
+        caps |= 1u << RAND_CHACHA_AVX2;
+    if ((info[1] & (1 << 16)) && (xcr0 & 0xe6) == 0xe6)
+        caps |= 1u << RAND_CHACHA_AVX512;
+    return caps;
+}
+#endif
+
+/* Kernels disponíveis, um bit por RAND_CHACHA_*. A detecção é
+ * idempotente: threads que chegam juntas gravam o mesmo valor, então
+ * basta acesso atômico relaxado. */
+static _Atomic unsigned _stdrand_chacha_caps_cache_;
+
+static unsigned _stdrand_chacha_caps_(void) {
+    unsigned caps = atomic_load_explicit(&_stdrand_chacha_caps_cache_, memory_order_relaxed);
+    if (caps)
+        return caps;
+#if defined(__x86_64__) || defined(_M_X64)
+    caps = _stdrand_chacha_detect_();
+#else
+    caps = 1u << RAND_CHACHA_SCALAR;
+#endif
+    atomic_store_explicit(&_stdrand_chacha_caps_cache_, caps, memory_order_relaxed);
+    return caps;
 }
+
+static _stdrand_chacha_fn_ _stdrand_chacha_select_(unsigned kernel, size_t *width) {
+    const unsigned caps = _stdrand_chacha_caps_();
+    if (kernel == RAND_CHACHA_AUTO) {
+        kernel = RAND_CHACHA_SCALAR;
+        while ((caps >> (kernel + 1)) != 0)
+            kernel++;
+    }
+    if (kernel >= 32 || !(caps & (1u << kernel)))
+        return NULL;
+    switch (kernel) {
+#if defined(__x86_64__) || defined(_M_X64)
+    case RAND_CHACHA_SSE2:
+        *width = 4;
+        return _stdrand_chacha_sse2_;
+    case RAND_CHACHA_AVX2:
+        *width = 8;
+        return _stdrand_chacha_avx2_;
+    case RAND_CHACHA_AVX512:
+        *width = 16;
+        return _stdrand_chacha_avx512_;
 #endif
+    default:
+        *width = 1;
+        return _stdrand_chacha_scalar_;
+    }
+}
+
+static _Atomic(_stdrand_chacha_fn_) _stdrand_chacha_kernel_cache_;
+
+static _stdrand_chacha_fn_ _stdrand_chacha_kernel_(void) {
+    _stdrand_chacha_fn_ kernel =
+        atomic_load_explicit(&_stdrand_chacha_kernel_cache_, memory_order_relaxed);
+    if (kernel)
+        return kernel;
+    size_t width;
+    kernel = _stdrand_chacha_select_(RAND_CHACHA_AUTO, &width);
+    atomic_store_explicit(&_stdrand_chacha_kernel_cache_, kernel, memory_order_relaxed);
+    return kernel;
+}
+
+bool rand_chacha_blocks(const uint32_t in[16], void *out, size_t blocks, unsigned kernel) {
+    size_t width = 1;
+    const _stdrand_chacha_fn_ fn = _stdrand_chacha_select_(kernel, &width);
+    if (!fn)
+        return false;
+    uint8_t *dst = out;
+    const size_t bulk = blocks - blocks % width;
+    if (bulk)
+        fn(in, dst, bulk);
+    if (bulk < blocks) {
+        /* Cauda menor que um passo do kernel vetorial. */
+        uint32_t st[16];
+        memcpy(st, in, sizeof(st));
+        st[12] += (uint32_t)bulk;
+        _stdrand_chacha_scalar_(st, dst + 64 * bulk, blocks - bulk);
+        memset(st, 0, sizeof(st));
+    }
+    return true;
+}
+
+/* ---------------------------------------------------------------
+ * Estado, Reseed e Recarga
+ * --------------------------------------------------------------- */
+
+static bool _stdrand_secure_entropy_(uint32_t fresh[8]) {
+    if (_stdrand_os_fill_(fresh, 32))
+        return true;
+#if defined(__x86_64__) || defined(_M_X64)
+    uint64_t w[4];
+    if (rand64_hw_entropy(&w[0]) && rand64_hw_entropy(&w[1]) && rand64_hw_entropy(&w[2]) &&
+        rand64_hw_entropy(&w[3])) {
+        memcpy(fresh, w, 32);
+        memset(w, 0, sizeof(w));
+        return true;
+    }
+    if (_stdrand_rdrand_fill_(w, 4) == 4) {
+        memcpy(fresh, w, 32);
+        memset(w, 0, sizeof(w));
+        return true;
+    }
+#endif
+    return false;
+}
+
+static bool _stdrand_secure_mix_(rand_secure_t *rng) {
+    uint32_t fresh[8] = {0};
+    const bool ok = _stdrand_secure_entropy_(fresh);
+    if (!ok) {
+        uint64_t state = (uint64_t)(uintptr_t)rng ^ (uint64_t)rng->fork_gen;
+#if !defined(_WIN32)
+        state ^= (uint64_t)getpid() << 32;
+#endif
+#if defined(__x86_64__) || defined(_M_X64)
+        state ^= (uint64_t)__rdtsc();
+#endif
+        for (int i = 0; i < 8; i++) {
+            fresh[i] = (uint32_t)_stdrand_splitmix64_next_(&state);
+        }
+    }
+    for (int i = 0; i < 8; i++) {
+        rng->key[i] ^= fresh[i];
+    }
+    memset(fresh, 0, sizeof(fresh));
+    rng->reseed_left = RAND_SECURE_RESEED;
+    return ok;
+}
+
+static void _stdrand_secure_refill_(rand_secure_t *rng) {
+    const unsigned gen = _stdrand_fork_gen_();
+    if (gen != rng->fork_gen || rng->reseed_left == 0) {
+        rng->fork_gen = gen;
+        _stdrand_secure_mix_(rng);
+    }
+
+    uint32_t in[16] = {0};
+    memcpy(in, _stdrand_chacha_sigma_, sizeof(_stdrand_chacha_sigma_));
+    memcpy(in + 4, rng->key, sizeof(rng->key));
+    _stdrand_chacha_kernel_()(in, rng->buf, _STDRAND_CHACHA_BLOCKS_);
+    memset(in, 0, sizeof(in));
+
+    for (int i = 0; i < 8; i++) {
+        const uint8_t *p = rng->buf + 4 * i;
+        rng->key[i] = (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 |
+                      (uint32_t)p[3] << 24;
+    }
+    memset(rng->buf, 0, 32);
+    rng->pos = 32;
+
+    const uint64_t produced = RAND_SECURE_BUFFER - 32;
+    rng->reseed_left = rng->reseed_left > produced ? rng->reseed_left - produced : 0;
+}
+
+static inline bool _stdrand_secure_stale_(const rand_secure_t *rng, size_t need) {
+    return rng->pos + need > RAND_SECURE_BUFFER || rng->fork_gen != _stdrand_fork_gen_();
+}
+
+bool rand_secure_init(rand_secure_t *rng) {
+    memset(rng, 0, sizeof(*rng));
+    _stdrand_fork_watch_();
+    rng->fork_gen = _stdrand_fork_gen_();
+    const bool ok = _stdrand_secure_mix_(rng);
+    rng->pos = RAND_SECURE_BUFFER;
+    return ok;
+}
+
+bool rand_secure_reseed(rand_secure_t *rng) {
+    const bool ok = _stdrand_secure_mix_(rng);
+    memset(rng->buf, 0, sizeof(rng->buf));
+    rng->pos = RAND_SECURE_BUFFER;
+    return ok;
+}
+
+void rand_secure_wipe(rand_secure_t *rng) {
+    volatile uint8_t *p = (volatile uint8_t *)rng;
+    for (size_t i = 0; i < sizeof(*rng); i++) {
+        p[i] = 0;
+    }
+}
+
+uint64_t rand_secure_next(rand_secure_t *rng) {
+    if (_stdrand_secure_stale_(rng, sizeof(uint64_t))) {
+        _stdrand_secure_refill_(rng);
+    }
+    uint64_t v;
+    memcpy(&v, rng->buf + rng->pos, sizeof(v));
+    memset(rng->buf + rng->pos, 0, sizeof(v));
+    rng->pos += sizeof(v);
+    return v;
+}
+
+void rand_secure_fill(rand_secure_t *rng, void *buf, size_t size) {
+    uint8_t *p = (uint8_t *)buf;
+    while (size > 0) {
+        if (_stdrand_secure_stale_(rng, 1)) {
+            _stdrand_secure_refill_(rng);
+        }
+        const size_t avail = RAND_SECURE_BUFFER - rng->pos;
+        const size_t n = size < avail ? size : avail;
+        memcpy(p, rng->buf + rng->pos, n);
+        memset(rng->buf + rng->pos, 0, n);
+        rng->pos += n;
+        p += n;
+        size -= n;
+    }
+}
+
+uint64_t rand_secure_bound(rand_secure_t *rng, uint64_t limit) {
+    uint64_t h;
+    uint64_t l = _stdrand_mul128_(rand_secure_next(rng), limit, &h);
+    if (l < limit) {
+        const uint64_t t = -limit % limit;
+        while (l < t) {
+            l = _stdrand_mul128_(rand_secure_next(rng), limit, &h);
+        }
+    }
+    return h;
+}
+
+uint64_t rand_secure_range(rand_secure_t *rng, uint64_t min, uint64_t max) {
+    return min + rand_secure_bound(rng, max - min);
+}
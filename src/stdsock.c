@@ -0,0 +1,2684 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "stdsock.h"
+#include "stdhash.h"
+#include "stdthrd.h"
+
+#ifndef _WIN32
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <time.h>
+#include <netinet/tcp.h>
+#include <netinet/udp.h>
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#include <linux/errqueue.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/filter.h>
+#include <pthread.h>
+#include <sched.h>
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+#if defined(IORING_RECV_MULTISHOT) && defined(__NR_io_uring_setup)
+#define _STDSOCK_URING_ 1
+#endif
+#endif
+
+/* ===============================================================
+ * CONFIGURAÇÃO DE SOCKETS
+ * ===============================================================
+ * 1. Criação:
+ * SOCK_NONBLOCK | SOCK_CLOEXEC atômicos onde existem (Linux, BSDs);
+ * nos demais, fcntl logo após o socket().
+ *
+ * 2. Backlog:
+ * backlog <= 0 usa o teto do kernel (net.core.somaxconn) em vez do
+ * SOMAXCONN da libc (128 em glibc antigas), que descarta SYNs em
+ * rajadas de conexões.
+ * =============================================================== */
+
+#if defined(SOCK_NONBLOCK) && defined(SOCK_CLOEXEC)
+#define _STDSOCK_SOCK_FLAGS_ (SOCK_NONBLOCK | SOCK_CLOEXEC)
+#else
+#define _STDSOCK_SOCK_FLAGS_ 0
+#endif
+
+#if defined(MSG_NOSIGNAL)
+#define _STDSOCK_SEND_FLAGS_ MSG_NOSIGNAL
+#else
+#define _STDSOCK_SEND_FLAGS_ 0
+#endif
+
+bool net_set_nonblocking(socket_t sock) {
+    const int flags = fcntl(sock, F_GETFL, 0);
+    return flags >= 0 && fcntl(sock, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+bool net_set_nodelay(socket_t sock, bool on) {
+    const int value = on;
+    return setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value)) == 0;
+}
+
+bool net_set_reuseport(socket_t sock, bool on) {
+#if defined(SO_REUSEPORT)
+    const int value = on;
+    return setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &value, sizeof(value)) == 0;
+#else
+    (void)sock;
+    (void)on;
+    return false;
+#endif
+}
+
+static socket_t _stdsock_socket_(int family, int type) {
+    socket_t sock = socket(family, type | _STDSOCK_SOCK_FLAGS_, 0);
+    if (!ISVALIDSOCKET(sock))
+        return INVALID_SOCKET;
+#if !defined(SOCK_NONBLOCK) || !defined(SOCK_CLOEXEC)
+    if (!net_set_nonblocking(sock) || fcntl(sock, F_SETFD, FD_CLOEXEC) != 0) {
+        CLOSESOCKET(sock);
+        return INVALID_SOCKET;
+    }
+#endif
+    return sock;
+}
+
+static int _stdsock_somaxconn_(void) {
+    int backlog = SOMAXCONN;
+#if defined(__linux__)
+    FILE *file = fopen("/proc/sys/net/core/somaxconn", "r");
+    if (file) {
+        int value;
+        if (fscanf(file, "%d", &value) == 1 && value > 0)
+            backlog = value;
+        fclose(file);
+    }
+#endif
+    return backlog;
+}
+
+static struct addrinfo *_stdsock_resolve_(
+    const char *host, uint16_t port, int family, int socktype, bool passive
+) {
+    char service[8];
+    snprintf(service, sizeof(service), "%u", (unsigned)port);
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = family;
+    hints.ai_socktype = socktype;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+    struct addrinfo *list = NULL;
+    return getaddrinfo(host, service, &hints, &list) == 0 ? list : NULL;
+}
+
+socket_t net_listen_tcp(const char *host, uint16_t port, int backlog, unsigned flags) {
+    const int family = host ? AF_UNSPEC : (flags & NET_LISTEN_IPV6) ? AF_INET6 : AF_INET;
+    struct addrinfo *list = _stdsock_resolve_(host, port, family, SOCK_STREAM, true);
+    if (!list)
+        return INVALID_SOCKET;
+    if (backlog <= 0)
+        backlog = _stdsock_somaxconn_();
+
+    socket_t sock = INVALID_SOCKET;
+    for (struct addrinfo *ai = list; ai; ai = ai->ai_next) {
+        sock = _stdsock_socket_(ai->ai_family, ai->ai_socktype);
+        if (!ISVALIDSOCKET(sock))
+            continue;
+        const int one = 1;
+        if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) == 0 &&
+            (!(flags & NET_LISTEN_REUSEPORT) || net_set_reuseport(sock, true)) &&
+            bind(sock, ai->ai_addr, ai->ai_addrlen) == 0 && listen(sock, backlog) == 0) {
+            break;
+        }
+        CLOSESOCKET(sock);
+        sock = INVALID_SOCKET;
+    }
+    freeaddrinfo(list);
+    return sock;
+}
+
+/* Conexão não bloqueante: devolve o socket com o connect em
+ * andamento; o evento de escrita indica que completou (confira
+ * SO_ERROR). */
+socket_t net_connect_tcp(const char *host, uint16_t port) {
+    struct addrinfo *list = _stdsock_resolve_(host, port, AF_UNSPEC, SOCK_STREAM, false);
+    if (!list)
+        return INVALID_SOCKET;
+    socket_t sock = INVALID_SOCKET;
+    for (struct addrinfo *ai = list; ai; ai = ai->ai_next) {
+        sock = _stdsock_socket_(ai->ai_family, ai->ai_socktype);
+        if (!ISVALIDSOCKET(sock))
+            continue;
+        net_set_nodelay(sock, true);
+        if (connect(sock, ai->ai_addr, ai->ai_addrlen) == 0 || errno == EINPROGRESS)
+            break;
+        CLOSESOCKET(sock);
+        sock = INVALID_SOCKET;
+    }
+    freeaddrinfo(list);
+    return sock;
+}
+
+/* INVALID_SOCKET com errno == EAGAIN significa fila de accept vazia. */
+socket_t net_accept(socket_t listener) {
+    socket_t sock;
+    do {
+#if defined(__linux__)
+        sock = accept4(listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+        sock = accept(listener, NULL, NULL);
+#endif
+    } while (!ISVALIDSOCKET(sock) && errno == EINTR);
+    if (!ISVALIDSOCKET(sock))
+        return INVALID_SOCKET;
+#if !defined(__linux__)
+    if (!net_set_nonblocking(sock) || fcntl(sock, F_SETFD, FD_CLOEXEC) != 0) {
+        CLOSESOCKET(sock);
+        return INVALID_SOCKET;
+    }
+#endif
+    net_set_nodelay(sock, true);
+    return sock;
+}
+
+uint16_t net_local_port(socket_t sock) {
+    struct sockaddr_storage addr;
+    socklen_t len = sizeof(addr);
+    if (getsockname(sock, (struct sockaddr *)&addr, &len) != 0)
+        return 0;
+    if (addr.ss_family == AF_INET)
+        return ntohs(((struct sockaddr_in *)&addr)->sin_port);
+    if (addr.ss_family == AF_INET6)
+        return ntohs(((struct sockaddr_in6 *)&addr)->sin6_port);
+    return 0;
+}
+
+static inline ptrdiff_t _stdsock_result_(ssize_t n) {
+    if (n >= 0)
+        return (ptrdiff_t)n;
+    return (errno == EAGAIN || errno == EWOULDBLOCK) ? NET_AGAIN : NET_ERROR;
+}
+
+ptrdiff_t net_recv(socket_t sock, void *buf, size_t size) {
+    ssize_t n;
+    do {
+        n = recv(sock, buf, size, 0);
+    } while (n < 0 && errno == EINTR);
+    return _stdsock_result_(n);
+}
+
+ptrdiff_t net_send(socket_t sock, const void *buf, size_t size) {
+    ssize_t n;
+    do {
+        n = send(sock, buf, size, _STDSOCK_SEND_FLAGS_);
+    } while (n < 0 && errno == EINTR);
+    return _stdsock_result_(n);
+}
+
+/* ===============================================================
+ * ENVIO SEM CÓPIA
+ * ===============================================================
+ * 1. Fallbacks:
+ * EINVAL/ENOSYS/EOPNOTSUPP do sendfile e EINVAL do splice indicam
+ * fd sem suporte (ex.: socket com ULP de TLS); a chamada é refeita
+ * com cópia. Um net_pipe_t que cai para cópia converte o que já
+ * estava no pipe para o buffer e fica nesse modo.
+ *
+ * 2. Notificações de MSG_ZEROCOPY:
+ * Cada send com MSG_ZEROCOPY bem-sucedido recebe do kernel o próximo
+ * número de sequência do socket; a fila de erros devolve intervalos
+ * [lo, hi] concluídos. completed é o primeiro id não concluído e
+ * window marca os concluídos fora de ordem nos 64 seguintes (o
+ * envio limita os pendentes a essa janela). Os ids públicos são
+ * sequência + 1, para que 0 signifique "já concluído".
+ * =============================================================== */
+
+#define _STDSOCK_COPY_CHUNK_ 16384u
+#define _STDSOCK_PIPE_SIZE_ 65536u
+#define _STDSOCK_ZC_MIN_SIZE_ 16384u
+#define _STDSOCK_ZC_WINDOW_ 64u
+#define _STDSOCK_ZC_COPIED_MAX_ 8u
+
+static ptrdiff_t _stdsock_sendfile_copy_(socket_t sock, int fd, uint64_t *offset, size_t count) {
+    unsigned char buf[_STDSOCK_COPY_CHUNK_];
+    ssize_t n;
+    do {
+        n = pread(fd, buf, count < sizeof(buf) ? count : sizeof(buf), (off_t)*offset);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0)
+        return n == 0 ? 0 : NET_ERROR;
+    const ptrdiff_t sent = net_send(sock, buf, (size_t)n);
+    if (sent > 0)
+        *offset += (uint64_t)sent;
+    return sent;
+}
+
+ptrdiff_t net_sendfile(socket_t sock, int fd, uint64_t *offset, size_t count) {
+#if defined(__linux__)
+    off_t pos = (off_t)*offset;
+    ssize_t n;
+    do {
+        n = sendfile(sock, fd, &pos, count);
+    } while (n < 0 && errno == EINTR);
+    if (n >= 0) {
+        *offset = (uint64_t)pos;
+        return (ptrdiff_t)n;
+    }
+    if (errno != EINVAL && errno != ENOSYS && errno != EOPNOTSUPP)
+        return _stdsock_result_(n);
+#endif
+    return _stdsock_sendfile_copy_(sock, fd, offset, count);
+}
+
+/* Modo cópia: buffer linear [head, head + pending). */
+static bool _stdsock_pipe_unpipe_(net_pipe_t *np) {
+    const size_t cap = np->pending > np->cap ? np->pending : np->cap;
+    unsigned char *buf = malloc(cap);
+    if (!buf)
+        return false;
+    for (size_t got = 0; got < np->pending;) {
+        const ssize_t n = read(np->fds[0], buf + got, np->pending - got);
+        if (n == 0 || (n < 0 && errno != EINTR)) {
+            free(buf);
+            return false;
+        }
+        if (n > 0)
+            got += (size_t)n;
+    }
+    if (np->fds[0] >= 0)
+        close(np->fds[0]);
+    if (np->fds[1] >= 0)
+        close(np->fds[1]);
+    np->fds[0] = np->fds[1] = -1;
+    np->buf = buf;
+    np->head = 0;
+    np->cap = cap;
+    return true;
+}
+
+static size_t _stdsock_pipe_space_(net_pipe_t *np) {
+    if (np->head && np->head + np->pending == np->cap) {
+        memmove(np->buf, np->buf + np->head, np->pending);
+        np->head = 0;
+    }
+    return np->cap - np->head - np->pending;
+}
+
+bool net_pipe_init(net_pipe_t *np, size_t capacity) {
+    memset(np, 0, sizeof(*np));
+    np->fds[0] = np->fds[1] = -1;
+    np->cap = capacity ? capacity : _STDSOCK_PIPE_SIZE_;
+#if defined(__linux__)
+    if (pipe2(np->fds, O_NONBLOCK | O_CLOEXEC) == 0) {
+        /* Acima de /proc/sys/fs/pipe-max-size o kernel recusa; o pipe
+         * fica com o tamanho padrão. */
+        if (np->cap <= INT_MAX)
+            fcntl(np->fds[0], F_SETPIPE_SZ, (int)np->cap);
+        return true;
+    }
+#endif
+    return _stdsock_pipe_unpipe_(np);
+}
+
+void net_pipe_free(net_pipe_t *np) {
+    if (np->fds[0] >= 0)
+        close(np->fds[0]);
+    if (np->fds[1] >= 0)
+        close(np->fds[1]);
+    free(np->buf);
+    memset(np, 0, sizeof(*np));
+    np->fds[0] = np->fds[1] = -1;
+}
+
+size_t net_pipe_pending(const net_pipe_t *np) {
+    return np->pending;
+}
+
+ptrdiff_t net_pipe_fill(net_pipe_t *np, socket_t from, size_t count) {
+#if defined(__linux__)
+    if (!np->buf) {
+        ssize_t n;
+        do {
+            n = splice(from, NULL, np->fds[1], NULL, count, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        } while (n < 0 && errno == EINTR);
+        if (n > 0)
+            np->pending += (size_t)n;
+        if (n >= 0 || errno != EINVAL || !_stdsock_pipe_unpipe_(np))
+            return _stdsock_result_(n);
+    }
+#endif
+    const size_t space = _stdsock_pipe_space_(np);
+    if (!space) {
+        errno = EAGAIN;
+        return NET_AGAIN;
+    }
+    const ptrdiff_t n = net_recv(from, np->buf + np->head + np->pending, count < space ? count : space);
+    if (n > 0)
+        np->pending += (size_t)n;
+    return n;
+}
+
+ptrdiff_t net_pipe_drain(net_pipe_t *np, socket_t to, size_t count) {
+    if (count > np->pending)
+        count = np->pending;
+    if (!count)
+        return 0;
+#if defined(__linux__)
+    if (!np->buf) {
+        ssize_t n;
+        do {
+            n = splice(np->fds[0], NULL, to, NULL, count, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        } while (n < 0 && errno == EINTR);
+        if (n > 0)
+            np->pending -= (size_t)n;
+        if (n >= 0 || errno != EINVAL || !_stdsock_pipe_unpipe_(np))
+            return _stdsock_result_(n);
+    }
+#endif
+    const ptrdiff_t n = net_send(to, np->buf + np->head, count);
+    if (n > 0) {
+        np->head += (size_t)n;
+        np->pending -= (size_t)n;
+        if (!np->pending)
+            np->head = 0;
+    }
+    return n;
+}
+
+ptrdiff_t net_pipe_tee(const net_pipe_t *src, net_pipe_t *dst, size_t count) {
+    if (count > src->pending)
+        count = src->pending;
+    if (!count)
+        return 0;
+#if defined(__linux__)
+    if (!src->buf && !dst->buf) {
+        ssize_t n;
+        do {
+            n = tee(src->fds[0], dst->fds[1], count, SPLICE_F_NONBLOCK);
+        } while (n < 0 && errno == EINTR);
+        if (n > 0)
+            dst->pending += (size_t)n;
+        return _stdsock_result_(n);
+    }
+    /* Um pipe do kernel não pode ser lido sem consumir. */
+    if (!src->buf) {
+        errno = EINVAL;
+        return NET_ERROR;
+    }
+#endif
+    if (!dst->buf && !_stdsock_pipe_unpipe_(dst))
+        return NET_ERROR;
+    const size_t space = _stdsock_pipe_space_(dst);
+    if (!space) {
+        errno = EAGAIN;
+        return NET_AGAIN;
+    }
+    if (count > space)
+        count = space;
+    memcpy(dst->buf + dst->head + dst->pending, src->buf + src->head, count);
+    dst->pending += count;
+    return (ptrdiff_t)count;
+}
+
+ptrdiff_t net_splice(socket_t from, socket_t to, net_pipe_t *np, size_t count) {
+    ptrdiff_t sent = 0;
+    if (np->pending) {
+        sent = net_pipe_drain(np, to, count);
+        if (sent < 0 || np->pending || (size_t)sent == count)
+            return sent;
+    }
+    const ptrdiff_t got = net_pipe_fill(np, from, count - (size_t)sent);
+    if (got <= 0)
+        return sent ? sent : got;
+    const ptrdiff_t more = net_pipe_drain(np, to, (size_t)got);
+    if (more < 0)
+        return sent ? sent : more;
+    return sent + more;
+}
+
+bool net_zc_init(net_zc_t *zc, socket_t sock) {
+    memset(zc, 0, sizeof(*zc));
+    zc->sock = sock;
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    const int one = 1;
+    zc->enabled = setsockopt(sock, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0;
+#endif
+    return zc->enabled;
+}
+
+ptrdiff_t net_zc_send(net_zc_t *zc, const void *buf, size_t len, uint32_t *id) {
+    *id = 0;
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    if (zc->enabled && len >= _STDSOCK_ZC_MIN_SIZE_ && zc->next - zc->completed < _STDSOCK_ZC_WINDOW_) {
+        ssize_t n;
+        do {
+            n = send(zc->sock, buf, len, MSG_ZEROCOPY | _STDSOCK_SEND_FLAGS_);
+        } while (n < 0 && errno == EINTR);
+        if (n >= 0) {
+            *id = ++zc->next;
+            return (ptrdiff_t)n;
+        }
+        /* ENOBUFS: limite de optmem para páginas presas; copia. */
+        if (errno != ENOBUFS)
+            return _stdsock_result_(n);
+    }
+#endif
+    return net_send(zc->sock, buf, len);
+}
+
+#if defined(__linux__) && defined(SO_EE_ORIGIN_ZEROCOPY)
+static void _stdsock_zc_complete_(net_zc_t *zc, uint32_t lo, uint32_t hi, bool copied) {
+    for (uint32_t seq = lo;; seq++) {
+        const uint32_t ahead = seq - zc->completed;
+        if (ahead < _STDSOCK_ZC_WINDOW_)
+            zc->window |= UINT64_C(1) << ahead;
+        if (seq == hi)
+            break;
+    }
+    while (zc->window & 1u) {
+        zc->window >>= 1;
+        zc->completed++;
+    }
+    /* O kernel copiou em vez de transmitir as páginas (loopback,
+     * placa sem scatter-gather): zerocopy só acrescentaria as
+     * notificações. */
+    if (!copied)
+        zc->copied = 0;
+    else if (++zc->copied >= _STDSOCK_ZC_COPIED_MAX_)
+        zc->enabled = false;
+}
+#endif
+
+int net_zc_reap(net_zc_t *zc) {
+    int count = 0;
+#if defined(__linux__) && defined(SO_EE_ORIGIN_ZEROCOPY)
+    for (;;) {
+        union {
+            char buf[CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in6))];
+            struct cmsghdr align;
+        } control;
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control.buf;
+        msg.msg_controllen = sizeof(control.buf);
+        ssize_t n;
+        do {
+            n = recvmsg(zc->sock, &msg, MSG_ERRQUEUE | MSG_DONTWAIT);
+        } while (n < 0 && errno == EINTR);
+        if (n < 0)
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? count : NET_ERROR;
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+                !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+                continue;
+            struct sock_extended_err err;
+            memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+            if (err.ee_errno != 0 || err.ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+                continue;
+            _stdsock_zc_complete_(zc, err.ee_info, err.ee_data, err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED);
+            count++;
+        }
+    }
+#else
+    (void)zc;
+    return count;
+#endif
+}
+
+bool net_zc_done(const net_zc_t *zc, uint32_t id) {
+    if (!id)
+        return true;
+    const uint32_t ahead = (id - 1) - zc->completed;
+    if (ahead >= UINT32_C(0x80000000))
+        return true;
+    return ahead < _STDSOCK_ZC_WINDOW_ && (zc->window >> ahead & 1u);
+}
+
+/* ===============================================================
+ * DATAGRAMAS EM LOTE
+ * ===============================================================
+ * 1. Memória do Lote:
+ * Um único bloco por tipo: net_dgram_t[count], mmsghdr[count],
+ * iovec[count], count * _STDSOCK_DGRAM_CONTROL_ bytes de controle e
+ * count * size bytes de dados. Os campos que o kernel reescreve
+ * (msg_namelen, msg_controllen, iov_len) são refeitos a cada
+ * chamada; o resto é só ponteiro.
+ *
+ * 2. Controle:
+ * recv lê UDP_GRO (int), SCM_TIMESTAMPNS (timespec) e SO_RXQ_OVFL
+ * (uint32). send escreve UDP_SEGMENT (uint16) nas mensagens com
+ * segment > 0.
+ *
+ * 3. Fallback:
+ * Sem recvmmsg/sendmmsg (outros SOs), um recvfrom/sendto por
+ * mensagem, sem metadados. Kernel ou placa sem GSO (EIO, EINVAL,
+ * EOPNOTSUPP na mensagem com segment) faz o lote terminar nela, que
+ * é cortada e enviada em datagramas separados.
+ * =============================================================== */
+
+#define _STDSOCK_DGRAM_CONTROL_ 128u
+
+static socket_t _stdsock_udp_open_(const char *host, uint16_t port, unsigned flags, bool bind_side) {
+    const int family = host ? AF_UNSPEC : (flags & NET_LISTEN_IPV6) ? AF_INET6 : AF_INET;
+    struct addrinfo *list = _stdsock_resolve_(host, port, family, SOCK_DGRAM, bind_side);
+    if (!list)
+        return INVALID_SOCKET;
+    socket_t sock = INVALID_SOCKET;
+    for (struct addrinfo *ai = list; ai; ai = ai->ai_next) {
+        sock = _stdsock_socket_(ai->ai_family, ai->ai_socktype);
+        if (!ISVALIDSOCKET(sock))
+            continue;
+        if (bind_side) {
+            if ((!(flags & NET_LISTEN_REUSEPORT) || net_set_reuseport(sock, true)) &&
+                bind(sock, ai->ai_addr, ai->ai_addrlen) == 0)
+                break;
+        } else if (connect(sock, ai->ai_addr, ai->ai_addrlen) == 0) {
+            break;
+        }
+        CLOSESOCKET(sock);
+        sock = INVALID_SOCKET;
+    }
+    freeaddrinfo(list);
+    return sock;
+}
+
+socket_t net_udp_bind(const char *host, uint16_t port, unsigned flags) {
+    return _stdsock_udp_open_(host, port, flags, true);
+}
+
+socket_t net_udp_connect(const char *host, uint16_t port) {
+    return _stdsock_udp_open_(host, port, 0, false);
+}
+
+/* A variante FORCE ignora rmem_max/wmem_max, mas exige
+ * CAP_NET_ADMIN. Devolve o tamanho efetivo (o kernel dobra o pedido
+ * para cobrir o overhead das sk_buff). */
+static int _stdsock_set_buffer_(socket_t sock, int force, int option, int bytes) {
+#if defined(__linux__)
+    if (setsockopt(sock, SOL_SOCKET, force, &bytes, sizeof(bytes)) != 0)
+#else
+    (void)force;
+#endif
+        if (setsockopt(sock, SOL_SOCKET, option, &bytes, sizeof(bytes)) != 0)
+            return -1;
+    int value = 0;
+    socklen_t len = sizeof(value);
+    return getsockopt(sock, SOL_SOCKET, option, &value, &len) == 0 ? value : -1;
+}
+
+int net_set_rcvbuf(socket_t sock, int bytes) {
+#if defined(SO_RCVBUFFORCE)
+    return _stdsock_set_buffer_(sock, SO_RCVBUFFORCE, SO_RCVBUF, bytes);
+#else
+    return _stdsock_set_buffer_(sock, SO_RCVBUF, SO_RCVBUF, bytes);
+#endif
+}
+
+int net_set_sndbuf(socket_t sock, int bytes) {
+#if defined(SO_SNDBUFFORCE)
+    return _stdsock_set_buffer_(sock, SO_SNDBUFFORCE, SO_SNDBUF, bytes);
+#else
+    return _stdsock_set_buffer_(sock, SO_SNDBUF, SO_SNDBUF, bytes);
+#endif
+}
+
+bool net_set_timestamps(socket_t sock, bool on) {
+#if defined(SO_TIMESTAMPNS)
+    const int value = on;
+    return setsockopt(sock, SOL_SOCKET, SO_TIMESTAMPNS, &value, sizeof(value)) == 0;
+#else
+    (void)sock;
+    (void)on;
+    return false;
+#endif
+}
+
+bool net_set_drop_counter(socket_t sock, bool on) {
+#if defined(SO_RXQ_OVFL)
+    const int value = on;
+    return setsockopt(sock, SOL_SOCKET, SO_RXQ_OVFL, &value, sizeof(value)) == 0;
+#else
+    (void)sock;
+    (void)on;
+    return false;
+#endif
+}
+
+bool net_udp_set_gro(socket_t sock, bool on) {
+#if defined(UDP_GRO)
+    const int value = on;
+    return setsockopt(sock, IPPROTO_UDP, UDP_GRO, &value, sizeof(value)) == 0;
+#else
+    (void)sock;
+    (void)on;
+    return false;
+#endif
+}
+
+net_dgram_batch_t *net_dgram_batch_init(unsigned count, size_t size) {
+    if (!count || !size)
+        return NULL;
+    net_dgram_batch_t *batch = calloc(1, sizeof(net_dgram_batch_t));
+    if (!batch)
+        return NULL;
+    batch->count = count;
+    batch->size = size;
+    batch->msgs = calloc(count, sizeof(net_dgram_t));
+    batch->iov = calloc(count, sizeof(struct iovec));
+    batch->buffers = malloc(count * size);
+#if defined(__linux__)
+    batch->hdrs = calloc(count, sizeof(struct mmsghdr));
+    batch->control = malloc(count * _STDSOCK_DGRAM_CONTROL_);
+    if (!batch->hdrs || !batch->control) {
+        net_dgram_batch_free(batch);
+        return NULL;
+    }
+#endif
+    if (!batch->msgs || !batch->iov || !batch->buffers) {
+        net_dgram_batch_free(batch);
+        return NULL;
+    }
+    for (unsigned i = 0; i < count; i++)
+        batch->msgs[i].data = batch->buffers + (size_t)i * size;
+    return batch;
+}
+
+void net_dgram_batch_free(net_dgram_batch_t *batch) {
+    if (!batch)
+        return;
+    free(batch->msgs);
+    free(batch->iov);
+    free(batch->buffers);
+    free(batch->hdrs);
+    free(batch->control);
+    free(batch);
+}
+
+#if defined(__linux__)
+static void _stdsock_dgram_meta_(net_dgram_t *msg, struct msghdr *hdr) {
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(hdr); cmsg; cmsg = CMSG_NXTHDR(hdr, cmsg)) {
+#if defined(UDP_GRO)
+        if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+            int segment;
+            memcpy(&segment, CMSG_DATA(cmsg), sizeof(segment));
+            msg->segment = (uint16_t)segment;
+            continue;
+        }
+#endif
+        if (cmsg->cmsg_level != SOL_SOCKET)
+            continue;
+#if defined(SO_TIMESTAMPNS)
+        if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            struct timespec ts;
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            msg->timestamp_ns = (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+        }
+#endif
+#if defined(SO_RXQ_OVFL)
+        if (cmsg->cmsg_type == SO_RXQ_OVFL)
+            memcpy(&msg->drops, CMSG_DATA(cmsg), sizeof(msg->drops));
+#endif
+    }
+}
+#endif
+
+int net_dgram_recv(socket_t sock, net_dgram_batch_t *batch) {
+#if defined(__linux__)
+    struct mmsghdr *hdrs = batch->hdrs;
+    for (unsigned i = 0; i < batch->count; i++) {
+        net_dgram_t *msg = &batch->msgs[i];
+        msg->data = batch->buffers + (size_t)i * batch->size;
+        batch->iov[i].iov_base = msg->data;
+        batch->iov[i].iov_len = batch->size;
+        struct msghdr *hdr = &hdrs[i].msg_hdr;
+        hdr->msg_name = &msg->addr;
+        hdr->msg_namelen = sizeof(msg->addr);
+        hdr->msg_iov = &batch->iov[i];
+        hdr->msg_iovlen = 1;
+        hdr->msg_control = batch->control + (size_t)i * _STDSOCK_DGRAM_CONTROL_;
+        hdr->msg_controllen = _STDSOCK_DGRAM_CONTROL_;
+        hdr->msg_flags = 0;
+    }
+    int n;
+    do {
+        n = recvmmsg(sock, hdrs, batch->count, MSG_DONTWAIT, NULL);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0)
+        return (int)_stdsock_result_(n);
+    for (int i = 0; i < n; i++) {
+        net_dgram_t *msg = &batch->msgs[i];
+        struct msghdr *hdr = &hdrs[i].msg_hdr;
+        msg->len = hdrs[i].msg_len;
+        msg->addr_len = hdr->msg_namelen;
+        msg->flags = (hdr->msg_flags & MSG_TRUNC) ? NET_DGRAM_TRUNC : 0u;
+        msg->segment = 0;
+        msg->timestamp_ns = 0;
+        _stdsock_dgram_meta_(msg, hdr);
+    }
+    return n;
+#else
+    int n = 0;
+    for (; n < (int)batch->count; n++) {
+        net_dgram_t *msg = &batch->msgs[n];
+        msg->data = batch->buffers + (size_t)n * batch->size;
+        msg->addr_len = sizeof(msg->addr);
+        ssize_t len;
+        do {
+            len = recvfrom(sock, msg->data, batch->size, 0, (struct sockaddr *)&msg->addr, &msg->addr_len);
+        } while (len < 0 && errno == EINTR);
+        if (len < 0)
+            return n ? n : (int)_stdsock_result_(len);
+        msg->len = (size_t)len;
+        msg->segment = 0;
+        msg->flags = 0;
+        msg->timestamp_ns = 0;
+    }
+    return n;
+#endif
+}
+
+/* Um datagrama por sendto; devolve false se nada saiu. */
+static bool _stdsock_dgram_split_(socket_t sock, const net_dgram_t *msg) {
+    const size_t step = msg->segment ? msg->segment : (msg->len ? msg->len : 1);
+    const struct sockaddr *addr = msg->addr_len ? (const struct sockaddr *)&msg->addr : NULL;
+    bool sent = false;
+    for (size_t off = 0; off < msg->len || (!msg->len && !off); off += step) {
+        const size_t len = msg->len - off < step ? msg->len - off : step;
+        ssize_t n;
+        do {
+            n = sendto(sock, (const unsigned char *)msg->data + off, len, _STDSOCK_SEND_FLAGS_, addr, msg->addr_len);
+        } while (n < 0 && errno == EINTR);
+        if (n < 0)
+            break;
+        sent = true;
+        if (!msg->len)
+            break;
+    }
+    return sent;
+}
+
+int net_dgram_send(socket_t sock, net_dgram_batch_t *batch, unsigned count) {
+    if (count > batch->count)
+        count = batch->count;
+#if defined(__linux__)
+    struct mmsghdr *hdrs = batch->hdrs;
+    for (unsigned i = 0; i < count; i++) {
+        net_dgram_t *msg = &batch->msgs[i];
+        batch->iov[i].iov_base = msg->data;
+        batch->iov[i].iov_len = msg->len;
+        struct msghdr *hdr = &hdrs[i].msg_hdr;
+        hdr->msg_name = msg->addr_len ? &msg->addr : NULL;
+        hdr->msg_namelen = msg->addr_len;
+        hdr->msg_iov = &batch->iov[i];
+        hdr->msg_iovlen = 1;
+        hdr->msg_control = NULL;
+        hdr->msg_controllen = 0;
+        hdr->msg_flags = 0;
+#if defined(UDP_SEGMENT)
+        if (msg->segment && msg->len > msg->segment) {
+            hdr->msg_control = batch->control + (size_t)i * _STDSOCK_DGRAM_CONTROL_;
+            hdr->msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+            struct cmsghdr *cmsg = CMSG_FIRSTHDR(hdr);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            memcpy(CMSG_DATA(cmsg), &msg->segment, sizeof(uint16_t));
+        }
+#endif
+    }
+    int n;
+    do {
+        n = sendmmsg(sock, hdrs, count, MSG_DONTWAIT | _STDSOCK_SEND_FLAGS_);
+    } while (n < 0 && errno == EINTR);
+    if (n >= 0)
+        return n;
+    /* sendmmsg só devolve erro se a primeira mensagem falhou. */
+    if (hdrs[0].msg_hdr.msg_control && (errno == EIO || errno == EINVAL || errno == EOPNOTSUPP))
+        return _stdsock_dgram_split_(sock, &batch->msgs[0]) ? 1 : NET_ERROR;
+    return (int)_stdsock_result_(n);
+#else
+    unsigned n = 0;
+    while (n < count && _stdsock_dgram_split_(sock, &batch->msgs[n]))
+        n++;
+    return n ? (int)n : (int)_stdsock_result_(-1);
+#endif
+}
+
+/* ===============================================================
+ * I/O VETORIAL
+ * ===============================================================
+ * sendmsg em vez de writev para poder passar MSG_NOSIGNAL. As
+ * fatias de uma cadeia viram iovecs num vetor na pilha; o que não
+ * couber em _STDSOCK_IOV_MAX_ sai na próxima chamada.
+ * =============================================================== */
+
+#define _STDSOCK_IOV_MAX_ 64
+
+ptrdiff_t net_sendv(socket_t sock, const struct iovec *iov, int count) {
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = (struct iovec *)(uintptr_t)iov;
+    msg.msg_iovlen = (size_t)count;
+    ssize_t n;
+    do {
+        n = sendmsg(sock, &msg, _STDSOCK_SEND_FLAGS_);
+    } while (n < 0 && errno == EINTR);
+    return _stdsock_result_(n);
+}
+
+ptrdiff_t net_recvv(socket_t sock, const struct iovec *iov, int count) {
+    ssize_t n;
+    do {
+        n = readv(sock, iov, count);
+    } while (n < 0 && errno == EINTR);
+    return _stdsock_result_(n);
+}
+
+ptrdiff_t net_send_chain(socket_t sock, mem_chain_t *chain) {
+    if (!chain->count)
+        return 0;
+    struct iovec iov[_STDSOCK_IOV_MAX_];
+    const size_t count = chain->count < _STDSOCK_IOV_MAX_ ? chain->count : _STDSOCK_IOV_MAX_;
+    for (size_t i = 0; i < count; i++) {
+        const mem_slice_t *slice = &chain->slices[chain->head + i];
+        iov[i].iov_base = (void *)(uintptr_t)slice->data;
+        iov[i].iov_len = slice->len;
+    }
+    const ptrdiff_t n = net_sendv(sock, iov, (int)count);
+    if (n > 0)
+        mem_chain_consume(chain, (size_t)n);
+    return n;
+}
+
+ptrdiff_t net_recv_ring(socket_t sock, mem_ring_t *ring) {
+    if (!mem_ring_writable(ring)) {
+        errno = ENOBUFS;
+        return NET_AGAIN;
+    }
+    const ptrdiff_t n = net_recv(sock, mem_ring_write_ptr(ring), mem_ring_writable(ring));
+    if (n > 0)
+        mem_ring_produce(ring, (size_t)n);
+    return n;
+}
+
+ptrdiff_t net_send_ring(socket_t sock, mem_ring_t *ring) {
+    if (!mem_ring_readable(ring))
+        return 0;
+    const ptrdiff_t n = net_send(sock, mem_ring_read_ptr(ring), mem_ring_readable(ring));
+    if (n > 0)
+        mem_ring_consume(ring, (size_t)n);
+    return n;
+}
+
+#if defined(__linux__)
+
+/* ===============================================================
+ * EVENT LOOP
+ * ===============================================================
+ * 1. Lote de Eventos:
+ * Um epoll_wait devolve até max_events prontos. Enquanto o lote é
+ * despachado, net_loop_del anula (data.ptr = NULL) as entradas
+ * restantes do mesmo handle, então liberar a conexão dentro de um
+ * callback é seguro.
+ *
+ * 2. Wakeup:
+ * Um eventfd registrado com data.ptr = loop (sentinela que nunca é
+ * um handle). stop grava a flag e acorda o epoll_wait.
+ *
+ * 3. Timers:
+ * Roda hierárquica (ver TIMERS abaixo). O epoll_wait dorme até o
+ * próximo slot ocupado do nível 0 ou até a próxima cascata.
+ * =============================================================== */
+
+#define _STDSOCK_DEFAULT_EVENTS_ 256u
+#define _STDSOCK_WHEEL_BITS0_ 8u
+#define _STDSOCK_WHEEL_BITS_ 6u
+#define _STDSOCK_WHEEL_LEVELS_ 5u
+#define _STDSOCK_WHEEL_SLOTS0_ (1u << _STDSOCK_WHEEL_BITS0_)
+#define _STDSOCK_WHEEL_SLOTS_ (1u << _STDSOCK_WHEEL_BITS_)
+#define _STDSOCK_WHEEL_TOTAL_ (_STDSOCK_WHEEL_SLOTS0_ + (_STDSOCK_WHEEL_LEVELS_ - 1) * _STDSOCK_WHEEL_SLOTS_)
+#define _STDSOCK_WHEEL_SPAN_ \
+    ((uint64_t)1 << (_STDSOCK_WHEEL_BITS0_ + (_STDSOCK_WHEEL_LEVELS_ - 1) * _STDSOCK_WHEEL_BITS_))
+
+struct net_loop {
+    int epfd;
+    int wakefd;
+    struct epoll_event *events;
+    unsigned max_events;
+    int batch_pos;
+    int batch_count;
+    net_timer_t *wheel[_STDSOCK_WHEEL_TOTAL_];
+    uint64_t occupied[_STDSOCK_WHEEL_SLOTS0_ / 64];
+    uint64_t ticks;
+    unsigned tick_ms;
+    size_t timers;
+    uint64_t now;
+    atomic_bool stop;
+};
+
+static uint64_t _stdsock_clock_ms_(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+static uint32_t _stdsock_epoll_mask_(uint32_t events) {
+    uint32_t mask = EPOLLET | EPOLLRDHUP;
+    if (events & NET_EVENT_READ)
+        mask |= EPOLLIN;
+    if (events & NET_EVENT_WRITE)
+        mask |= EPOLLOUT;
+    return mask;
+}
+
+static uint32_t _stdsock_net_mask_(uint32_t events) {
+    uint32_t mask = 0;
+    if (events & EPOLLIN)
+        mask |= NET_EVENT_READ;
+    if (events & EPOLLOUT)
+        mask |= NET_EVENT_WRITE;
+    if (events & EPOLLERR)
+        mask |= NET_EVENT_ERROR;
+    if (events & (EPOLLHUP | EPOLLRDHUP))
+        mask |= NET_EVENT_CLOSE;
+    return mask;
+}
+
+net_loop_t *net_loop_init(unsigned max_events) {
+    net_loop_t *loop = calloc(1, sizeof(net_loop_t));
+    if (!loop)
+        return NULL;
+    loop->epfd = loop->wakefd = -1;
+    loop->max_events = max_events ? max_events : _STDSOCK_DEFAULT_EVENTS_;
+    if (loop->max_events > INT_MAX)
+        loop->max_events = INT_MAX;
+    loop->events = malloc(loop->max_events * sizeof(struct epoll_event));
+    loop->epfd = epoll_create1(EPOLL_CLOEXEC);
+    loop->wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    atomic_init(&loop->stop, false);
+    loop->now = _stdsock_clock_ms_();
+    loop->tick_ms = 1;
+    loop->ticks = loop->now;
+
+    struct epoll_event ev = {.events = EPOLLIN | EPOLLET, .data.ptr = loop};
+    if (!loop->events || loop->epfd < 0 || loop->wakefd < 0 ||
+        epoll_ctl(loop->epfd, EPOLL_CTL_ADD, loop->wakefd, &ev) != 0) {
+        net_loop_free(loop);
+        return NULL;
+    }
+    return loop;
+}
+
+void net_loop_free(net_loop_t *loop) {
+    if (!loop)
+        return;
+    if (loop->epfd >= 0)
+        close(loop->epfd);
+    if (loop->wakefd >= 0)
+        close(loop->wakefd);
+    free(loop->events);
+    free(loop);
+}
+
+bool net_loop_add(net_loop_t *loop, net_handle_t *handle, uint32_t events) {
+    struct epoll_event ev = {.events = _stdsock_epoll_mask_(events), .data.ptr = handle};
+    return epoll_ctl(loop->epfd, EPOLL_CTL_ADD, handle->fd, &ev) == 0;
+}
+
+bool net_loop_mod(net_loop_t *loop, net_handle_t *handle, uint32_t events) {
+    struct epoll_event ev = {.events = _stdsock_epoll_mask_(events), .data.ptr = handle};
+    return epoll_ctl(loop->epfd, EPOLL_CTL_MOD, handle->fd, &ev) == 0;
+}
+
+void net_loop_del(net_loop_t *loop, net_handle_t *handle) {
+    epoll_ctl(loop->epfd, EPOLL_CTL_DEL, handle->fd, NULL);
+    for (int i = loop->batch_pos; i < loop->batch_count; i++) {
+        if (loop->events[i].data.ptr == handle)
+            loop->events[i].data.ptr = NULL;
+    }
+}
+
+uint64_t net_loop_now(const net_loop_t *loop) {
+    return loop->now;
+}
+
+void net_loop_wakeup(net_loop_t *loop) {
+    const uint64_t one = 1;
+    while (write(loop->wakefd, &one, sizeof(one)) < 0 && errno == EINTR) {
+    }
+}
+
+void net_loop_stop(net_loop_t *loop) {
+    atomic_store_explicit(&loop->stop, true, memory_order_release);
+    net_loop_wakeup(loop);
+}
+
+static void _stdsock_timers_expire_(net_loop_t *loop, int *dispatched);
+static uint64_t _stdsock_wheel_wait_(net_loop_t *loop);
+
+int net_loop_run_once(net_loop_t *loop, int timeout_ms) {
+    loop->now = _stdsock_clock_ms_();
+    if (loop->timers) {
+        const uint64_t wait = _stdsock_wheel_wait_(loop);
+        if (timeout_ms < 0 || wait < (uint64_t)timeout_ms)
+            timeout_ms = wait > INT_MAX ? INT_MAX : (int)wait;
+    }
+
+    int count = epoll_wait(loop->epfd, loop->events, (int)loop->max_events, timeout_ms);
+    if (count < 0) {
+        if (errno != EINTR)
+            return -1;
+        count = 0;
+    }
+    loop->now = _stdsock_clock_ms_();
+
+    int dispatched = 0;
+    loop->batch_count = count;
+    for (loop->batch_pos = 0; loop->batch_pos < count; loop->batch_pos++) {
+        struct epoll_event *ev = &loop->events[loop->batch_pos];
+        if (ev->data.ptr == loop) {
+            uint64_t value;
+            while (read(loop->wakefd, &value, sizeof(value)) < 0 && errno == EINTR) {
+            }
+            continue;
+        }
+        net_handle_t *handle = ev->data.ptr;
+        if (!handle)
+            continue;
+        const uint32_t events = _stdsock_net_mask_(ev->events);
+        const net_io_fn read_fn = handle->on_read ? handle->on_read : handle->on_write;
+        bool wrote = false;
+        if ((events & (NET_EVENT_READ | NET_EVENT_CLOSE | NET_EVENT_ERROR)) && read_fn) {
+            read_fn(loop, handle, events);
+            wrote = read_fn == handle->on_write;
+        }
+        /* O callback de leitura pode ter removido o handle. */
+        if ((events & NET_EVENT_WRITE) && !wrote && ev->data.ptr && handle->on_write)
+            handle->on_write(loop, handle, events);
+        dispatched++;
+    }
+    loop->batch_pos = loop->batch_count = 0;
+
+    _stdsock_timers_expire_(loop, &dispatched);
+    return dispatched;
+}
+
+void net_loop_run(net_loop_t *loop) {
+    while (!atomic_load_explicit(&loop->stop, memory_order_acquire)) {
+        if (net_loop_run_once(loop, -1) < 0)
+            break;
+    }
+    atomic_store_explicit(&loop->stop, false, memory_order_relaxed);
+}
+
+/* ===============================================================
+ * TIMERS (Roda Hierárquica)
+ * ===============================================================
+ * 1. Níveis:
+ * O tempo anda em ticks de tick_ms. O nível 0 tem 256 slots de 1
+ * tick; os níveis 1 a 4 têm 64 slots, cada um 64 vezes mais largo
+ * que os do nível anterior (até 2^32 ticks). Um timer vai para o
+ * nível que cobre a distância até o seu tick e para o slot dado
+ * pelos bits correspondentes do tick: armar, cancelar e rearmar
+ * são um push/unlink O(1) numa lista intrusiva (pprev aponta para
+ * quem aponta para o timer; NULL = inativo).
+ *
+ * 2. Avanço:
+ * ticks é o próximo tick a processar. Cada tick do nível 0 tem seu
+ * slot destacado inteiro e disparado em lote. Quando os 8 bits
+ * baixos voltam a 0, o slot correspondente do nível 1 é
+ * redistribuído (cascata), e assim por diante. occupied marca os
+ * slots do nível 0 que podem estar ocupados (a marca é limpa de
+ * forma preguiçosa), o que permite saltar trechos vazios e calcular
+ * o timeout do epoll_wait sem percorrer listas.
+ *
+ * 3. Precisão:
+ * O tick de um timer é o prazo arredondado para cima, então ele
+ * nunca dispara antes do prazo e atrasa no máximo um tick além da
+ * latência do loop. Prazos além do alcance da roda (2^32 ticks)
+ * ficam no último nível e são reinseridos ao chegar a vez deles.
+ * =============================================================== */
+
+static inline uint64_t _stdsock_wheel_tick_(const net_loop_t *loop, uint64_t deadline) {
+    return loop->tick_ms == 1 ? deadline : (deadline + loop->tick_ms - 1) / loop->tick_ms;
+}
+
+static void _stdsock_wheel_link_(net_loop_t *loop, net_timer_t *timer) {
+    uint64_t expires = _stdsock_wheel_tick_(loop, timer->deadline);
+    if (expires < loop->ticks)
+        expires = loop->ticks;
+    uint64_t delta = expires - loop->ticks;
+    size_t slot;
+    if (delta < _STDSOCK_WHEEL_SLOTS0_) {
+        slot = (size_t)(expires & (_STDSOCK_WHEEL_SLOTS0_ - 1));
+        loop->occupied[slot / 64] |= (uint64_t)1 << (slot % 64);
+    } else {
+        if (delta >= _STDSOCK_WHEEL_SPAN_)
+            expires = loop->ticks + _STDSOCK_WHEEL_SPAN_ - 1;
+        unsigned level = 1, shift = _STDSOCK_WHEEL_BITS0_;
+        while (level < _STDSOCK_WHEEL_LEVELS_ - 1 && (delta >> (shift + _STDSOCK_WHEEL_BITS_)) != 0) {
+            level++;
+            shift += _STDSOCK_WHEEL_BITS_;
+        }
+        slot = _STDSOCK_WHEEL_SLOTS0_ + (level - 1) * _STDSOCK_WHEEL_SLOTS_ +
+               (size_t)((expires >> shift) & (_STDSOCK_WHEEL_SLOTS_ - 1));
+    }
+    net_timer_t **head = &loop->wheel[slot];
+    timer->next = *head;
+    if (*head)
+        (*head)->pprev = &timer->next;
+    timer->pprev = head;
+    *head = timer;
+    loop->timers++;
+}
+
+static void _stdsock_wheel_unlink_(net_loop_t *loop, net_timer_t *timer) {
+    *timer->pprev = timer->next;
+    if (timer->next)
+        timer->next->pprev = timer->pprev;
+    timer->next = NULL;
+    timer->pprev = NULL;
+    loop->timers--;
+}
+
+/* Destaca a lista do slot para a variável do chamador. */
+static void _stdsock_wheel_take_(net_loop_t *loop, size_t slot, net_timer_t **list) {
+    *list = loop->wheel[slot];
+    loop->wheel[slot] = NULL;
+    if (*list)
+        (*list)->pprev = list;
+}
+
+static void _stdsock_wheel_cascade_(net_loop_t *loop, size_t slot) {
+    net_timer_t *list;
+    _stdsock_wheel_take_(loop, slot, &list);
+    while (list) {
+        net_timer_t *timer = list;
+        _stdsock_wheel_unlink_(loop, timer);
+        _stdsock_wheel_link_(loop, timer);
+    }
+}
+
+/* Primeiro tick >= ticks com slot ocupado no bloco de 256 atual, ou
+ * o início do próximo bloco (cascata). */
+static uint64_t _stdsock_wheel_next_(net_loop_t *loop) {
+    const uint64_t base = loop->ticks & ~(uint64_t)(_STDSOCK_WHEEL_SLOTS0_ - 1);
+    for (size_t index = (size_t)(loop->ticks - base); index < _STDSOCK_WHEEL_SLOTS0_;) {
+        const uint64_t bits = loop->occupied[index / 64] >> (index % 64);
+        if (!bits) {
+            index = (index | 63) + 1;
+            continue;
+        }
+        index += (size_t)__builtin_ctzll(bits);
+        if (loop->wheel[index])
+            return base + index;
+        loop->occupied[index / 64] &= ~((uint64_t)1 << (index % 64));
+        index++;
+    }
+    return base + _STDSOCK_WHEEL_SLOTS0_;
+}
+
+static uint64_t _stdsock_wheel_wait_(net_loop_t *loop) {
+    const uint64_t next = (loop->ticks & (_STDSOCK_WHEEL_SLOTS0_ - 1)) ? _stdsock_wheel_next_(loop) : loop->ticks;
+    const uint64_t deadline = next * loop->tick_ms;
+    return deadline > loop->now ? deadline - loop->now : 0;
+}
+
+void net_timer_init(net_timer_t *timer, net_timer_fn fn, void *ctx) {
+    timer->deadline = 0;
+    timer->fn = fn;
+    timer->ctx = ctx;
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+bool net_timer_active(const net_timer_t *timer) {
+    return timer->pprev != NULL;
+}
+
+bool net_timer_start(net_loop_t *loop, net_timer_t *timer, uint64_t timeout_ms) {
+    if (net_timer_active(timer))
+        _stdsock_wheel_unlink_(loop, timer);
+    timer->deadline = loop->now + timeout_ms;
+    _stdsock_wheel_link_(loop, timer);
+    return true;
+}
+
+void net_timer_stop(net_loop_t *loop, net_timer_t *timer) {
+    if (net_timer_active(timer))
+        _stdsock_wheel_unlink_(loop, timer);
+}
+
+bool net_loop_set_tick(net_loop_t *loop, unsigned tick_ms) {
+    if (loop->timers || tick_ms == 0)
+        return false;
+    loop->tick_ms = tick_ms;
+    loop->ticks = loop->now / tick_ms;
+    return true;
+}
+
+/* Processa os ticks até o atual. Um timer rearmado com timeout 0
+ * dentro do callback cai no slot do tick seguinte, não no lote que
+ * está sendo disparado. */
+static void _stdsock_timers_expire_(net_loop_t *loop, int *dispatched) {
+    const uint64_t target = loop->now / loop->tick_ms;
+    while (loop->ticks <= target) {
+        if (!loop->timers) {
+            loop->ticks = target + 1;
+            return;
+        }
+        const uint64_t tick = loop->ticks;
+        if ((tick & (_STDSOCK_WHEEL_SLOTS0_ - 1)) == 0) {
+            size_t slot = _STDSOCK_WHEEL_SLOTS0_;
+            for (unsigned shift = _STDSOCK_WHEEL_BITS0_; slot < _STDSOCK_WHEEL_TOTAL_;
+                 shift += _STDSOCK_WHEEL_BITS_, slot += _STDSOCK_WHEEL_SLOTS_) {
+                const size_t index = (size_t)((tick >> shift) & (_STDSOCK_WHEEL_SLOTS_ - 1));
+                _stdsock_wheel_cascade_(loop, slot + index);
+                if (index)
+                    break;
+            }
+        }
+        const uint64_t next = _stdsock_wheel_next_(loop);
+        if (next != tick) {
+            loop->ticks = next < target + 1 ? next : target + 1;
+            continue;
+        }
+        net_timer_t *batch;
+        const size_t slot = (size_t)(tick & (_STDSOCK_WHEEL_SLOTS0_ - 1));
+        _stdsock_wheel_take_(loop, slot, &batch);
+        loop->occupied[slot / 64] &= ~((uint64_t)1 << (slot % 64));
+        loop->ticks = tick + 1;
+        while (batch) {
+            net_timer_t *timer = batch;
+            _stdsock_wheel_unlink_(loop, timer);
+            if (_stdsock_wheel_tick_(loop, timer->deadline) > tick) {
+                _stdsock_wheel_link_(loop, timer);
+                continue;
+            }
+            timer->fn(loop, timer);
+            (*dispatched)++;
+        }
+    }
+}
+
+/* ===============================================================
+ * I/O ASSÍNCRONO (net_aio_t)
+ * ===============================================================
+ * 1. Estados do Pedido:
+ * IDLE (livre), ACTIVE (no kernel ou na tabela de fds do epoll),
+ * QUEUED (fila de prontos), LINKED (espera o antecessor da cadeia),
+ * STARVED (recv sem buffer livre) e DONE (conclusão sintética, ex.:
+ * cancelamento, entregue pela fila de prontos para que nenhum
+ * callback rode dentro de outra chamada da API).
+ *
+ * 2. io_uring:
+ * SQ/CQ mapeados com syscalls diretas (sem liburing). user_data é o
+ * ponteiro do pedido; 0 marca operações internas (cancelamentos),
+ * cujas conclusões são descartadas. Os buffers do recv vêm de um
+ * anel registrado (IORING_REGISTER_PBUF_RING, grupo 0): devolver um
+ * buffer é um store release no tail do anel, sem syscall. Kernels
+ * sem multishot (EINVAL) passam a rearmar accept/recv a cada
+ * conclusão; kernels sem anel de buffers ou sem EXT_ARG usam o
+ * fallback epoll.
+ *
+ * 3. Fallback epoll:
+ * Tabela indexada por fd com o pedido de entrada (accept/recv) e a
+ * fila de sends esperando EPOLLOUT (mantém a ordem dos dados). Os
+ * eventos só movem pedidos para a fila de prontos; a fila executa
+ * as syscalls até EAGAIN. Cadeias (NET_AIO_LINK) ficam penduradas
+ * em req->link e só entram na fila quando o antecessor conclui.
+ * =============================================================== */
+
+enum {
+    _STDSOCK_AIO_ACCEPT_ = 1,
+    _STDSOCK_AIO_RECV_,
+    _STDSOCK_AIO_SEND_,
+    _STDSOCK_AIO_READ_,
+    _STDSOCK_AIO_WRITE_,
+    _STDSOCK_AIO_CLOSE_,
+    _STDSOCK_AIO_WAKE_,
+};
+
+enum {
+    _STDSOCK_AIO_IDLE_ = 0,
+    _STDSOCK_AIO_ACTIVE_,
+    _STDSOCK_AIO_QUEUED_,
+    _STDSOCK_AIO_LINKED_,
+    _STDSOCK_AIO_STARVED_,
+    _STDSOCK_AIO_DONE_,
+};
+
+#define _STDSOCK_AIO_ENTRIES_ 256u
+#define _STDSOCK_AIO_BUFFERS_ 256u
+#define _STDSOCK_AIO_BUFFER_SIZE_ 4096u
+#define _STDSOCK_AIO_MAX_BUFFERS_ 32768u
+#define _STDSOCK_AIO_EVENTS_ 64
+#define _STDSOCK_AIO_BUDGET_ 1024u
+#define _STDSOCK_AIO_CANCEL_ 0x80000000u
+
+typedef struct _stdsock_aio_fd {
+    net_aio_req_t *in;
+    net_aio_req_t *out;
+    uint32_t mask;
+} _stdsock_aio_fd_t;
+
+struct net_aio {
+    net_aio_backend_t backend;
+    uint64_t syscalls;
+    atomic_bool stop;
+    int wakefd;
+    uint64_t wake_value;
+    net_aio_req_t wake;
+
+    net_aio_req_t *ready_head;
+    net_aio_req_t *ready_tail;
+    net_aio_req_t *starved;
+    net_aio_req_t *chain;
+
+    unsigned char *buffers;
+    size_t buffers_size;
+    unsigned buffer_count;
+    unsigned buffer_size;
+    struct iovec *fixed;
+    unsigned fixed_count;
+
+#if defined(_STDSOCK_URING_)
+    int ring_fd;
+    bool sqpoll;
+    bool oneshot;
+    unsigned char *ring;
+    size_t ring_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+    _Atomic unsigned *sq_head;
+    _Atomic unsigned *sq_tail;
+    _Atomic unsigned *sq_flags;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned sq_local;
+    _Atomic unsigned *cq_head;
+    _Atomic unsigned *cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe *cqes;
+    struct io_uring_buf_ring *buf_ring;
+    size_t buf_ring_size;
+    uint16_t buf_tail;
+#endif
+
+    int epfd;
+    _stdsock_aio_fd_t *fds;
+    size_t fd_cap;
+    unsigned *free_ids;
+    unsigned free_count;
+    struct epoll_event events[_STDSOCK_AIO_EVENTS_];
+};
+
+static inline void *_stdsock_aio_buffer_(const net_aio_t *aio, unsigned id) {
+    return aio->buffers + (size_t)id * aio->buffer_size;
+}
+
+static void _stdsock_aio_push_(net_aio_t *aio, net_aio_req_t *req) {
+    req->next = NULL;
+    if (aio->ready_tail)
+        aio->ready_tail->next = req;
+    else
+        aio->ready_head = req;
+    aio->ready_tail = req;
+}
+
+/* Remove req de uma lista simples; atualiza *tail se for o último. */
+static void _stdsock_aio_unlink_(net_aio_req_t **head, net_aio_req_t **tail, net_aio_req_t *req) {
+    net_aio_req_t *prev = NULL;
+    for (net_aio_req_t *it = *head; it; prev = it, it = it->next) {
+        if (it != req)
+            continue;
+        if (prev)
+            prev->next = it->next;
+        else
+            *head = it->next;
+        if (tail && *tail == it)
+            *tail = prev;
+        it->next = NULL;
+        return;
+    }
+}
+
+static void _stdsock_aio_defer_(net_aio_t *aio, net_aio_req_t *req, int64_t res) {
+    req->state = _STDSOCK_AIO_DONE_;
+    req->result = res;
+    _stdsock_aio_push_(aio, req);
+}
+
+static bool _stdsock_aio_success_(const net_aio_req_t *req, int64_t res) {
+    if (res < 0)
+        return false;
+    switch (req->op) {
+    case _STDSOCK_AIO_SEND_:
+    case _STDSOCK_AIO_READ_:
+    case _STDSOCK_AIO_WRITE_:
+        return (uint64_t)res == req->len;
+    default:
+        return true;
+    }
+}
+
+static inline void _stdsock_aio_emit_(net_aio_t *aio, net_aio_req_t *req, int64_t res, void *buf) {
+    const net_aio_event_t ev = {res, buf, NET_AIO_MORE};
+    req->fn(aio, req, &ev);
+}
+
+static void _stdsock_aio_launch_(net_aio_t *aio, net_aio_req_t *req);
+
+/* Conclusão final: libera o pedido antes do callback (que pode
+ * reusá-lo) e só depois decide o destino do sucessor da cadeia. */
+static void _stdsock_aio_finish_(net_aio_t *aio, net_aio_req_t *req, int64_t res, void *buf) {
+    net_aio_req_t *next = req->link;
+    const bool ok = _stdsock_aio_success_(req, res);
+    req->link = NULL;
+    req->state = _STDSOCK_AIO_IDLE_;
+    if (aio->chain == req)
+        aio->chain = NULL;
+    const net_aio_event_t ev = {res, buf, 0};
+    req->fn(aio, req, &ev);
+    if (!next)
+        return;
+    if (ok)
+        _stdsock_aio_launch_(aio, next);
+    else
+        _stdsock_aio_finish_(aio, next, -ECANCELED, NULL);
+}
+
+/* ===============================================================
+ * io_uring
+ * =============================================================== */
+
+#if defined(_STDSOCK_URING_)
+
+static struct io_uring_sqe *_stdsock_uring_sqe_(net_aio_t *aio);
+static int _stdsock_uring_enter_(net_aio_t *aio, bool wait, int timeout_ms);
+
+static int _stdsock_aio_fixed_(const net_aio_t *aio, const void *buf, size_t len) {
+    const uintptr_t ptr = (uintptr_t)buf;
+    for (unsigned i = 0; i < aio->fixed_count; i++) {
+        const uintptr_t base = (uintptr_t)aio->fixed[i].iov_base;
+        const size_t size = aio->fixed[i].iov_len;
+        if (ptr >= base && len <= size && ptr - base <= size - len)
+            return (int)i;
+    }
+    return -1;
+}
+
+static bool _stdsock_uring_prep_(net_aio_t *aio, net_aio_req_t *req) {
+    struct io_uring_sqe *sqe = _stdsock_uring_sqe_(aio);
+    if (!sqe)
+        return false;
+    sqe->fd = req->fd;
+    sqe->user_data = (uint64_t)(uintptr_t)req;
+    switch (req->op) {
+    case _STDSOCK_AIO_ACCEPT_:
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+        if (!aio->oneshot)
+            sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        break;
+    case _STDSOCK_AIO_RECV_:
+        sqe->opcode = IORING_OP_RECV;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = 0;
+        if (!aio->oneshot)
+            sqe->ioprio = IORING_RECV_MULTISHOT;
+        break;
+    case _STDSOCK_AIO_SEND_:
+        sqe->opcode = IORING_OP_SEND;
+        sqe->addr = (uint64_t)(uintptr_t)req->buf;
+        sqe->len = (uint32_t)req->len;
+        sqe->msg_flags = MSG_NOSIGNAL;
+        break;
+    case _STDSOCK_AIO_READ_:
+    case _STDSOCK_AIO_WRITE_: {
+        const bool reading = req->op == _STDSOCK_AIO_READ_;
+        const int index = _stdsock_aio_fixed_(aio, req->buf, req->len);
+        if (index >= 0) {
+            sqe->opcode = reading ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+            sqe->buf_index = (uint16_t)index;
+        } else {
+            sqe->opcode = reading ? IORING_OP_READ : IORING_OP_WRITE;
+        }
+        sqe->addr = (uint64_t)(uintptr_t)req->buf;
+        sqe->len = (uint32_t)req->len;
+        sqe->off = req->offset;
+        break;
+    }
+    case _STDSOCK_AIO_CLOSE_:
+        sqe->opcode = IORING_OP_CLOSE;
+        break;
+    case _STDSOCK_AIO_WAKE_:
+        sqe->opcode = IORING_OP_READ;
+        sqe->addr = (uint64_t)(uintptr_t)&aio->wake_value;
+        sqe->len = sizeof(aio->wake_value);
+        sqe->off = UINT64_MAX;
+        break;
+    default:
+        break;
+    }
+    if (req->flags & NET_AIO_LINK)
+        sqe->flags |= IOSQE_IO_LINK;
+    req->state = _STDSOCK_AIO_ACTIVE_;
+    return true;
+}
+
+/* Com o SQ cheio, submete o que há; com SQPOLL, espera a thread do
+ * kernel abrir espaço. */
+static struct io_uring_sqe *_stdsock_uring_sqe_(net_aio_t *aio) {
+    if (aio->sq_local - atomic_load_explicit(aio->sq_head, memory_order_acquire) >= aio->sq_entries) {
+        _stdsock_uring_enter_(aio, false, 0);
+        if (aio->sqpoll) {
+            aio->syscalls++;
+            syscall(__NR_io_uring_enter, aio->ring_fd, 0u, 0u, IORING_ENTER_SQ_WAIT, NULL, (size_t)0);
+        }
+        if (aio->sq_local - atomic_load_explicit(aio->sq_head, memory_order_acquire) >= aio->sq_entries)
+            return NULL;
+    }
+    struct io_uring_sqe *sqe = &aio->sqes[aio->sq_local++ & aio->sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+/* Publica o tail do SQ e entra no kernel só se houver o que submeter
+ * (sem SQPOLL), a thread do SQPOLL dormiu, o CQ transbordou ou o
+ * chamador quer esperar conclusões. */
+static int _stdsock_uring_enter_(net_aio_t *aio, bool wait, int timeout_ms) {
+    atomic_store_explicit(aio->sq_tail, aio->sq_local, memory_order_release);
+    const unsigned submit = aio->sq_local - atomic_load_explicit(aio->sq_head, memory_order_acquire);
+    unsigned flags = 0;
+    if (aio->sqpoll) {
+        atomic_thread_fence(memory_order_seq_cst);
+        if (submit && (atomic_load_explicit(aio->sq_flags, memory_order_relaxed) & IORING_SQ_NEED_WAKEUP))
+            flags |= IORING_ENTER_SQ_WAKEUP;
+    }
+    if (wait || (atomic_load_explicit(aio->sq_flags, memory_order_relaxed) & IORING_SQ_CQ_OVERFLOW))
+        flags |= IORING_ENTER_GETEVENTS;
+    if (!flags && (!submit || aio->sqpoll))
+        return 0;
+
+    struct __kernel_timespec ts;
+    struct io_uring_getevents_arg arg;
+    const void *argp = NULL;
+    size_t argsz = 0;
+    if (wait && timeout_ms >= 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (long long)(timeout_ms % 1000) * 1000000;
+        memset(&arg, 0, sizeof(arg));
+        arg.ts = (uint64_t)(uintptr_t)&ts;
+        argp = &arg;
+        argsz = sizeof(arg);
+        flags |= IORING_ENTER_EXT_ARG;
+    }
+    aio->syscalls++;
+    const long ret = syscall(
+        __NR_io_uring_enter, aio->ring_fd, submit, wait ? 1u : 0u, flags, argp, argsz
+    );
+    if (ret < 0 && errno != ETIME && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        return -1;
+    return 0;
+}
+
+static inline void _stdsock_uring_provide_(net_aio_t *aio, unsigned id) {
+    struct io_uring_buf *slot = &aio->buf_ring->bufs[aio->buf_tail & (aio->buffer_count - 1)];
+    slot->addr = (uint64_t)(uintptr_t)_stdsock_aio_buffer_(aio, id);
+    slot->len = aio->buffer_size;
+    slot->bid = (uint16_t)id;
+    aio->buf_tail++;
+}
+
+static inline void _stdsock_uring_publish_(net_aio_t *aio) {
+    atomic_store_explicit((_Atomic uint16_t *)&aio->buf_ring->tail, aio->buf_tail, memory_order_release);
+}
+
+/* accept/recv continuam armados enquanto houver conclusões com
+ * resultado positivo; um multishot que terminou sozinho (CQ cheio,
+ * kernel sem suporte) é rearmado aqui. */
+static bool _stdsock_uring_complete_(net_aio_t *aio, net_aio_req_t *req, int32_t res, uint32_t flags) {
+    if (req == &aio->wake) {
+        _stdsock_uring_prep_(aio, req);
+        return false;
+    }
+    void *buf = (flags & IORING_CQE_F_BUFFER) ? _stdsock_aio_buffer_(aio, flags >> IORING_CQE_BUFFER_SHIFT)
+                                              : NULL;
+    if (flags & IORING_CQE_F_MORE) {
+        _stdsock_aio_emit_(aio, req, res, buf);
+        return true;
+    }
+    const bool multishot = req->op == _STDSOCK_AIO_ACCEPT_ || req->op == _STDSOCK_AIO_RECV_;
+    if (multishot && !(req->flags & _STDSOCK_AIO_CANCEL_)) {
+        if (res == -ENOBUFS) {
+            req->state = _STDSOCK_AIO_STARVED_;
+            req->next = aio->starved;
+            aio->starved = req;
+            return false;
+        }
+        if (res == -EINVAL && !aio->oneshot) {
+            aio->oneshot = true;
+            if (_stdsock_uring_prep_(aio, req))
+                return false;
+        }
+        if ((res > 0 || (res == 0 && req->op == _STDSOCK_AIO_ACCEPT_)) && _stdsock_uring_prep_(aio, req)) {
+            _stdsock_aio_emit_(aio, req, res, buf);
+            return true;
+        }
+    }
+    _stdsock_aio_finish_(aio, req, res, buf);
+    return true;
+}
+
+static int _stdsock_uring_reap_(net_aio_t *aio) {
+    int dispatched = 0;
+    unsigned head = atomic_load_explicit(aio->cq_head, memory_order_relaxed);
+    const unsigned tail = atomic_load_explicit(aio->cq_tail, memory_order_acquire);
+    while (head != tail) {
+        const struct io_uring_cqe *cqe = &aio->cqes[head & aio->cq_mask];
+        const uint64_t data = cqe->user_data;
+        const int32_t res = cqe->res;
+        const uint32_t flags = cqe->flags;
+        atomic_store_explicit(aio->cq_head, ++head, memory_order_release);
+        if (data && _stdsock_uring_complete_(aio, (net_aio_req_t *)(uintptr_t)data, res, flags))
+            dispatched++;
+    }
+    return dispatched;
+}
+
+static void _stdsock_uring_close_(net_aio_t *aio) {
+    if (aio->ring_fd >= 0)
+        close(aio->ring_fd);
+    if (aio->ring)
+        munmap(aio->ring, aio->ring_size);
+    if (aio->sqes)
+        munmap(aio->sqes, aio->sqes_size);
+    if (aio->buf_ring)
+        munmap(aio->buf_ring, aio->buf_ring_size);
+    aio->ring_fd = -1;
+    aio->ring = NULL;
+    aio->sqes = NULL;
+    aio->buf_ring = NULL;
+}
+
+static int _stdsock_uring_setup_(unsigned entries, struct io_uring_params *params) {
+    int fd = (int)syscall(__NR_io_uring_setup, entries, params);
+    if (fd < 0 && (params->flags & IORING_SETUP_COOP_TASKRUN)) {
+        params->flags &= ~IORING_SETUP_COOP_TASKRUN;
+        fd = (int)syscall(__NR_io_uring_setup, entries, params);
+    }
+    return fd;
+}
+
+static bool _stdsock_uring_init_(net_aio_t *aio, const net_aio_config_t *config) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = config->entries * 4;
+    if (config->sqpoll) {
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = 50;
+    } else {
+        params.flags |= IORING_SETUP_COOP_TASKRUN;
+    }
+    aio->syscalls++;
+    aio->ring_fd = _stdsock_uring_setup_(config->entries, &params);
+    const unsigned features = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+    if (aio->ring_fd < 0 || (params.features & features) != features)
+        return false;
+    aio->sqpoll = config->sqpoll;
+
+    const size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    const size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    aio->ring_size = sq_size > cq_size ? sq_size : cq_size;
+    void *ring = mmap(
+        NULL, aio->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, aio->ring_fd,
+        (off_t)IORING_OFF_SQ_RING
+    );
+    aio->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(
+        NULL, aio->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, aio->ring_fd,
+        (off_t)IORING_OFF_SQES
+    );
+    aio->ring = ring == MAP_FAILED ? NULL : ring;
+    aio->sqes = sqes == MAP_FAILED ? NULL : sqes;
+    if (!aio->ring || !aio->sqes)
+        return false;
+
+    unsigned char *base = aio->ring;
+    aio->sq_head = (_Atomic unsigned *)(base + params.sq_off.head);
+    aio->sq_tail = (_Atomic unsigned *)(base + params.sq_off.tail);
+    aio->sq_flags = (_Atomic unsigned *)(base + params.sq_off.flags);
+    aio->sq_mask = *(unsigned *)(base + params.sq_off.ring_mask);
+    aio->sq_entries = params.sq_entries;
+    aio->cq_head = (_Atomic unsigned *)(base + params.cq_off.head);
+    aio->cq_tail = (_Atomic unsigned *)(base + params.cq_off.tail);
+    aio->cq_mask = *(unsigned *)(base + params.cq_off.ring_mask);
+    aio->cqes = (struct io_uring_cqe *)(base + params.cq_off.cqes);
+    /* Mapeamento identidade: a entrada i do array aponta a SQE i. */
+    unsigned *array = (unsigned *)(base + params.sq_off.array);
+    for (unsigned i = 0; i < params.sq_entries; i++)
+        array[i] = i;
+    aio->sq_local = atomic_load_explicit(aio->sq_tail, memory_order_relaxed);
+
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    aio->buf_ring_size = (aio->buffer_count * sizeof(struct io_uring_buf) + page - 1) & ~(page - 1);
+    void *buf_ring = mmap(NULL, aio->buf_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf_ring == MAP_FAILED)
+        return false;
+    aio->buf_ring = buf_ring;
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)buf_ring;
+    reg.ring_entries = aio->buffer_count;
+    reg.bgid = 0;
+    aio->syscalls++;
+    if (syscall(__NR_io_uring_register, aio->ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0)
+        return false;
+    for (unsigned id = 0; id < aio->buffer_count; id++)
+        _stdsock_uring_provide_(aio, id);
+    _stdsock_uring_publish_(aio);
+
+    /* eventfd bloqueante: um READ em fd O_NONBLOCK voltaria EAGAIN
+     * em vez de esperar no kernel. */
+    aio->wakefd = eventfd(0, EFD_CLOEXEC);
+    if (aio->wakefd < 0)
+        return false;
+    aio->wake.op = _STDSOCK_AIO_WAKE_;
+    aio->wake.fd = aio->wakefd;
+    return _stdsock_uring_prep_(aio, &aio->wake) && _stdsock_uring_enter_(aio, false, 0) == 0;
+}
+
+#endif
+
+/* ===============================================================
+ * FALLBACK epoll
+ * =============================================================== */
+
+static _stdsock_aio_fd_t *_stdsock_epoll_fd_(net_aio_t *aio, int fd) {
+    if (fd < 0)
+        return NULL;
+    if ((size_t)fd >= aio->fd_cap) {
+        size_t cap = aio->fd_cap ? aio->fd_cap * 2 : 64;
+        while (cap <= (size_t)fd)
+            cap *= 2;
+        _stdsock_aio_fd_t *fds = realloc(aio->fds, cap * sizeof(_stdsock_aio_fd_t));
+        if (!fds)
+            return NULL;
+        memset(fds + aio->fd_cap, 0, (cap - aio->fd_cap) * sizeof(_stdsock_aio_fd_t));
+        aio->fds = fds;
+        aio->fd_cap = cap;
+    }
+    return &aio->fds[fd];
+}
+
+/* Interesse registrado = pedidos pendentes no fd. Sem nenhum, o fd
+ * sai do epoll, então fechá-lo depois não deixa registro órfão. */
+static bool _stdsock_epoll_watch_(net_aio_t *aio, int fd, _stdsock_aio_fd_t *entry) {
+    uint32_t want = 0;
+    if (entry->in || entry->out)
+        want = EPOLLIN | EPOLLRDHUP | EPOLLET | (entry->out ? EPOLLOUT : 0u);
+    if (want == entry->mask)
+        return true;
+    struct epoll_event ev = {.events = want, .data.fd = fd};
+    aio->syscalls++;
+    if (!want) {
+        epoll_ctl(aio->epfd, EPOLL_CTL_DEL, fd, NULL);
+        entry->mask = 0;
+        return true;
+    }
+    int op = entry->mask ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    int ret = epoll_ctl(aio->epfd, op, fd, &ev);
+    if (ret != 0 && (errno == ENOENT || errno == EEXIST)) {
+        op = op == EPOLL_CTL_ADD ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+        aio->syscalls++;
+        ret = epoll_ctl(aio->epfd, op, fd, &ev);
+    }
+    entry->mask = ret == 0 ? want : 0;
+    return ret == 0;
+}
+
+static void _stdsock_epoll_detach_(net_aio_t *aio, net_aio_req_t *req) {
+    if (req->fd < 0 || (size_t)req->fd >= aio->fd_cap)
+        return;
+    _stdsock_aio_fd_t *entry = &aio->fds[req->fd];
+    if (entry->in == req)
+        entry->in = NULL;
+    _stdsock_aio_unlink_(&entry->out, NULL, req);
+    _stdsock_epoll_watch_(aio, req->fd, entry);
+}
+
+static void _stdsock_epoll_input_(net_aio_t *aio, net_aio_req_t *req) {
+    const bool accepting = req->op == _STDSOCK_AIO_ACCEPT_;
+    _stdsock_aio_fd_t *entry = _stdsock_epoll_fd_(aio, req->fd);
+    if (!entry || (entry->in && entry->in != req)) {
+        _stdsock_aio_finish_(aio, req, entry ? -EBUSY : -ENOMEM, NULL);
+        return;
+    }
+    entry->in = req;
+    req->state = _STDSOCK_AIO_ACTIVE_;
+    for (;;) {
+        int64_t res;
+        void *buf = NULL;
+        unsigned id = 0;
+        aio->syscalls++;
+        if (accepting) {
+            res = accept4(req->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        } else {
+            if (!aio->free_count) {
+                req->state = _STDSOCK_AIO_STARVED_;
+                req->next = aio->starved;
+                aio->starved = req;
+                return;
+            }
+            id = aio->free_ids[--aio->free_count];
+            buf = _stdsock_aio_buffer_(aio, id);
+            res = recv(req->fd, buf, aio->buffer_size, 0);
+        }
+        if (res < 0)
+            res = -errno;
+        if (res > 0 || (res == 0 && accepting)) {
+            _stdsock_aio_emit_(aio, req, res, buf);
+            if (req->state != _STDSOCK_AIO_ACTIVE_)
+                return;
+            continue;
+        }
+        if (buf)
+            aio->free_ids[aio->free_count++] = id;
+        if (res == -EINTR || res == -ECONNABORTED)
+            continue;
+        entry = &aio->fds[req->fd];
+        if (res == -EAGAIN || res == -EWOULDBLOCK) {
+            if (_stdsock_epoll_watch_(aio, req->fd, entry))
+                return;
+            res = -errno;
+        }
+        entry->in = NULL;
+        _stdsock_epoll_watch_(aio, req->fd, entry);
+        _stdsock_aio_finish_(aio, req, res, NULL);
+        return;
+    }
+}
+
+/* Um send só tenta escrever se nenhum outro do mesmo fd espera
+ * EPOLLOUT; senão entra no fim da fila do fd. */
+static void _stdsock_epoll_send_(net_aio_t *aio, net_aio_req_t *req) {
+    _stdsock_aio_fd_t *entry = _stdsock_epoll_fd_(aio, req->fd);
+    if (!entry) {
+        _stdsock_aio_finish_(aio, req, -ENOMEM, NULL);
+        return;
+    }
+    req->state = _STDSOCK_AIO_ACTIVE_;
+    req->next = NULL;
+    if (entry->out) {
+        net_aio_req_t *last = entry->out;
+        while (last->next)
+            last = last->next;
+        last->next = req;
+        return;
+    }
+    ssize_t n;
+    do {
+        aio->syscalls++;
+        n = send(req->fd, req->buf, req->len, MSG_NOSIGNAL | MSG_DONTWAIT);
+    } while (n < 0 && errno == EINTR);
+    int64_t res = n >= 0 ? (int64_t)n : -errno;
+    if (res == -EAGAIN || res == -EWOULDBLOCK) {
+        entry->out = req;
+        if (_stdsock_epoll_watch_(aio, req->fd, entry))
+            return;
+        res = -errno;
+        entry->out = NULL;
+    }
+    _stdsock_epoll_watch_(aio, req->fd, entry);
+    _stdsock_aio_finish_(aio, req, res, NULL);
+}
+
+/* Pedidos pendentes no fd terminam com -ECANCELED antes do close,
+ * para que o callback do close possa liberar a conexão. */
+static void _stdsock_epoll_close_(net_aio_t *aio, net_aio_req_t *req) {
+    if (req->fd >= 0 && (size_t)req->fd < aio->fd_cap) {
+        _stdsock_aio_fd_t *entry = &aio->fds[req->fd];
+        net_aio_req_t *in = entry->in;
+        net_aio_req_t *out = entry->out;
+        entry->in = entry->out = NULL;
+        _stdsock_epoll_watch_(aio, req->fd, entry);
+        if (in) {
+            if (in->state == _STDSOCK_AIO_QUEUED_)
+                _stdsock_aio_unlink_(&aio->ready_head, &aio->ready_tail, in);
+            else if (in->state == _STDSOCK_AIO_STARVED_)
+                _stdsock_aio_unlink_(&aio->starved, NULL, in);
+            _stdsock_aio_finish_(aio, in, -ECANCELED, NULL);
+        }
+        while (out) {
+            net_aio_req_t *next = out->next;
+            out->next = NULL;
+            _stdsock_aio_finish_(aio, out, -ECANCELED, NULL);
+            out = next;
+        }
+    }
+    aio->syscalls++;
+    const int ret = close(req->fd);
+    _stdsock_aio_finish_(aio, req, ret == 0 ? 0 : -errno, NULL);
+}
+
+static void _stdsock_epoll_run_(net_aio_t *aio, net_aio_req_t *req) {
+    switch (req->op) {
+    case _STDSOCK_AIO_ACCEPT_:
+    case _STDSOCK_AIO_RECV_:
+        _stdsock_epoll_input_(aio, req);
+        break;
+    case _STDSOCK_AIO_SEND_:
+        _stdsock_epoll_send_(aio, req);
+        break;
+    case _STDSOCK_AIO_READ_:
+    case _STDSOCK_AIO_WRITE_: {
+        ssize_t n;
+        do {
+            aio->syscalls++;
+            if (req->op == _STDSOCK_AIO_READ_)
+                n = req->offset == UINT64_MAX ? read(req->fd, req->buf, req->len)
+                                              : pread(req->fd, req->buf, req->len, (off_t)req->offset);
+            else
+                n = req->offset == UINT64_MAX ? write(req->fd, req->buf, req->len)
+                                              : pwrite(req->fd, req->buf, req->len, (off_t)req->offset);
+        } while (n < 0 && errno == EINTR);
+        _stdsock_aio_finish_(aio, req, n >= 0 ? (int64_t)n : -errno, NULL);
+        break;
+    }
+    case _STDSOCK_AIO_CLOSE_:
+        _stdsock_epoll_close_(aio, req);
+        break;
+    default:
+        break;
+    }
+}
+
+static void _stdsock_epoll_dispatch_(net_aio_t *aio, const struct epoll_event *ev) {
+    if (ev->data.fd == aio->wakefd) {
+        uint64_t value;
+        while (read(aio->wakefd, &value, sizeof(value)) < 0 && errno == EINTR) {
+        }
+        return;
+    }
+    if (ev->data.fd < 0 || (size_t)ev->data.fd >= aio->fd_cap)
+        return;
+    _stdsock_aio_fd_t *entry = &aio->fds[ev->data.fd];
+    net_aio_req_t *in = entry->in;
+    if ((ev->events & (EPOLLIN | EPOLLERR | EPOLLHUP | EPOLLRDHUP)) && in &&
+        in->state == _STDSOCK_AIO_ACTIVE_) {
+        in->state = _STDSOCK_AIO_QUEUED_;
+        _stdsock_aio_push_(aio, in);
+    }
+    /* A fila inteira volta aos prontos, em ordem; quem achar EAGAIN
+     * de novo reconstrói a fila do fd. */
+    if ((ev->events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) && entry->out) {
+        net_aio_req_t *out = entry->out;
+        entry->out = NULL;
+        while (out) {
+            net_aio_req_t *next = out->next;
+            out->state = _STDSOCK_AIO_QUEUED_;
+            _stdsock_aio_push_(aio, out);
+            out = next;
+        }
+    }
+}
+
+static bool _stdsock_epoll_init_(net_aio_t *aio) {
+    aio->free_ids = malloc(aio->buffer_count * sizeof(unsigned));
+    aio->epfd = epoll_create1(EPOLL_CLOEXEC);
+    aio->wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (!aio->free_ids || aio->epfd < 0 || aio->wakefd < 0)
+        return false;
+    for (unsigned id = aio->buffer_count; id-- > 0;)
+        aio->free_ids[aio->free_count++] = id;
+    struct epoll_event ev = {.events = EPOLLIN | EPOLLET, .data.fd = aio->wakefd};
+    aio->syscalls++;
+    return epoll_ctl(aio->epfd, EPOLL_CTL_ADD, aio->wakefd, &ev) == 0;
+}
+
+/* ===============================================================
+ * API
+ * =============================================================== */
+
+static void _stdsock_aio_launch_(net_aio_t *aio, net_aio_req_t *req) {
+#if defined(_STDSOCK_URING_)
+    if (aio->backend == NET_AIO_URING) {
+        if (!_stdsock_uring_prep_(aio, req))
+            _stdsock_aio_defer_(aio, req, -EBUSY);
+        return;
+    }
+#endif
+    req->state = _STDSOCK_AIO_QUEUED_;
+    _stdsock_aio_push_(aio, req);
+}
+
+static unsigned _stdsock_aio_pow2_(unsigned value) {
+    unsigned pow2 = 1;
+    while (pow2 < value)
+        pow2 <<= 1;
+    return pow2;
+}
+
+net_aio_t *net_aio_init(const net_aio_config_t *config) {
+    net_aio_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    if (config)
+        cfg = *config;
+    if (!cfg.entries)
+        cfg.entries = _STDSOCK_AIO_ENTRIES_;
+    if (!cfg.buffers)
+        cfg.buffers = _STDSOCK_AIO_BUFFERS_;
+    if (cfg.buffers > _STDSOCK_AIO_MAX_BUFFERS_)
+        cfg.buffers = _STDSOCK_AIO_MAX_BUFFERS_;
+    if (!cfg.buffer_size)
+        cfg.buffer_size = _STDSOCK_AIO_BUFFER_SIZE_;
+
+    net_aio_t *aio = calloc(1, sizeof(net_aio_t));
+    if (!aio)
+        return NULL;
+    aio->epfd = aio->wakefd = -1;
+    atomic_init(&aio->stop, false);
+    aio->buffer_count = _stdsock_aio_pow2_(cfg.buffers);
+    aio->buffer_size = cfg.buffer_size;
+    aio->buffers_size = (size_t)aio->buffer_count * aio->buffer_size;
+    void *buffers = mmap(NULL, aio->buffers_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffers == MAP_FAILED) {
+        free(aio);
+        return NULL;
+    }
+    aio->buffers = buffers;
+
+#if defined(_STDSOCK_URING_)
+    aio->ring_fd = -1;
+    if (cfg.backend != NET_AIO_EPOLL) {
+        if (_stdsock_uring_init_(aio, &cfg)) {
+            aio->backend = NET_AIO_URING;
+            return aio;
+        }
+        _stdsock_uring_close_(aio);
+        if (aio->wakefd >= 0)
+            close(aio->wakefd);
+        aio->wakefd = -1;
+    }
+#endif
+    if (cfg.backend == NET_AIO_URING || !_stdsock_epoll_init_(aio)) {
+        net_aio_free(aio);
+        return NULL;
+    }
+    aio->backend = NET_AIO_EPOLL;
+    return aio;
+}
+
+void net_aio_free(net_aio_t *aio) {
+    if (!aio)
+        return;
+#if defined(_STDSOCK_URING_)
+    _stdsock_uring_close_(aio);
+#endif
+    if (aio->epfd >= 0)
+        close(aio->epfd);
+    if (aio->wakefd >= 0)
+        close(aio->wakefd);
+    if (aio->buffers)
+        munmap(aio->buffers, aio->buffers_size);
+    free(aio->fds);
+    free(aio->free_ids);
+    free(aio->fixed);
+    free(aio);
+}
+
+net_aio_backend_t net_aio_backend(const net_aio_t *aio) {
+    return aio->backend;
+}
+
+uint64_t net_aio_syscalls(const net_aio_t *aio) {
+    return aio->syscalls;
+}
+
+bool net_aio_register_buffers(net_aio_t *aio, const struct iovec *iov, unsigned count) {
+    struct iovec *copy = NULL;
+    if (count) {
+        copy = malloc(count * sizeof(struct iovec));
+        if (!copy)
+            return false;
+        memcpy(copy, iov, count * sizeof(struct iovec));
+    }
+#if defined(_STDSOCK_URING_)
+    if (aio->backend == NET_AIO_URING) {
+        if (aio->fixed_count) {
+            aio->syscalls++;
+            syscall(__NR_io_uring_register, aio->ring_fd, IORING_UNREGISTER_BUFFERS, NULL, 0);
+            aio->fixed_count = 0;
+        }
+        aio->syscalls++;
+        if (count && syscall(__NR_io_uring_register, aio->ring_fd, IORING_REGISTER_BUFFERS, iov, count) != 0) {
+            free(copy);
+            return false;
+        }
+    }
+#endif
+    free(aio->fixed);
+    aio->fixed = copy;
+    aio->fixed_count = count;
+    return true;
+}
+
+void net_aio_buffer_release(net_aio_t *aio, void *buf) {
+    const unsigned id = (unsigned)((size_t)((unsigned char *)buf - aio->buffers) / aio->buffer_size);
+#if defined(_STDSOCK_URING_)
+    if (aio->backend == NET_AIO_URING) {
+        _stdsock_uring_provide_(aio, id);
+        _stdsock_uring_publish_(aio);
+    } else
+#endif
+        aio->free_ids[aio->free_count++] = id;
+    /* recv parados por falta de buffer voltam a rodar. */
+    while (aio->starved) {
+        net_aio_req_t *req = aio->starved;
+        aio->starved = req->next;
+        _stdsock_aio_launch_(aio, req);
+    }
+}
+
+static bool _stdsock_aio_start_(
+    net_aio_t *aio, net_aio_req_t *req, uint32_t op, int fd, void *buf, size_t len, uint64_t offset,
+    unsigned flags, net_aio_fn fn, void *ctx
+) {
+    if (req->state != _STDSOCK_AIO_IDLE_)
+        return false;
+    req->fn = fn;
+    req->ctx = ctx;
+    req->fd = fd;
+    req->flags = flags & NET_AIO_LINK;
+    req->buf = buf;
+    req->len = len > UINT32_MAX ? UINT32_MAX : len;
+    req->offset = offset;
+    req->result = 0;
+    req->op = op;
+    req->next = req->link = NULL;
+#if defined(_STDSOCK_URING_)
+    if (aio->backend == NET_AIO_URING)
+        return _stdsock_uring_prep_(aio, req);
+#endif
+    if (aio->chain) {
+        aio->chain->link = req;
+        req->state = _STDSOCK_AIO_LINKED_;
+    } else {
+        req->state = _STDSOCK_AIO_QUEUED_;
+        _stdsock_aio_push_(aio, req);
+    }
+    aio->chain = (req->flags & NET_AIO_LINK) ? req : NULL;
+    return true;
+}
+
+bool net_aio_accept(net_aio_t *aio, net_aio_req_t *req, socket_t listener, net_aio_fn fn, void *ctx) {
+    return _stdsock_aio_start_(aio, req, _STDSOCK_AIO_ACCEPT_, listener, NULL, 0, 0, 0, fn, ctx);
+}
+
+bool net_aio_recv(net_aio_t *aio, net_aio_req_t *req, socket_t sock, net_aio_fn fn, void *ctx) {
+    return _stdsock_aio_start_(aio, req, _STDSOCK_AIO_RECV_, sock, NULL, 0, 0, 0, fn, ctx);
+}
+
+bool net_aio_send(
+    net_aio_t *aio, net_aio_req_t *req, socket_t sock, const void *buf, size_t len, unsigned flags,
+    net_aio_fn fn, void *ctx
+) {
+    return _stdsock_aio_start_(aio, req, _STDSOCK_AIO_SEND_, sock, (void *)buf, len, 0, flags, fn, ctx);
+}
+
+bool net_aio_read(
+    net_aio_t *aio, net_aio_req_t *req, int fd, void *buf, size_t len, uint64_t offset,
+    unsigned flags, net_aio_fn fn, void *ctx
+) {
+    return _stdsock_aio_start_(aio, req, _STDSOCK_AIO_READ_, fd, buf, len, offset, flags, fn, ctx);
+}
+
+bool net_aio_write(
+    net_aio_t *aio, net_aio_req_t *req, int fd, const void *buf, size_t len, uint64_t offset,
+    unsigned flags, net_aio_fn fn, void *ctx
+) {
+    return _stdsock_aio_start_(aio, req, _STDSOCK_AIO_WRITE_, fd, (void *)buf, len, offset, flags, fn, ctx);
+}
+
+bool net_aio_close(net_aio_t *aio, net_aio_req_t *req, int fd, net_aio_fn fn, void *ctx) {
+    return _stdsock_aio_start_(aio, req, _STDSOCK_AIO_CLOSE_, fd, NULL, 0, 0, 0, fn, ctx);
+}
+
+/* io_uring: o kernel entrega -ECANCELED (ou a conclusão que já
+ * estava a caminho). Nos demais casos o pedido é retirado na hora e
+ * -ECANCELED chega na próxima iteração. Elos de cadeia ainda não
+ * iniciados não são canceláveis isoladamente. */
+bool net_aio_cancel(net_aio_t *aio, net_aio_req_t *req) {
+    switch (req->state) {
+    case _STDSOCK_AIO_ACTIVE_:
+#if defined(_STDSOCK_URING_)
+        if (aio->backend == NET_AIO_URING) {
+            struct io_uring_sqe *sqe = _stdsock_uring_sqe_(aio);
+            if (!sqe)
+                return false;
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = -1;
+            sqe->addr = (uint64_t)(uintptr_t)req;
+            req->flags |= _STDSOCK_AIO_CANCEL_;
+            return true;
+        }
+#endif
+        _stdsock_epoll_detach_(aio, req);
+        break;
+    case _STDSOCK_AIO_QUEUED_:
+        _stdsock_aio_unlink_(&aio->ready_head, &aio->ready_tail, req);
+        _stdsock_epoll_detach_(aio, req);
+        break;
+    case _STDSOCK_AIO_STARVED_:
+        _stdsock_aio_unlink_(&aio->starved, NULL, req);
+        if (aio->backend == NET_AIO_EPOLL)
+            _stdsock_epoll_detach_(aio, req);
+        break;
+    default:
+        return false;
+    }
+    req->flags |= _STDSOCK_AIO_CANCEL_;
+    _stdsock_aio_defer_(aio, req, -ECANCELED);
+    return true;
+}
+
+bool net_aio_submit(net_aio_t *aio) {
+#if defined(_STDSOCK_URING_)
+    if (aio->backend == NET_AIO_URING)
+        return _stdsock_uring_enter_(aio, false, 0) == 0;
+#endif
+    (void)aio;
+    return true;
+}
+
+/* Esvazia a fila de prontos até o orçamento: pedidos reenfileirados
+ * pelos próprios callbacks não prendem a iteração. */
+static int _stdsock_aio_drain_(net_aio_t *aio) {
+    int dispatched = 0;
+    for (unsigned budget = _STDSOCK_AIO_BUDGET_; budget && aio->ready_head; budget--) {
+        net_aio_req_t *req = aio->ready_head;
+        aio->ready_head = req->next;
+        if (!aio->ready_head)
+            aio->ready_tail = NULL;
+        req->next = NULL;
+        if (req->state == _STDSOCK_AIO_DONE_)
+            _stdsock_aio_finish_(aio, req, req->result, NULL);
+        else
+            _stdsock_epoll_run_(aio, req);
+        dispatched++;
+    }
+    return dispatched;
+}
+
+int net_aio_run_once(net_aio_t *aio, int timeout_ms) {
+    int dispatched = _stdsock_aio_drain_(aio);
+    if (dispatched || aio->ready_head)
+        timeout_ms = 0;
+#if defined(_STDSOCK_URING_)
+    if (aio->backend == NET_AIO_URING) {
+        const bool pending = atomic_load_explicit(aio->cq_tail, memory_order_acquire) !=
+                             atomic_load_explicit(aio->cq_head, memory_order_relaxed);
+        if (_stdsock_uring_enter_(aio, timeout_ms != 0 && !pending, timeout_ms) < 0)
+            return -1;
+        dispatched += _stdsock_uring_reap_(aio);
+        return dispatched + _stdsock_aio_drain_(aio);
+    }
+#endif
+    aio->syscalls++;
+    int count = epoll_wait(aio->epfd, aio->events, _STDSOCK_AIO_EVENTS_, timeout_ms);
+    if (count < 0) {
+        if (errno != EINTR)
+            return -1;
+        count = 0;
+    }
+    for (int i = 0; i < count; i++)
+        _stdsock_epoll_dispatch_(aio, &aio->events[i]);
+    return dispatched + _stdsock_aio_drain_(aio);
+}
+
+void net_aio_run(net_aio_t *aio) {
+    while (!atomic_load_explicit(&aio->stop, memory_order_acquire)) {
+        if (net_aio_run_once(aio, -1) < 0)
+            break;
+    }
+    atomic_store_explicit(&aio->stop, false, memory_order_relaxed);
+}
+
+void net_aio_stop(net_aio_t *aio) {
+    atomic_store_explicit(&aio->stop, true, memory_order_release);
+    const uint64_t one = 1;
+    while (write(aio->wakefd, &one, sizeof(one)) < 0 && errno == EINTR) {
+    }
+}
+
+/* ===============================================================
+ * SERVIDOR MULTI-ACCEPTOR
+ * ===============================================================
+ * 1. Grupo reuseport:
+ * Os listeners são criados em ordem na thread que chama init; o
+ * índice de cada um no grupo (o que o programa BPF devolve) é a
+ * ordem de entrada, então socket i = shard i. Com port = 0 o
+ * primeiro escolhe a porta e os outros a repetem.
+ *
+ * 2. Programa de direcionamento (BPF clássico):
+ * Roda no SYN com os dados já depois do cabeçalho TCP; endereços e
+ * portas são lidos relativos ao cabeçalho de rede (SKF_NET_OFF):
+ *   ports = sport << 16 | dport (ordem de host, como as cargas BPF)
+ *   IPv4:  saddr, daddr
+ *   IPv6:  xor das quatro palavras de cada endereço
+ *   h = hash32_int(hash32_int(ports ^ daddr) ^ saddr) % shards
+ * BPF clássico só tem ALU de 32 bits, por isso hash32_int e não
+ * hash64_int. Índice fora do grupo faz o kernel voltar ao hash
+ * próprio.
+ *
+ * 3. Threads:
+ * Cada shard fixa a afinidade, cria o loop e registra o listener
+ * na própria thread; start espera todos ficarem prontos.
+ * =============================================================== */
+
+#define _STDSOCK_BPF_MAX_ 96u
+
+typedef struct _stdsock_bpf_ {
+    struct sock_filter insn[_STDSOCK_BPF_MAX_];
+    unsigned len;
+} _stdsock_bpf_t;
+
+struct net_server {
+    net_server_config_t config;
+    unsigned count;
+    uint16_t port;
+    bool running;
+    _Atomic bool failed;
+    latch_t ready;
+    pthread_t *threads;
+    unsigned started;
+    net_shard_t shards[];
+};
+
+static unsigned _stdsock_bpf_(_stdsock_bpf_t *prog, uint16_t code, uint32_t k) {
+    prog->insn[prog->len].code = code;
+    prog->insn[prog->len].jt = 0;
+    prog->insn[prog->len].jf = 0;
+    prog->insn[prog->len].k = k;
+    return prog->len++;
+}
+
+/* A = hash32_int(A), com X como temporário. */
+static void _stdsock_bpf_hash32_(_stdsock_bpf_t *prog) {
+    static const uint32_t shifts[3] = {16, 15, 16};
+    static const uint32_t muls[2] = {0x7feb352dU, 0x846ca68bU};
+    for (unsigned i = 0; i < 3; i++) {
+        _stdsock_bpf_(prog, BPF_MISC | BPF_TAX, 0);
+        _stdsock_bpf_(prog, BPF_ALU | BPF_RSH | BPF_K, shifts[i]);
+        _stdsock_bpf_(prog, BPF_ALU | BPF_XOR | BPF_X, 0);
+        if (i < 2)
+            _stdsock_bpf_(prog, BPF_ALU | BPF_MUL | BPF_K, muls[i]);
+    }
+}
+
+/* M[slot] = xor das quatro palavras em [SKF_NET_OFF + offset]. */
+static void _stdsock_bpf_fold6_(_stdsock_bpf_t *prog, uint32_t offset, uint32_t slot) {
+    _stdsock_bpf_(prog, BPF_LD | BPF_W | BPF_ABS, (uint32_t)SKF_NET_OFF + offset);
+    for (uint32_t word = 1; word < 4; word++) {
+        _stdsock_bpf_(prog, BPF_MISC | BPF_TAX, 0);
+        _stdsock_bpf_(prog, BPF_LD | BPF_W | BPF_ABS, (uint32_t)SKF_NET_OFF + offset + 4 * word);
+        _stdsock_bpf_(prog, BPF_ALU | BPF_XOR | BPF_X, 0);
+    }
+    _stdsock_bpf_(prog, BPF_ST, slot);
+}
+
+static void _stdsock_bpf_steer_(_stdsock_bpf_t *prog, unsigned shards) {
+    const uint32_t net = (uint32_t)SKF_NET_OFF;
+    prog->len = 0;
+    _stdsock_bpf_(prog, BPF_LD | BPF_B | BPF_ABS, net);
+    _stdsock_bpf_(prog, BPF_ALU | BPF_RSH | BPF_K, 4);
+    const unsigned branch = _stdsock_bpf_(prog, BPF_JMP | BPF_JEQ | BPF_K, 6);
+
+    /* IPv4: X = tamanho do cabeçalho IP (ihl * 4). */
+    _stdsock_bpf_(prog, BPF_LDX | BPF_B | BPF_MSH, net);
+    _stdsock_bpf_(prog, BPF_LD | BPF_W | BPF_IND, net);
+    _stdsock_bpf_(prog, BPF_ST, 0);
+    _stdsock_bpf_(prog, BPF_LD | BPF_W | BPF_ABS, net + 16);
+    _stdsock_bpf_(prog, BPF_ST, 1);
+    _stdsock_bpf_(prog, BPF_LD | BPF_W | BPF_ABS, net + 12);
+    _stdsock_bpf_(prog, BPF_ST, 2);
+    const unsigned skip = _stdsock_bpf_(prog, BPF_JMP | BPF_JA, 0);
+
+    /* IPv6 sem cabeçalhos de extensão: portas logo após os 40 bytes. */
+    prog->insn[branch].jt = (uint8_t)(prog->len - branch - 1);
+    _stdsock_bpf_(prog, BPF_LD | BPF_W | BPF_ABS, net + 40);
+    _stdsock_bpf_(prog, BPF_ST, 0);
+    _stdsock_bpf_fold6_(prog, 24, 1);
+    _stdsock_bpf_fold6_(prog, 8, 2);
+
+    prog->insn[skip].k = prog->len - skip - 1;
+    _stdsock_bpf_(prog, BPF_LD | BPF_MEM, 0);
+    _stdsock_bpf_(prog, BPF_LDX | BPF_MEM, 1);
+    _stdsock_bpf_(prog, BPF_ALU | BPF_XOR | BPF_X, 0);
+    _stdsock_bpf_hash32_(prog);
+    _stdsock_bpf_(prog, BPF_LDX | BPF_MEM, 2);
+    _stdsock_bpf_(prog, BPF_ALU | BPF_XOR | BPF_X, 0);
+    _stdsock_bpf_hash32_(prog);
+    _stdsock_bpf_(prog, BPF_ALU | BPF_MOD | BPF_K, shards);
+    _stdsock_bpf_(prog, BPF_RET | BPF_A, 0);
+}
+
+/* Endereço em ordem de host; IPv6 dobrado por xor, v4 mapeado como
+ * IPv4 (é o que chega no fio). Devolve false para outras famílias. */
+static bool _stdsock_steer_addr_(const struct sockaddr *sa, uint32_t *addr, uint16_t *port) {
+    if (sa->sa_family == AF_INET) {
+        const struct sockaddr_in *in = (const struct sockaddr_in *)(const void *)sa;
+        *addr = ntohl(in->sin_addr.s_addr);
+        *port = ntohs(in->sin_port);
+        return true;
+    }
+    if (sa->sa_family != AF_INET6)
+        return false;
+    const struct sockaddr_in6 *in6 = (const struct sockaddr_in6 *)(const void *)sa;
+    uint32_t words[4];
+    memcpy(words, &in6->sin6_addr, sizeof(words));
+    *port = ntohs(in6->sin6_port);
+    if (IN6_IS_ADDR_V4MAPPED(&in6->sin6_addr)) {
+        *addr = ntohl(words[3]);
+        return true;
+    }
+    *addr = ntohl(words[0]) ^ ntohl(words[1]) ^ ntohl(words[2]) ^ ntohl(words[3]);
+    return true;
+}
+
+unsigned net_server_steer(const struct sockaddr *client, const struct sockaddr *server, unsigned shards) {
+    uint32_t saddr, daddr;
+    uint16_t sport, dport;
+    if (!shards || !_stdsock_steer_addr_(client, &saddr, &sport) || !_stdsock_steer_addr_(server, &daddr, &dport))
+        return 0;
+    const uint32_t ports = (uint32_t)sport << 16 | dport;
+    return hash32_int(hash32_int(ports ^ daddr) ^ saddr) % shards;
+}
+
+static void _stdsock_shard_accept_(net_loop_t *loop, net_handle_t *handle, uint32_t events) {
+    (void)loop;
+    (void)events;
+    net_shard_t *shard = handle->ctx;
+    const net_accept_fn on_accept = shard->server->config.on_accept;
+    socket_t sock;
+    while (ISVALIDSOCKET(sock = net_accept(handle->fd))) {
+        shard->accepted++;
+        if (on_accept)
+            on_accept(shard, sock);
+        else
+            CLOSESOCKET(sock);
+    }
+}
+
+static void *_stdsock_shard_main_(void *arg) {
+    net_shard_t *shard = arg;
+    net_server_t *server = shard->server;
+    if (shard->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET((size_t)shard->cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+    shard->loop = net_loop_init(0);
+    const bool ok = shard->loop && net_loop_add(shard->loop, &shard->listener, NET_EVENT_READ);
+    if (!ok)
+        atomic_store_explicit(&server->failed, true, memory_order_relaxed);
+    else if (server->config.on_start)
+        server->config.on_start(shard);
+    latch_count_down(&server->ready, 1);
+    if (!ok)
+        return NULL;
+    net_loop_run(shard->loop);
+    if (server->config.on_stop)
+        server->config.on_stop(shard);
+    net_loop_del(shard->loop, &shard->listener);
+    return NULL;
+}
+
+static unsigned _stdsock_server_cpus_(int *cpus, unsigned max) {
+    cpu_set_t set;
+    unsigned count = 0;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE && count < max; cpu++)
+            if (CPU_ISSET((size_t)cpu, &set))
+                cpus[count++] = cpu;
+    }
+    if (!count)
+        cpus[count++] = 0;
+    return count;
+}
+
+net_server_t *net_server_init(const net_server_config_t *config) {
+    int cpus[CPU_SETSIZE];
+    const unsigned ncpus = _stdsock_server_cpus_(cpus, CPU_SETSIZE);
+    const unsigned count = config->shards ? config->shards : ncpus;
+    if (count > UINT16_MAX)
+        return NULL;
+    net_server_t *server = calloc(1, sizeof(net_server_t) + count * sizeof(net_shard_t));
+    if (!server)
+        return NULL;
+    server->config = *config;
+    server->count = count;
+    server->port = config->port;
+    const unsigned flags = (config->flags & NET_LISTEN_IPV6) | NET_LISTEN_REUSEPORT;
+    bool ok = true;
+    for (unsigned i = 0; i < count; i++) {
+        net_shard_t *shard = &server->shards[i];
+        shard->server = server;
+        shard->index = i;
+        shard->cpu = (config->flags & NET_SERVER_PIN) ? cpus[i % ncpus] : -1;
+        shard->listener.on_read = _stdsock_shard_accept_;
+        shard->listener.ctx = shard;
+        shard->listener.fd = ok ? net_listen_tcp(config->host, server->port, config->backlog, flags) : INVALID_SOCKET;
+        ok = ok && ISVALIDSOCKET(shard->listener.fd);
+        if (ok && i == 0)
+            server->port = net_local_port(shard->listener.fd);
+    }
+    if (ok && (config->flags & NET_SERVER_STEER)) {
+        _stdsock_bpf_t prog;
+        _stdsock_bpf_steer_(&prog, count);
+        struct sock_fprog fprog = {.len = (unsigned short)prog.len, .filter = prog.insn};
+        ok = setsockopt(server->shards[0].listener.fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &fprog,
+                        sizeof(fprog)) == 0;
+    }
+    if (!ok) {
+        net_server_free(server);
+        return NULL;
+    }
+    return server;
+}
+
+void net_server_free(net_server_t *server) {
+    if (!server)
+        return;
+    net_server_stop(server);
+    for (unsigned i = 0; i < server->count; i++)
+        if (ISVALIDSOCKET(server->shards[i].listener.fd))
+            CLOSESOCKET(server->shards[i].listener.fd);
+    free(server);
+}
+
+bool net_server_start(net_server_t *server) {
+    if (server->running)
+        return true;
+    server->threads = calloc(server->count, sizeof(pthread_t));
+    if (!server->threads)
+        return false;
+    atomic_store_explicit(&server->failed, false, memory_order_relaxed);
+    latch_init(&server->ready, (int64_t)server->count);
+    unsigned started = 0;
+    for (; started < server->count; started++) {
+        if (pthread_create(&server->threads[started], NULL, _stdsock_shard_main_, &server->shards[started]) != 0)
+            break;
+    }
+    /* pthread_t é opaco: só threads[0..started) são válidos. */
+    server->started = started;
+    if (started < server->count) {
+        atomic_store_explicit(&server->failed, true, memory_order_relaxed);
+        latch_count_down(&server->ready, (int64_t)(server->count - started));
+    }
+    latch_wait(&server->ready);
+    server->running = true;
+    if (atomic_load_explicit(&server->failed, memory_order_relaxed)) {
+        net_server_stop(server);
+        return false;
+    }
+    return true;
+}
+
+void net_server_stop(net_server_t *server) {
+    if (!server->running)
+        return;
+    for (unsigned i = 0; i < server->count; i++)
+        if (server->shards[i].loop)
+            net_loop_stop(server->shards[i].loop);
+    for (unsigned i = 0; i < server->count; i++) {
+        if (i < server->started)
+            pthread_join(server->threads[i], NULL);
+        net_loop_free(server->shards[i].loop);
+        server->shards[i].loop = NULL;
+    }
+    free(server->threads);
+    server->threads = NULL;
+    server->started = 0;
+    server->running = false;
+}
+
+unsigned net_server_shards(const net_server_t *server) {
+    return server->count;
+}
+
+net_shard_t *net_server_shard(net_server_t *server, unsigned index) {
+    return index < server->count ? &server->shards[index] : NULL;
+}
+
+uint16_t net_server_port(const net_server_t *server) {
+    return server->port;
+}
+
+void *net_server_ctx(const net_server_t *server) {
+    return server->config.ctx;
+}
+
+#endif
+
+#else
+typedef int _stdsock_unused_;
+#endif
@@ -0,0 +1,1304 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "stdthrd.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/* ===============================================================
+ * PRIMITIVAS INTERNAS (HELPERS)
+ * ===============================================================
+ * 1. Pause:
+ * Dica de spin-wait para a CPU (PAUSE no x86, YIELD no ARM). Libera
+ * recursos para o outro hyperthread e evita a penalidade de
+ * memory-order violation ao sair do laço.
+ *
+ * 2. Futex (Linux):
+ * Espera no kernel apenas enquanto *addr == expected; o wake é
+ * uma syscall barata quando ninguém dorme. Fora do Linux a espera
+ * degrada para sched_yield.
+ * =============================================================== */
+
+static inline void _stdthrd_pause_(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static void _stdthrd_futex_wait_(_Atomic uint32_t *addr, uint32_t expected) {
+#if defined(__linux__)
+    syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+#else
+    if (atomic_load_explicit(addr, memory_order_relaxed) == expected)
+        sched_yield();
+#endif
+}
+
+static void _stdthrd_futex_wake_(_Atomic uint32_t *addr, int count) {
+#if defined(__linux__)
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+#else
+    (void)addr;
+    (void)count;
+#endif
+}
+
+/* ===============================================================
+ * LATCH
+ * ===============================================================
+ * state: 0 = pendente, 1 = pendente com threads dormindo,
+ * 2 = liberado. Só quem leva o contador de > 0 para <= 0 publica
+ * o estado 2, e o wake só acontece se alguém marcou o estado 1.
+ * =============================================================== */
+
+#define _STDTHRD_LATCH_PENDING_ 0u
+#define _STDTHRD_LATCH_WAITING_ 1u
+#define _STDTHRD_LATCH_DONE_ 2u
+#define _STDTHRD_SPIN_ 128
+
+void latch_init(latch_t *latch, int64_t count) {
+    atomic_init(&latch->count, count);
+    atomic_init(&latch->state, count > 0 ? _STDTHRD_LATCH_PENDING_ : _STDTHRD_LATCH_DONE_);
+}
+
+void latch_count_down(latch_t *latch, int64_t n) {
+    const int64_t old = atomic_fetch_sub_explicit(&latch->count, n, memory_order_acq_rel);
+    if (old <= 0 || old - n > 0)
+        return;
+    if (atomic_exchange_explicit(&latch->state, _STDTHRD_LATCH_DONE_, memory_order_release) ==
+        _STDTHRD_LATCH_WAITING_) {
+        _stdthrd_futex_wake_(&latch->state, INT_MAX);
+    }
+}
+
+bool latch_try_wait(latch_t *latch) {
+    return atomic_load_explicit(&latch->state, memory_order_acquire) == _STDTHRD_LATCH_DONE_;
+}
+
+void latch_wait(latch_t *latch) {
+    for (int i = 0; i < _STDTHRD_SPIN_; i++) {
+        if (latch_try_wait(latch))
+            return;
+        _stdthrd_pause_();
+    }
+    for (;;) {
+        uint32_t state = atomic_load_explicit(&latch->state, memory_order_acquire);
+        if (state == _STDTHRD_LATCH_DONE_)
+            return;
+        if (state == _STDTHRD_LATCH_PENDING_ &&
+            !atomic_compare_exchange_weak_explicit(
+                &latch->state, &state, _STDTHRD_LATCH_WAITING_, memory_order_acquire,
+                memory_order_acquire
+            )) {
+            continue;
+        }
+        _stdthrd_futex_wait_(&latch->state, _STDTHRD_LATCH_WAITING_);
+    }
+}
+
+/* ===============================================================
+ * DEQUE CHASE-LEV (Lê, Pop, Cohen e Nardelli, PPoPP 2013)
+ * ===============================================================
+ * Capacidade fixa (potência de 2). O dono usa push/pop no fundo
+ * sem CAS no caso comum; ladrões disputam o topo com CAS. Os campos
+ * do slot são atômicos relaxados: uma leitura rasgada só acontece
+ * quando o CAS do ladrão falha, e então o valor é descartado.
+ * Deque cheio devolve false e a tarefa segue para a fila de
+ * injeção (ou executa sem dividir, no parallel-for).
+ * =============================================================== */
+
+typedef struct _stdthrd_task {
+    tpool_fn fn;
+    void *arg;
+    uint64_t lo;
+    uint64_t hi;
+} _stdthrd_task_t;
+
+typedef struct _stdthrd_slot {
+    _Atomic(tpool_fn) fn;
+    _Atomic(void *) arg;
+    _Atomic uint64_t lo;
+    _Atomic uint64_t hi;
+} _stdthrd_slot_t;
+
+typedef struct _stdthrd_deque {
+    alignas(64) _Atomic int64_t top;
+    alignas(64) _Atomic int64_t bottom;
+    _stdthrd_slot_t *buf;
+    int64_t mask;
+} _stdthrd_deque_t;
+
+static inline void _stdthrd_slot_read_(_stdthrd_slot_t *slot, _stdthrd_task_t *task) {
+    task->fn = atomic_load_explicit(&slot->fn, memory_order_relaxed);
+    task->arg = atomic_load_explicit(&slot->arg, memory_order_relaxed);
+    task->lo = atomic_load_explicit(&slot->lo, memory_order_relaxed);
+    task->hi = atomic_load_explicit(&slot->hi, memory_order_relaxed);
+}
+
+static bool _stdthrd_deque_push_(_stdthrd_deque_t *dq, const _stdthrd_task_t *task) {
+    const int64_t b = atomic_load_explicit(&dq->bottom, memory_order_relaxed);
+    const int64_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+    if (b - t > dq->mask)
+        return false;
+    _stdthrd_slot_t *slot = &dq->buf[b & dq->mask];
+    atomic_store_explicit(&slot->fn, task->fn, memory_order_relaxed);
+    atomic_store_explicit(&slot->arg, task->arg, memory_order_relaxed);
+    atomic_store_explicit(&slot->lo, task->lo, memory_order_relaxed);
+    atomic_store_explicit(&slot->hi, task->hi, memory_order_relaxed);
+    atomic_store_explicit(&dq->bottom, b + 1, memory_order_release);
+    return true;
+}
+
+static bool _stdthrd_deque_pop_(_stdthrd_deque_t *dq, _stdthrd_task_t *task) {
+    const int64_t b = atomic_load_explicit(&dq->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&dq->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_relaxed);
+    if (t > b) {
+        atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+        return false;
+    }
+    _stdthrd_slot_read_(&dq->buf[b & dq->mask], task);
+    if (t == b) {
+        /* Último item: disputa com os ladrões. */
+        const bool won = atomic_compare_exchange_strong_explicit(
+            &dq->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed
+        );
+        atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+static bool _stdthrd_deque_steal_(_stdthrd_deque_t *dq, _stdthrd_task_t *task) {
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    const int64_t b = atomic_load_explicit(&dq->bottom, memory_order_acquire);
+    if (t >= b)
+        return false;
+    _stdthrd_slot_read_(&dq->buf[t & dq->mask], task);
+    return atomic_compare_exchange_strong_explicit(
+        &dq->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed
+    );
+}
+
+/* ===============================================================
+ * THREAD POOL
+ * ===============================================================
+ * 1. Busca de Trabalho:
+ * Próprio deque -> fila de injeção -> roubo. A ordem de vítimas
+ * começa pelos workers do mesmo nó NUMA, cada passada a partir de
+ * uma posição aleatória (xorshift do worker).
+ *
+ * 2. Dormir sem Perder Wakeups (Dekker):
+ * O worker lê signal, incrementa sleepers e procura trabalho uma
+ * última vez antes do futex_wait(signal). Quem publica trabalho
+ * faz um fence seq_cst e só então lê sleepers; se houver alguém
+ * dormindo, incrementa signal e acorda um worker. Uma das duas
+ * threads sempre enxerga a escrita da outra.
+ *
+ * 3. Afinidade:
+ * CORE fixa o worker i na i-ésima CPU permitida ao processo.
+ * NUMA fixa o worker i em todas as CPUs do nó (i mod nós), lidas
+ * de /sys/devices/system/node, sem depender de libnuma.
+ * =============================================================== */
+
+#define _STDTHRD_DEQUE_DEFAULT_ 1024u
+#define _STDTHRD_NODES_MAX_ 64
+
+typedef struct _stdthrd_worker {
+    _stdthrd_deque_t deque;
+    tpool_t *pool;
+    pthread_t thread;
+    unsigned id;
+    unsigned node;
+    unsigned local;
+    unsigned *victims;
+    uint64_t seed;
+    bool started;
+#if defined(__linux__)
+    bool pinned;
+    cpu_set_t cpus;
+#endif
+} _stdthrd_worker_t;
+
+struct tpool {
+    _stdthrd_worker_t *workers;
+    unsigned size;
+
+    pthread_mutex_t inject_lock;
+    _stdthrd_task_t *inject;
+    size_t inject_head;
+    size_t inject_cap;
+    _Atomic size_t inject_count;
+
+    alignas(64) _Atomic uint32_t signal;
+    _Atomic uint32_t sleepers;
+    _Atomic bool stop;
+};
+
+typedef struct _stdthrd_range {
+    tpool_range_fn fn;
+    void *ctx;
+    uint64_t grain;
+    latch_t done;
+} _stdthrd_range_t;
+
+static _Thread_local _stdthrd_worker_t *_stdthrd_self_;
+
+static inline _stdthrd_worker_t *_stdthrd_self_in_(const tpool_t *pool) {
+    _stdthrd_worker_t *self = _stdthrd_self_;
+    return self && self->pool == pool ? self : NULL;
+}
+
+static bool _stdthrd_inject_push_(tpool_t *pool, const _stdthrd_task_t *task) {
+    pthread_mutex_lock(&pool->inject_lock);
+    const size_t count = atomic_load_explicit(&pool->inject_count, memory_order_relaxed);
+    if (count == pool->inject_cap) {
+        const size_t cap = pool->inject_cap ? pool->inject_cap * 2 : 64;
+        _stdthrd_task_t *grown = malloc(cap * sizeof(_stdthrd_task_t));
+        if (!grown) {
+            pthread_mutex_unlock(&pool->inject_lock);
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            grown[i] = pool->inject[(pool->inject_head + i) % pool->inject_cap];
+        }
+        free(pool->inject);
+        pool->inject = grown;
+        pool->inject_head = 0;
+        pool->inject_cap = cap;
+    }
+    pool->inject[(pool->inject_head + count) % pool->inject_cap] = *task;
+    atomic_store_explicit(&pool->inject_count, count + 1, memory_order_release);
+    pthread_mutex_unlock(&pool->inject_lock);
+    return true;
+}
+
+static bool _stdthrd_inject_pop_(tpool_t *pool, _stdthrd_task_t *task) {
+    if (atomic_load_explicit(&pool->inject_count, memory_order_acquire) == 0)
+        return false;
+    bool found = false;
+    pthread_mutex_lock(&pool->inject_lock);
+    const size_t count = atomic_load_explicit(&pool->inject_count, memory_order_relaxed);
+    if (count) {
+        *task = pool->inject[pool->inject_head];
+        pool->inject_head = (pool->inject_head + 1) % pool->inject_cap;
+        atomic_store_explicit(&pool->inject_count, count - 1, memory_order_relaxed);
+        found = true;
+    }
+    pthread_mutex_unlock(&pool->inject_lock);
+    return found;
+}
+
+static inline unsigned _stdthrd_random_(_stdthrd_worker_t *self, unsigned range) {
+    self->seed ^= self->seed << 13;
+    self->seed ^= self->seed >> 7;
+    self->seed ^= self->seed << 17;
+    return (unsigned)(self->seed % range);
+}
+
+static bool _stdthrd_steal_(tpool_t *pool, _stdthrd_worker_t *self, _stdthrd_task_t *task) {
+    const unsigned others = pool->size - 1;
+    const unsigned bounds[3] = {0, self->local, others};
+    for (int pass = 0; pass < 2; pass++) {
+        const unsigned first = bounds[pass], count = bounds[pass + 1] - bounds[pass];
+        if (count == 0)
+            continue;
+        const unsigned start = _stdthrd_random_(self, count);
+        for (unsigned i = 0; i < count; i++) {
+            const unsigned victim = self->victims[first + (start + i) % count];
+            if (_stdthrd_deque_steal_(&pool->workers[victim].deque, task))
+                return true;
+        }
+    }
+    return false;
+}
+
+static bool _stdthrd_find_(tpool_t *pool, _stdthrd_worker_t *self, _stdthrd_task_t *task) {
+    if (_stdthrd_deque_pop_(&self->deque, task))
+        return true;
+    if (_stdthrd_inject_pop_(pool, task))
+        return true;
+    return _stdthrd_steal_(pool, self, task);
+}
+
+static void _stdthrd_notify_(tpool_t *pool) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&pool->sleepers, memory_order_relaxed) == 0)
+        return;
+    atomic_fetch_add_explicit(&pool->signal, 1, memory_order_seq_cst);
+    _stdthrd_futex_wake_(&pool->signal, 1);
+}
+
+/* Tarefas com fn == NULL são faixas de um parallel-for. */
+static void _stdthrd_run_(tpool_t *pool, _stdthrd_worker_t *self, const _stdthrd_task_t *task) {
+    if (task->fn) {
+        task->fn(task->arg);
+        return;
+    }
+    _stdthrd_range_t *job = task->arg;
+    const uint64_t lo = task->lo;
+    uint64_t hi = task->hi;
+    while (self && hi - lo > job->grain) {
+        const uint64_t mid = lo + (hi - lo) / 2;
+        const _stdthrd_task_t half = {.fn = NULL, .arg = job, .lo = mid, .hi = hi};
+        if (!_stdthrd_deque_push_(&self->deque, &half))
+            break;
+        _stdthrd_notify_(pool);
+        hi = mid;
+    }
+    job->fn(lo, hi, job->ctx);
+    latch_count_down(&job->done, (int64_t)(hi - lo));
+}
+
+static void *_stdthrd_worker_main_(void *arg) {
+    _stdthrd_worker_t *self = arg;
+    tpool_t *pool = self->pool;
+    _stdthrd_task_t task;
+    _stdthrd_self_ = self;
+
+    for (;;) {
+        bool found = false;
+        for (int i = 0; i < _STDTHRD_SPIN_ && !found; i++) {
+            found = _stdthrd_find_(pool, self, &task);
+            if (!found)
+                _stdthrd_pause_();
+        }
+        if (found) {
+            _stdthrd_run_(pool, self, &task);
+            continue;
+        }
+        if (atomic_load_explicit(&pool->stop, memory_order_acquire))
+            break;
+
+        const uint32_t epoch = atomic_load_explicit(&pool->signal, memory_order_seq_cst);
+        atomic_fetch_add_explicit(&pool->sleepers, 1, memory_order_seq_cst);
+        found = _stdthrd_find_(pool, self, &task);
+        if (!found && !atomic_load_explicit(&pool->stop, memory_order_seq_cst))
+            _stdthrd_futex_wait_(&pool->signal, epoch);
+        atomic_fetch_sub_explicit(&pool->sleepers, 1, memory_order_relaxed);
+        if (found)
+            _stdthrd_run_(pool, self, &task);
+    }
+    return NULL;
+}
+
+/* ---------------------------------------------------------------
+ * Topologia (CPUs permitidas e nós NUMA).
+ * --------------------------------------------------------------- */
+
+static unsigned _stdthrd_cpu_count_(void) {
+#if defined(__linux__)
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0 && CPU_COUNT(&set) > 0)
+        return (unsigned)CPU_COUNT(&set);
+#endif
+    const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (unsigned)cpus : 1;
+}
+
+#if defined(__linux__)
+/* Lê uma cpulist do sysfs ("0-3,8-11") como interseção com allowed. */
+static bool _stdthrd_read_cpulist_(unsigned node, const cpu_set_t *allowed, cpu_set_t *out) {
+    char path[64], line[1024];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+    FILE *file = fopen(path, "r");
+    if (!file)
+        return false;
+    const bool ok = fgets(line, sizeof(line), file) != NULL;
+    fclose(file);
+    if (!ok)
+        return false;
+
+    CPU_ZERO(out);
+    char *p = line;
+    while (*p >= '0' && *p <= '9') {
+        unsigned long first = strtoul(p, &p, 10), last = first;
+        if (*p == '-')
+            last = strtoul(p + 1, &p, 10);
+        for (unsigned long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, allowed))
+                CPU_SET(cpu, out);
+        }
+        if (*p == ',')
+            p++;
+    }
+    return true;
+}
+
+static void _stdthrd_plan_affinity_(tpool_t *pool, tpool_affinity_t affinity) {
+    cpu_set_t allowed;
+    if (affinity == TPOOL_AFFINITY_NONE || sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        return;
+
+    if (affinity == TPOOL_AFFINITY_CORE) {
+        size_t cpus[CPU_SETSIZE], count = 0;
+        for (size_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed))
+                cpus[count++] = cpu;
+        }
+        for (unsigned w = 0; w < pool->size && count; w++) {
+            _stdthrd_worker_t *worker = &pool->workers[w];
+            CPU_ZERO(&worker->cpus);
+            CPU_SET(cpus[w % count], &worker->cpus);
+            worker->pinned = true;
+        }
+        return;
+    }
+
+    cpu_set_t nodes[_STDTHRD_NODES_MAX_];
+    unsigned ids[_STDTHRD_NODES_MAX_], count = 0;
+    for (unsigned node = 0; node < _STDTHRD_NODES_MAX_; node++) {
+        if (_stdthrd_read_cpulist_(node, &allowed, &nodes[count]) && CPU_COUNT(&nodes[count])) {
+            ids[count++] = node;
+        }
+    }
+    if (count == 0) {
+        nodes[0] = allowed;
+        ids[0] = 0;
+        count = 1;
+    }
+    for (unsigned w = 0; w < pool->size; w++) {
+        _stdthrd_worker_t *worker = &pool->workers[w];
+        worker->cpus = nodes[w % count];
+        worker->node = ids[w % count];
+        worker->pinned = true;
+    }
+}
+#endif
+
+/* Vítimas do mesmo nó primeiro; local = quantas são do mesmo nó. */
+static bool _stdthrd_plan_victims_(tpool_t *pool) {
+    for (unsigned w = 0; w < pool->size; w++) {
+        _stdthrd_worker_t *worker = &pool->workers[w];
+        worker->victims = malloc((pool->size > 1 ? pool->size - 1 : 1) * sizeof(unsigned));
+        if (!worker->victims)
+            return false;
+        unsigned n = 0;
+        for (unsigned v = 0; v < pool->size; v++) {
+            if (v != w && pool->workers[v].node == worker->node)
+                worker->victims[n++] = v;
+        }
+        worker->local = n;
+        for (unsigned v = 0; v < pool->size; v++) {
+            if (pool->workers[v].node != worker->node)
+                worker->victims[n++] = v;
+        }
+    }
+    return true;
+}
+
+/* ---------------------------------------------------------------
+ * API pública.
+ * --------------------------------------------------------------- */
+
+tpool_t *tpool_init(const tpool_config_t *config) {
+    const tpool_config_t defaults = {0};
+    if (!config)
+        config = &defaults;
+
+    tpool_t *pool = calloc(1, sizeof(tpool_t));
+    if (!pool)
+        return NULL;
+    pool->size = config->threads ? config->threads : _stdthrd_cpu_count_();
+    pool->workers = calloc(pool->size, sizeof(_stdthrd_worker_t));
+    if (!pool->workers || pthread_mutex_init(&pool->inject_lock, NULL) != 0) {
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+    atomic_init(&pool->inject_count, 0);
+    atomic_init(&pool->signal, 0);
+    atomic_init(&pool->sleepers, 0);
+    atomic_init(&pool->stop, false);
+
+    size_t cap = config->deque_size ? 2 : _STDTHRD_DEQUE_DEFAULT_;
+    while (cap < config->deque_size)
+        cap <<= 1;
+    bool ok = true;
+    for (unsigned w = 0; w < pool->size && ok; w++) {
+        _stdthrd_worker_t *worker = &pool->workers[w];
+        worker->pool = pool;
+        worker->id = w;
+        worker->seed = 0x9e3779b97f4a7c15ULL * (w + 1);
+        worker->deque.buf = calloc(cap, sizeof(_stdthrd_slot_t));
+        worker->deque.mask = (int64_t)cap - 1;
+        atomic_init(&worker->deque.top, 0);
+        atomic_init(&worker->deque.bottom, 0);
+        ok = worker->deque.buf != NULL;
+    }
+#if defined(__linux__)
+    if (ok)
+        _stdthrd_plan_affinity_(pool, config->affinity);
+#endif
+    ok = ok && _stdthrd_plan_victims_(pool);
+
+    for (unsigned w = 0; w < pool->size && ok; w++) {
+        _stdthrd_worker_t *worker = &pool->workers[w];
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+#if defined(__linux__)
+        if (worker->pinned)
+            pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &worker->cpus);
+#endif
+        worker->started = pthread_create(&worker->thread, &attr, _stdthrd_worker_main_, worker) == 0;
+        pthread_attr_destroy(&attr);
+        ok = worker->started;
+    }
+    if (!ok) {
+        tpool_free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void tpool_free(tpool_t *pool) {
+    if (!pool)
+        return;
+    atomic_store_explicit(&pool->stop, true, memory_order_seq_cst);
+    atomic_fetch_add_explicit(&pool->signal, 1, memory_order_seq_cst);
+    _stdthrd_futex_wake_(&pool->signal, INT_MAX);
+    for (unsigned w = 0; w < pool->size; w++) {
+        if (pool->workers[w].started)
+            pthread_join(pool->workers[w].thread, NULL);
+    }
+    for (unsigned w = 0; w < pool->size; w++) {
+        free(pool->workers[w].deque.buf);
+        free(pool->workers[w].victims);
+    }
+    pthread_mutex_destroy(&pool->inject_lock);
+    free(pool->inject);
+    free(pool->workers);
+    free(pool);
+}
+
+static tpool_t *_stdthrd_default_;
+static pthread_once_t _stdthrd_default_once_ = PTHREAD_ONCE_INIT;
+
+static void _stdthrd_default_init_(void) {
+    _stdthrd_default_ = tpool_init(NULL);
+}
+
+tpool_t *tpool_default(void) {
+    pthread_once(&_stdthrd_default_once_, _stdthrd_default_init_);
+    return _stdthrd_default_;
+}
+
+unsigned tpool_size(const tpool_t *pool) {
+    return pool ? pool->size : 1;
+}
+
+int tpool_worker_id(const tpool_t *pool) {
+    const _stdthrd_worker_t *self = _stdthrd_self_in_(pool);
+    return self ? (int)self->id : -1;
+}
+
+bool tpool_submit(tpool_t *pool, tpool_fn fn, void *arg) {
+    if (!fn)
+        return false;
+    if (!pool) {
+        fn(arg);
+        return true;
+    }
+    const _stdthrd_task_t task = {.fn = fn, .arg = arg};
+    _stdthrd_worker_t *self = _stdthrd_self_in_(pool);
+    if (!(self && _stdthrd_deque_push_(&self->deque, &task)) && !_stdthrd_inject_push_(pool, &task))
+        return false;
+    _stdthrd_notify_(pool);
+    return true;
+}
+
+static void _stdthrd_future_run_(void *arg) {
+    tpool_future_t *future = arg;
+    future->result = future->fn(future->arg);
+    latch_count_down(&future->done, 1);
+}
+
+bool tpool_async(tpool_t *pool, tpool_future_t *future, tpool_value_fn fn, void *arg) {
+    if (!future || !fn)
+        return false;
+    future->fn = fn;
+    future->arg = arg;
+    future->result = NULL;
+    latch_init(&future->done, 1);
+    return tpool_submit(pool, _stdthrd_future_run_, future);
+}
+
+void *tpool_future_wait(tpool_t *pool, tpool_future_t *future) {
+    tpool_wait(pool, &future->done);
+    return future->result;
+}
+
+void tpool_wait(tpool_t *pool, latch_t *latch) {
+    _stdthrd_worker_t *self = _stdthrd_self_in_(pool);
+    if (!self) {
+        latch_wait(latch);
+        return;
+    }
+    /* Dentro do pool: executa outras tarefas enquanto espera. */
+    _stdthrd_task_t task;
+    unsigned idle = 0;
+    while (!latch_try_wait(latch)) {
+        if (_stdthrd_find_(pool, self, &task)) {
+            _stdthrd_run_(pool, self, &task);
+            idle = 0;
+        } else if (++idle < _STDTHRD_SPIN_) {
+            _stdthrd_pause_();
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+bool tpool_parallel_for(tpool_t *pool, uint64_t n, uint64_t grain, tpool_range_fn fn, void *ctx) {
+    if (!fn)
+        return false;
+    if (n == 0)
+        return true;
+    if (!pool) {
+        fn(0, n, ctx);
+        return true;
+    }
+    if (grain == 0) {
+        grain = n / (8 * (uint64_t)pool->size);
+        grain = grain ? grain : 1;
+    }
+    _stdthrd_range_t job = {.fn = fn, .ctx = ctx, .grain = grain};
+    latch_init(&job.done, (int64_t)n);
+    const _stdthrd_task_t root = {.fn = NULL, .arg = &job, .lo = 0, .hi = n};
+
+    _stdthrd_worker_t *self = _stdthrd_self_in_(pool);
+    if (self) {
+        _stdthrd_run_(pool, self, &root);
+    } else {
+        if (!_stdthrd_inject_push_(pool, &root))
+            return false;
+        _stdthrd_notify_(pool);
+    }
+    tpool_wait(pool, &job.done);
+    return true;
+}
+
+/* ===============================================================
+ * FILAS LOCK-FREE LIMITADAS
+ * ===============================================================
+ * 1. SPSC:
+ * head (consumidor) e tail (produtor) ficam em linhas de cache
+ * distintas; cada lado guarda uma cópia do índice alheio e só a
+ * recarrega (acquire) quando a cópia diz cheio/vazio, então no
+ * regime estável nenhuma linha de cache troca de dono por item.
+ * Um lote de n itens custa uma única store-release.
+ *
+ * 2. MPMC (Vyukov):
+ * A célula i começa com seq = i. O produtor na posição pos espera
+ * seq == pos, reserva pos com CAS, copia e publica seq = pos + 1;
+ * o consumidor espera seq == pos + 1 e devolve seq = pos + cap.
+ * diff < 0 significa cheio (ou vazio, no pop) sem nenhum lock.
+ *
+ * 3. Bloqueante:
+ * Spin curto com pause e depois futex sobre um contador de época
+ * (not_empty/not_full). Mesmo protocolo de Dekker do pool: quem
+ * dorme registra-se em *_waiters e tenta de novo antes do
+ * futex_wait; quem libera espaço ou item só faz syscall se houver
+ * alguém registrado.
+ * =============================================================== */
+
+static size_t _stdthrd_pow2_(size_t n) {
+    size_t cap = 2;
+    while (cap < n)
+        cap <<= 1;
+    return cap;
+}
+
+static void _stdthrd_ring_write_(
+    unsigned char *buf, size_t mask, size_t elem_size, size_t pos, const void *items, size_t n
+) {
+    const size_t start = pos & mask, first = n < mask + 1 - start ? n : mask + 1 - start;
+    memcpy(buf + start * elem_size, items, first * elem_size);
+    memcpy(buf, (const unsigned char *)items + first * elem_size, (n - first) * elem_size);
+}
+
+static void _stdthrd_ring_read_(
+    const unsigned char *buf, size_t mask, size_t elem_size, size_t pos, void *items, size_t n
+) {
+    const size_t start = pos & mask, first = n < mask + 1 - start ? n : mask + 1 - start;
+    memcpy(items, buf + start * elem_size, first * elem_size);
+    memcpy((unsigned char *)items + first * elem_size, buf, (n - first) * elem_size);
+}
+
+bool queue_spsc_init(queue_spsc_t *queue, size_t capacity, size_t elem_size) {
+    if (!queue || capacity == 0 || elem_size == 0 || capacity > (SIZE_MAX >> 2) / elem_size)
+        return false;
+    const size_t cap = _stdthrd_pow2_(capacity);
+    queue->buf = malloc(cap * elem_size);
+    if (!queue->buf)
+        return false;
+    queue->mask = cap - 1;
+    queue->elem_size = elem_size;
+    queue->head_cache = 0;
+    queue->tail_cache = 0;
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+    return true;
+}
+
+void queue_spsc_free(queue_spsc_t *queue) {
+    if (!queue)
+        return;
+    free(queue->buf);
+    queue->buf = NULL;
+}
+
+size_t queue_spsc_push_n(queue_spsc_t *queue, const void *items, size_t count) {
+    const size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    const size_t cap = queue->mask + 1;
+    size_t room = cap - (tail - queue->head_cache);
+    if (room < count) {
+        queue->head_cache = atomic_load_explicit(&queue->head, memory_order_acquire);
+        room = cap - (tail - queue->head_cache);
+    }
+    const size_t n = count < room ? count : room;
+    if (n == 0)
+        return 0;
+    _stdthrd_ring_write_(queue->buf, queue->mask, queue->elem_size, tail, items, n);
+    atomic_store_explicit(&queue->tail, tail + n, memory_order_release);
+    return n;
+}
+
+size_t queue_spsc_pop_n(queue_spsc_t *queue, void *items, size_t count) {
+    const size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    size_t avail = queue->tail_cache - head;
+    if (avail < count) {
+        queue->tail_cache = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        avail = queue->tail_cache - head;
+    }
+    const size_t n = count < avail ? count : avail;
+    if (n == 0)
+        return 0;
+    _stdthrd_ring_read_(queue->buf, queue->mask, queue->elem_size, head, items, n);
+    atomic_store_explicit(&queue->head, head + n, memory_order_release);
+    return n;
+}
+
+bool queue_spsc_push(queue_spsc_t *queue, const void *item) {
+    const size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    if (tail - queue->head_cache > queue->mask) {
+        queue->head_cache = atomic_load_explicit(&queue->head, memory_order_acquire);
+        if (tail - queue->head_cache > queue->mask)
+            return false;
+    }
+    memcpy(queue->buf + (tail & queue->mask) * queue->elem_size, item, queue->elem_size);
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+bool queue_spsc_pop(queue_spsc_t *queue, void *item) {
+    const size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    if (head == queue->tail_cache) {
+        queue->tail_cache = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        if (head == queue->tail_cache)
+            return false;
+    }
+    memcpy(item, queue->buf + (head & queue->mask) * queue->elem_size, queue->elem_size);
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return true;
+}
+
+static inline _Atomic size_t *_stdthrd_cell_(const queue_mpmc_t *queue, size_t pos) {
+    return (_Atomic size_t *)(void *)(queue->cells + (pos & queue->mask) * queue->stride);
+}
+
+bool queue_mpmc_init(queue_mpmc_t *queue, size_t capacity, size_t elem_size) {
+    if (!queue || capacity == 0 || elem_size == 0 || elem_size > SIZE_MAX / 4 ||
+        capacity > (SIZE_MAX >> 2) / (elem_size + sizeof(size_t) + 7))
+        return false;
+    const size_t cap = _stdthrd_pow2_(capacity);
+    const size_t stride = (sizeof(size_t) + elem_size + 7) & ~(size_t)7;
+    const size_t bytes = (cap * stride + 63) & ~(size_t)63;
+    queue->cells = aligned_alloc(64, bytes);
+    if (!queue->cells)
+        return false;
+    queue->mask = cap - 1;
+    queue->elem_size = elem_size;
+    queue->stride = stride;
+    for (size_t i = 0; i < cap; i++) {
+        atomic_init(_stdthrd_cell_(queue, i), i);
+    }
+    atomic_init(&queue->enqueue_pos, 0);
+    atomic_init(&queue->dequeue_pos, 0);
+    return true;
+}
+
+void queue_mpmc_free(queue_mpmc_t *queue) {
+    if (!queue)
+        return;
+    free(queue->cells);
+    queue->cells = NULL;
+}
+
+bool queue_mpmc_push(queue_mpmc_t *queue, const void *item) {
+    size_t pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+    _Atomic size_t *cell;
+    for (;;) {
+        cell = _stdthrd_cell_(queue, pos);
+        const size_t seq = atomic_load_explicit(cell, memory_order_acquire);
+        const intptr_t diff = (intptr_t)(seq - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &queue->enqueue_pos, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed
+                ))
+                break;
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+        }
+    }
+    memcpy((unsigned char *)(void *)cell + sizeof(size_t), item, queue->elem_size);
+    atomic_store_explicit(cell, pos + 1, memory_order_release);
+    return true;
+}
+
+bool queue_mpmc_pop(queue_mpmc_t *queue, void *item) {
+    size_t pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+    _Atomic size_t *cell;
+    for (;;) {
+        cell = _stdthrd_cell_(queue, pos);
+        const size_t seq = atomic_load_explicit(cell, memory_order_acquire);
+        const intptr_t diff = (intptr_t)(seq - (pos + 1));
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &queue->dequeue_pos, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed
+                ))
+                break;
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+        }
+    }
+    memcpy(item, (unsigned char *)(void *)cell + sizeof(size_t), queue->elem_size);
+    atomic_store_explicit(cell, pos + queue->mask + 1, memory_order_release);
+    return true;
+}
+
+bool queue_blocking_init(
+    queue_blocking_t *queue, queue_kind_t kind, size_t capacity, size_t elem_size
+) {
+    if (!queue)
+        return false;
+    queue->kind = kind;
+    queue->spsc.buf = NULL;
+    queue->mpmc.cells = NULL;
+    atomic_init(&queue->not_empty, 0);
+    atomic_init(&queue->not_full, 0);
+    atomic_init(&queue->pop_waiters, 0);
+    atomic_init(&queue->push_waiters, 0);
+    atomic_init(&queue->closed, false);
+    return kind == QUEUE_SPSC ? queue_spsc_init(&queue->spsc, capacity, elem_size)
+                              : queue_mpmc_init(&queue->mpmc, capacity, elem_size);
+}
+
+void queue_blocking_free(queue_blocking_t *queue) {
+    if (!queue)
+        return;
+    queue_spsc_free(&queue->spsc);
+    queue_mpmc_free(&queue->mpmc);
+}
+
+static void _stdthrd_queue_wake_(_Atomic uint32_t *epoch, _Atomic uint32_t *waiters) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(waiters, memory_order_relaxed) == 0)
+        return;
+    atomic_fetch_add_explicit(epoch, 1, memory_order_seq_cst);
+    _stdthrd_futex_wake_(epoch, 1);
+}
+
+bool queue_blocking_try_push(queue_blocking_t *queue, const void *item) {
+    const bool ok = queue->kind == QUEUE_SPSC ? queue_spsc_push(&queue->spsc, item)
+                                              : queue_mpmc_push(&queue->mpmc, item);
+    if (ok)
+        _stdthrd_queue_wake_(&queue->not_empty, &queue->pop_waiters);
+    return ok;
+}
+
+bool queue_blocking_try_pop(queue_blocking_t *queue, void *item) {
+    const bool ok = queue->kind == QUEUE_SPSC ? queue_spsc_pop(&queue->spsc, item)
+                                              : queue_mpmc_pop(&queue->mpmc, item);
+    if (ok)
+        _stdthrd_queue_wake_(&queue->not_full, &queue->push_waiters);
+    return ok;
+}
+
+bool queue_blocking_push(queue_blocking_t *queue, const void *item) {
+    for (;;) {
+        for (int i = 0; i < _STDTHRD_SPIN_; i++) {
+            if (atomic_load_explicit(&queue->closed, memory_order_acquire))
+                return false;
+            if (queue_blocking_try_push(queue, item))
+                return true;
+            _stdthrd_pause_();
+        }
+        const uint32_t epoch = atomic_load_explicit(&queue->not_full, memory_order_seq_cst);
+        atomic_fetch_add_explicit(&queue->push_waiters, 1, memory_order_seq_cst);
+        atomic_thread_fence(memory_order_seq_cst);
+        const bool pushed = queue_blocking_try_push(queue, item);
+        const bool closed = atomic_load_explicit(&queue->closed, memory_order_acquire);
+        if (!pushed && !closed)
+            _stdthrd_futex_wait_(&queue->not_full, epoch);
+        atomic_fetch_sub_explicit(&queue->push_waiters, 1, memory_order_relaxed);
+        if (pushed)
+            return true;
+        if (closed)
+            return false;
+    }
+}
+
+bool queue_blocking_pop(queue_blocking_t *queue, void *item) {
+    for (;;) {
+        for (int i = 0; i < _STDTHRD_SPIN_; i++) {
+            if (queue_blocking_try_pop(queue, item))
+                return true;
+            /* Fechada: drena o que sobrou antes de devolver false. */
+            if (atomic_load_explicit(&queue->closed, memory_order_acquire))
+                return queue_blocking_try_pop(queue, item);
+            _stdthrd_pause_();
+        }
+        const uint32_t epoch = atomic_load_explicit(&queue->not_empty, memory_order_seq_cst);
+        atomic_fetch_add_explicit(&queue->pop_waiters, 1, memory_order_seq_cst);
+        atomic_thread_fence(memory_order_seq_cst);
+        const bool popped = queue_blocking_try_pop(queue, item);
+        const bool closed = atomic_load_explicit(&queue->closed, memory_order_acquire);
+        if (!popped && !closed)
+            _stdthrd_futex_wait_(&queue->not_empty, epoch);
+        atomic_fetch_sub_explicit(&queue->pop_waiters, 1, memory_order_relaxed);
+        if (popped)
+            return true;
+        if (closed)
+            return queue_blocking_try_pop(queue, item);
+    }
+}
+
+void queue_blocking_close(queue_blocking_t *queue) {
+    atomic_store_explicit(&queue->closed, true, memory_order_seq_cst);
+    atomic_fetch_add_explicit(&queue->not_empty, 1, memory_order_seq_cst);
+    atomic_fetch_add_explicit(&queue->not_full, 1, memory_order_seq_cst);
+    _stdthrd_futex_wake_(&queue->not_empty, INT_MAX);
+    _stdthrd_futex_wake_(&queue->not_full, INT_MAX);
+}
+
+/* ===============================================================
+ * LOCKS
+ * ===============================================================
+ * 1. Mutex Adaptativo (Drepper, "Futexes Are Tricky", mutex 3):
+ * CAS 0 -> 1 no caminho rápido. Sob disputa, gira com backoff
+ * exponencial (1, 2, 4 ... 64 pauses) relendo o estado; se ainda
+ * ocupado, marca 2 e dorme no futex. O unlock só faz syscall se
+ * o estado era 2.
+ *
+ * 2. Ticket e MCS:
+ * Ticket: cada thread espera proporcionalmente à sua distância na
+ * fila, o que reduz leituras do contador compartilhado. MCS: cada
+ * thread gira no próprio nó e o dono repassa o lock escrevendo no
+ * nó do sucessor; quem esperou demais dorme no futex do nó.
+ * Esperas longas cedem a CPU (sched_yield/futex), evitando que um
+ * dono preemptado trave os demais em máquinas sobrecarregadas.
+ *
+ * 3. Seqlock:
+ * seq ímpar = escrita em andamento. O leitor copia os dados e
+ * confere se seq não mudou; escritores são serializados por um
+ * lock_mutex_t interno.
+ *
+ * 4. Reader-Writer por Núcleo:
+ * O leitor incrementa o contador do slot do seu núcleo
+ * (sched_getcpu, fixado por thread) e confere pending; o escritor
+ * publica pending e espera todos os slots zerarem. É o mesmo
+ * protocolo de Dekker do pool, e leitores em núcleos diferentes
+ * nunca disputam a mesma linha de cache.
+ * =============================================================== */
+
+#define _STDTHRD_BACKOFF_MAX_ 64u
+#define _STDTHRD_YIELD_AFTER_ 64u
+
+static inline void _stdthrd_backoff_(unsigned *delay) {
+    for (unsigned i = 0; i < *delay; i++) {
+        _stdthrd_pause_();
+    }
+    if (*delay < _STDTHRD_BACKOFF_MAX_)
+        *delay <<= 1;
+}
+
+void lock_mutex_init(lock_mutex_t *lock) {
+    atomic_init(&lock->state, 0);
+}
+
+bool lock_mutex_trylock(lock_mutex_t *lock) {
+    uint32_t expected = 0;
+    return atomic_compare_exchange_strong_explicit(
+        &lock->state, &expected, 1, memory_order_acquire, memory_order_relaxed
+    );
+}
+
+void lock_mutex_lock(lock_mutex_t *lock) {
+    if (lock_mutex_trylock(lock))
+        return;
+    uint32_t state = 0;
+    for (unsigned delay = 1; delay <= _STDTHRD_BACKOFF_MAX_;) {
+        _stdthrd_backoff_(&delay);
+        state = atomic_load_explicit(&lock->state, memory_order_relaxed);
+        if (state == 0 && lock_mutex_trylock(lock))
+            return;
+        if (state == 2)
+            break;
+        if (delay == _STDTHRD_BACKOFF_MAX_)
+            break;
+    }
+    /* Marca "com threads dormindo"; quem recebe 0 assume o lock. */
+    while (atomic_exchange_explicit(&lock->state, 2, memory_order_acquire) != 0) {
+        _stdthrd_futex_wait_(&lock->state, 2);
+    }
+}
+
+void lock_mutex_unlock(lock_mutex_t *lock) {
+    if (atomic_exchange_explicit(&lock->state, 0, memory_order_release) == 2)
+        _stdthrd_futex_wake_(&lock->state, 1);
+}
+
+void lock_ticket_init(lock_ticket_t *lock) {
+    atomic_init(&lock->next, 0);
+    atomic_init(&lock->serving, 0);
+}
+
+void lock_ticket_lock(lock_ticket_t *lock) {
+    const uint32_t ticket = atomic_fetch_add_explicit(&lock->next, 1, memory_order_relaxed);
+    for (unsigned round = 0;; round++) {
+        const uint32_t serving = atomic_load_explicit(&lock->serving, memory_order_acquire);
+        if (serving == ticket)
+            return;
+        if (round < _STDTHRD_YIELD_AFTER_) {
+            for (uint32_t i = 0; i < (ticket - serving) * 8; i++) {
+                _stdthrd_pause_();
+            }
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+void lock_ticket_unlock(lock_ticket_t *lock) {
+    const uint32_t serving = atomic_load_explicit(&lock->serving, memory_order_relaxed);
+    atomic_store_explicit(&lock->serving, serving + 1, memory_order_release);
+}
+
+void lock_mcs_init(lock_mcs_t *lock) {
+    atomic_init(&lock->tail, NULL);
+}
+
+void lock_mcs_lock(lock_mcs_t *lock, lock_mcs_node_t *node) {
+    atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+    atomic_store_explicit(&node->wait, 1, memory_order_relaxed);
+    lock_mcs_node_t *prev = atomic_exchange_explicit(&lock->tail, node, memory_order_acq_rel);
+    if (!prev)
+        return;
+    atomic_store_explicit(&prev->next, node, memory_order_release);
+
+    for (int i = 0; i < _STDTHRD_SPIN_; i++) {
+        if (atomic_load_explicit(&node->wait, memory_order_acquire) == 0)
+            return;
+        _stdthrd_pause_();
+    }
+    uint32_t wait = 1;
+    if (!atomic_compare_exchange_strong_explicit(
+            &node->wait, &wait, 2, memory_order_acquire, memory_order_acquire
+        ))
+        return;
+    while (atomic_load_explicit(&node->wait, memory_order_acquire) != 0) {
+        _stdthrd_futex_wait_(&node->wait, 2);
+    }
+}
+
+void lock_mcs_unlock(lock_mcs_t *lock, lock_mcs_node_t *node) {
+    lock_mcs_node_t *next = atomic_load_explicit(&node->next, memory_order_acquire);
+    if (!next) {
+        lock_mcs_node_t *expected = node;
+        if (atomic_compare_exchange_strong_explicit(
+                &lock->tail, &expected, NULL, memory_order_release, memory_order_relaxed
+            ))
+            return;
+        /* Um sucessor entrou na fila mas ainda não se ligou a nós. */
+        while (!(next = atomic_load_explicit(&node->next, memory_order_acquire))) {
+            _stdthrd_pause_();
+        }
+    }
+    if (atomic_exchange_explicit(&next->wait, 0, memory_order_release) == 2)
+        _stdthrd_futex_wake_(&next->wait, 1);
+}
+
+void lock_seq_init(lock_seq_t *lock) {
+    atomic_init(&lock->seq, 0);
+    lock_mutex_init(&lock->writer);
+}
+
+uint32_t lock_seq_read_begin(lock_seq_t *lock) {
+    for (unsigned round = 0;; round++) {
+        const uint32_t seq = atomic_load_explicit(&lock->seq, memory_order_acquire);
+        if (!(seq & 1))
+            return seq;
+        if (round < _STDTHRD_YIELD_AFTER_)
+            _stdthrd_pause_();
+        else
+            sched_yield();
+    }
+}
+
+bool lock_seq_read_retry(lock_seq_t *lock, uint32_t start) {
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&lock->seq, memory_order_relaxed) != start;
+}
+
+void lock_seq_write_begin(lock_seq_t *lock) {
+    lock_mutex_lock(&lock->writer);
+    const uint32_t seq = atomic_load_explicit(&lock->seq, memory_order_relaxed);
+    atomic_store_explicit(&lock->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+void lock_seq_write_end(lock_seq_t *lock) {
+    const uint32_t seq = atomic_load_explicit(&lock->seq, memory_order_relaxed);
+    atomic_store_explicit(&lock->seq, seq + 1, memory_order_release);
+    lock_mutex_unlock(&lock->writer);
+}
+
+void lock_seq_read(lock_seq_t *lock, void *dst, const void *src, size_t size) {
+    uint32_t start;
+    do {
+        start = lock_seq_read_begin(lock);
+        memcpy(dst, src, size);
+    } while (lock_seq_read_retry(lock, start));
+}
+
+void lock_seq_write(lock_seq_t *lock, void *dst, const void *src, size_t size) {
+    lock_seq_write_begin(lock);
+    memcpy(dst, src, size);
+    lock_seq_write_end(lock);
+}
+
+static _Thread_local unsigned _stdthrd_cpu_hint_ = UINT_MAX;
+static atomic_uint _stdthrd_cpu_next_;
+
+/* Núcleo da thread na primeira chamada; fixo depois (o unlock
+ * precisa decrementar o mesmo slot que o lock incrementou). */
+static unsigned _stdthrd_cpu_(void) {
+    if (_stdthrd_cpu_hint_ == UINT_MAX) {
+        int cpu = -1;
+#if defined(__linux__)
+        cpu = sched_getcpu();
+#endif
+        _stdthrd_cpu_hint_ = cpu >= 0 ? (unsigned)cpu
+                                      : atomic_fetch_add_explicit(
+                                            &_stdthrd_cpu_next_, 1, memory_order_relaxed
+                                        );
+    }
+    return _stdthrd_cpu_hint_;
+}
+
+bool lock_rw_init(lock_rw_t *lock, unsigned slots) {
+    if (!lock)
+        return false;
+    const unsigned want = slots ? slots : _stdthrd_cpu_count_();
+    unsigned size = 1;
+    while (size < want)
+        size <<= 1;
+    lock->slots = aligned_alloc(64, size * sizeof(lock_rw_slot_t));
+    if (!lock->slots)
+        return false;
+    for (unsigned i = 0; i < size; i++) {
+        atomic_init(&lock->slots[i].readers, 0);
+    }
+    lock->size = size;
+    lock_mutex_init(&lock->writer);
+    atomic_init(&lock->pending, 0);
+    return true;
+}
+
+void lock_rw_free(lock_rw_t *lock) {
+    if (!lock)
+        return;
+    free(lock->slots);
+    lock->slots = NULL;
+}
+
+void lock_rw_read_lock(lock_rw_t *lock) {
+    _Atomic uint32_t *readers = &lock->slots[_stdthrd_cpu_() & (lock->size - 1)].readers;
+    for (;;) {
+        atomic_fetch_add_explicit(readers, 1, memory_order_seq_cst);
+        if (atomic_load_explicit(&lock->pending, memory_order_seq_cst) == 0)
+            return;
+        /* Escritor ativo ou aguardando: recua e espera a vez dele. */
+        atomic_fetch_sub_explicit(readers, 1, memory_order_release);
+        for (int i = 0; i < _STDTHRD_SPIN_; i++) {
+            if (atomic_load_explicit(&lock->pending, memory_order_acquire) == 0)
+                break;
+            _stdthrd_pause_();
+        }
+        /* Só dorme em 2: um novo escritor pode ter gravado 1 depois do
+         * último wake, então a marca é refeita a cada volta. */
+        for (;;) {
+            uint32_t pending = 1;
+            if (!atomic_compare_exchange_strong_explicit(
+                    &lock->pending, &pending, 2, memory_order_acquire, memory_order_acquire
+                ) &&
+                pending == 0)
+                break;
+            _stdthrd_futex_wait_(&lock->pending, 2);
+        }
+    }
+}
+
+void lock_rw_read_unlock(lock_rw_t *lock) {
+    atomic_fetch_sub_explicit(
+        &lock->slots[_stdthrd_cpu_() & (lock->size - 1)].readers, 1, memory_order_release
+    );
+}
+
+void lock_rw_write_lock(lock_rw_t *lock) {
+    lock_mutex_lock(&lock->writer);
+    atomic_store_explicit(&lock->pending, 1, memory_order_seq_cst);
+    for (unsigned i = 0; i < lock->size; i++) {
+        _Atomic uint32_t *readers = &lock->slots[i].readers;
+        unsigned delay = 1, round = 0;
+        while (atomic_load_explicit(readers, memory_order_seq_cst) != 0) {
+            if (++round < _STDTHRD_YIELD_AFTER_)
+                _stdthrd_backoff_(&delay);
+            else
+                sched_yield();
+        }
+    }
+}
+
+void lock_rw_write_unlock(lock_rw_t *lock) {
+    if (atomic_exchange_explicit(&lock->pending, 0, memory_order_release) == 2)
+        _stdthrd_futex_wake_(&lock->pending, INT_MAX);
+    lock_mutex_unlock(&lock->writer);
+}
@@ -0,0 +1,719 @@
+/* ==========================================================================
+ * STDFRIGO STATISTICAL BATTERY (stdrand)
+ * ==========================================================================
+ * Compilar: make battery
+ *           make battery BATTERY_ARGS="--scale 64 --csv"
+ * Opções:   --scale N     Multiplica o número de blocos (padrão 1)
+ *           --threads N   Threads de trabalho (padrão: núcleos online)
+ *           --seed N      Seed base (padrão fixo, resultado reprodutível)
+ *           --csv         Saída CSV em vez de tabela
+ *
+ * Subconjunto de testes do SmallCrush (TestU01), PractRand e NIST
+ * SP 800-22, sem dependências externas. Cada teste é dividido em
+ * blocos independentes (sub-fluxos obtidos por *_jump) que rodam em
+ * paralelo; as contagens são somadas antes do p-valor, então o
+ * resultado não depende do número de threads.
+ *
+ * Veredito (convenção do TestU01): p fora de [1e-3, 1 - 1e-3] é
+ * "suspeito"; fora de [1e-10, 1 - 1e-10] é "FALHA" (código de saída 1).
+ * ========================================================================== */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "stdrand.h"
+
+#define BAT_SEED 0x9e3779b97f4a7c15ULL
+#define BAT_ACCUM 72
+#define BAT_STREAMS 4
+
+/* ===============================================================
+ * FONTES (Geradores sob Teste)
+ * ===============================================================
+ * Cada fonte entrega `bits` bits significativos na parte baixa de
+ * um uint64_t. rand_float/rand_double expõem a mantissa inteira
+ * (24/53 bits). As fontes "x4" intercalam 4 fluxos separados por
+ * jump, expondo correlação entre sub-fluxos paralelos.
+ * =============================================================== */
+
+typedef enum bat_kind {
+    BAT_R32,
+    BAT_R64,
+    BAT_RF,
+    BAT_RD,
+    BAT_WY,
+    BAT_R32_X4,
+    BAT_R64_X4,
+    BAT_KINDS,
+} bat_kind_t;
+
+typedef struct bat_src {
+    bat_kind_t kind;
+    unsigned bits;
+    unsigned turn;
+    unsigned unit_bits;
+    double unit_scale;
+    uint64_t draws;
+    union {
+        rand32_t r32[BAT_STREAMS];
+        rand64_t r64[BAT_STREAMS];
+        rand_float_t rf;
+        rand_double_t rd;
+        rand_wy_t wy;
+    } u;
+} bat_src_t;
+
+static const char *const bat_src_name[BAT_KINDS] = {
+    "rand32", "rand64", "rand_float", "rand_double", "rand_wy", "rand32 x4 jump", "rand64 x4 jump",
+};
+
+static const unsigned bat_src_bits[BAT_KINDS] = {32, 64, 24, 53, 64, 32, 64};
+
+static void bat_src_init(bat_src_t *src, bat_kind_t kind, uint64_t seed, size_t chunk) {
+    memset(src, 0, sizeof(*src));
+    src->kind = kind;
+    src->bits = bat_src_bits[kind];
+    src->unit_bits = src->bits < 53 ? src->bits : 53;
+    src->unit_scale = ldexp(1.0, -(int)src->unit_bits);
+
+    switch (kind) {
+    case BAT_R32:
+        src->u.r32[0] = rand32_init(seed);
+        for (size_t j = 0; j < chunk; j++)
+            rand32_jump(&src->u.r32[0]);
+        break;
+    case BAT_R64:
+        src->u.r64[0] = rand64_init(seed);
+        for (size_t j = 0; j < chunk; j++)
+            rand64_jump(&src->u.r64[0]);
+        break;
+    case BAT_RF:
+        src->u.rf = rand_float_init(seed);
+        for (size_t j = 0; j < chunk; j++)
+            rand_float_jump(&src->u.rf);
+        break;
+    case BAT_RD:
+        src->u.rd = rand_double_init(seed);
+        for (size_t j = 0; j < chunk; j++)
+            rand_double_jump(&src->u.rd);
+        break;
+    case BAT_WY:
+        src->u.wy = rand_wy_init(seed);
+        for (size_t j = 0; j < chunk; j++)
+            rand_wy_jump(&src->u.wy);
+        break;
+    case BAT_R32_X4:
+        src->u.r32[0] = rand32_init(seed);
+        for (size_t j = 0; j < chunk * BAT_STREAMS; j++)
+            rand32_jump(&src->u.r32[0]);
+        for (int i = 1; i < BAT_STREAMS; i++) {
+            src->u.r32[i] = src->u.r32[i - 1];
+            rand32_jump(&src->u.r32[i]);
+        }
+        break;
+    case BAT_R64_X4:
+        src->u.r64[0] = rand64_init(seed);
+        for (size_t j = 0; j < chunk * BAT_STREAMS; j++)
+            rand64_jump(&src->u.r64[0]);
+        for (int i = 1; i < BAT_STREAMS; i++) {
+            src->u.r64[i] = src->u.r64[i - 1];
+            rand64_jump(&src->u.r64[i]);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static inline uint64_t bat_next(bat_src_t *src) {
+    src->draws++;
+    switch (src->kind) {
+    case BAT_R32:
+        return rand32_next(&src->u.r32[0]);
+    case BAT_R64:
+        return rand64_next(&src->u.r64[0]);
+    case BAT_RF:
+        return (uint64_t)(rand_float_next(&src->u.rf) * 0x1.0p24f);
+    case BAT_RD:
+        return (uint64_t)(rand_double_next(&src->u.rd) * 0x1.0p53);
+    case BAT_WY:
+        return rand_wy_next(&src->u.wy);
+    case BAT_R32_X4:
+        return rand32_next(&src->u.r32[src->turn++ % BAT_STREAMS]);
+    case BAT_R64_X4:
+        return rand64_next(&src->u.r64[src->turn++ % BAT_STREAMS]);
+    default:
+        return 0;
+    }
+}
+
+/* Os k bits mais significativos da saída (k <= bits). */
+static inline uint64_t bat_top(bat_src_t *src, unsigned k) {
+    return bat_next(src) >> (src->bits - k);
+}
+
+/* Uniforme em [0, 1) com até 53 bits. */
+static inline double bat_unit(bat_src_t *src) {
+    return (double)bat_top(src, src->unit_bits) * src->unit_scale;
+}
+
+/* ===============================================================
+ * FUNÇÕES DE DISTRIBUIÇÃO (p-valores)
+ * =============================================================== */
+
+/* Gama incompleta regularizada superior Q(a, x) (série / fração contínua). */
+static double bat_gamma_q(double a, double x) {
+    if (x <= 0.0)
+        return 1.0;
+    const double lg = a * log(x) - x - lgamma(a);
+
+    if (x < a + 1.0) {
+        double sum = 1.0 / a, term = sum, ap = a;
+        for (int i = 0; i < 1000; i++) {
+            ap += 1.0;
+            term *= x / ap;
+            sum += term;
+            if (fabs(term) < fabs(sum) * 1e-15)
+                break;
+        }
+        return 1.0 - sum * exp(lg);
+    }
+
+    double b = x + 1.0 - a, c = 1.0 / 1e-300, d = 1.0 / b, h = d;
+    for (int i = 1; i < 1000; i++) {
+        const double an = -i * (i - a);
+        b += 2.0;
+        d = an * d + b;
+        if (fabs(d) < 1e-300)
+            d = 1e-300;
+        c = b + an / c;
+        if (fabs(c) < 1e-300)
+            c = 1e-300;
+        d = 1.0 / d;
+        const double del = d * c;
+        h *= del;
+        if (fabs(del - 1.0) < 1e-15)
+            break;
+    }
+    return exp(lg) * h;
+}
+
+static double bat_chi2_p(const double *obs, const double *expect, size_t cells, size_t df) {
+    double chi2 = 0.0;
+    for (size_t i = 0; i < cells; i++) {
+        const double diff = obs[i] - expect[i];
+        chi2 += diff * diff / expect[i];
+    }
+    return bat_gamma_q((double)df / 2.0, chi2 / 2.0);
+}
+
+/* P(Y >= y) para Y ~ Poisson(lambda). */
+static double bat_poisson_upper(double y, double lambda) {
+    if (y <= 0.0)
+        return 1.0;
+    return 1.0 - bat_gamma_q(y, lambda);
+}
+
+/* P(Z >= z) para Z ~ N(0, 1). */
+static double bat_normal_upper(double z) {
+    return 0.5 * erfc(z / sqrt(2.0));
+}
+
+/* ===============================================================
+ * 1. BIRTHDAY SPACINGS (Marsaglia)
+ * ===============================================================
+ * m = 2^12 aniversários em um ano de 2^32 dias; cada dia junta os
+ * 16 bits do topo de duas saídas consecutivas (versão 2-D, que expõe
+ * a estrutura de reticulado de LCGs). O número de espaçamentos
+ * repetidos segue Poisson(m^3 / 4n) = Poisson(4).
+ * accum: [0] repetições observadas, [1] lambda acumulado.
+ * =============================================================== */
+
+#define BAT_BDAY_REPS 64
+#define BAT_BDAY_HALF 16
+#define BAT_BDAY_LOG_M 12
+
+/* Radix sort LSD de 32 bits (4 passadas de 8 bits). */
+static void bat_radix_sort(uint32_t *a, uint32_t *tmp, size_t n) {
+    for (unsigned shift = 0; shift < 32; shift += 8) {
+        size_t count[257] = {0};
+        for (size_t i = 0; i < n; i++)
+            count[((a[i] >> shift) & 0xff) + 1]++;
+        for (int d = 0; d < 256; d++)
+            count[d + 1] += count[d];
+        for (size_t i = 0; i < n; i++)
+            tmp[count[(a[i] >> shift) & 0xff]++] = a[i];
+        memcpy(a, tmp, n * sizeof(uint32_t));
+    }
+}
+
+static void bat_birthday_run(bat_src_t *src, double *accum) {
+    const size_t m = (size_t)1 << BAT_BDAY_LOG_M;
+    uint32_t day[(size_t)1 << BAT_BDAY_LOG_M], tmp[(size_t)1 << BAT_BDAY_LOG_M];
+
+    for (int rep = 0; rep < BAT_BDAY_REPS; rep++) {
+        for (size_t i = 0; i < m; i++) {
+            const uint32_t hi = (uint32_t)bat_top(src, BAT_BDAY_HALF);
+            day[i] = (hi << BAT_BDAY_HALF) | (uint32_t)bat_top(src, BAT_BDAY_HALF);
+        }
+        bat_radix_sort(day, tmp, m);
+
+        /* Espaçamentos circulares: a aritmética mod 2^32 fecha o ano. */
+        const uint32_t first = day[0];
+        for (size_t i = 0; i + 1 < m; i++)
+            day[i] = day[i + 1] - day[i];
+        day[m - 1] = first - day[m - 1];
+        bat_radix_sort(day, tmp, m);
+
+        for (size_t i = 1; i < m; i++)
+            accum[0] += day[i] == day[i - 1];
+        accum[1] += ldexp(1.0, 3 * BAT_BDAY_LOG_M - 2 * BAT_BDAY_HALF - 2);
+    }
+}
+
+static double bat_birthday_p(const double *accum, unsigned bits) {
+    (void)bits;
+    return bat_poisson_upper(accum[0], accum[1]);
+}
+
+/* ===============================================================
+ * 2. GAP TEST (Knuth)
+ * ===============================================================
+ * Comprimento das lacunas entre visitas a [0, 1/8).
+ * P(lacuna = j) = p (1 - p)^j; a última célula agrega j >= 48.
+ * =============================================================== */
+
+#define BAT_GAP_CELLS 48
+#define BAT_GAP_COUNT (1u << 17)
+
+static void bat_gap_run(bat_src_t *src, double *accum) {
+    for (uint32_t g = 0; g < BAT_GAP_COUNT; g++) {
+        unsigned len = 0;
+        while (bat_unit(src) >= 0.125)
+            len++;
+        accum[len < BAT_GAP_CELLS ? len : BAT_GAP_CELLS] += 1.0;
+    }
+}
+
+static double bat_gap_p(const double *accum, unsigned bits) {
+    (void)bits;
+    double expect[BAT_GAP_CELLS + 1], total = 0.0;
+    for (int i = 0; i <= BAT_GAP_CELLS; i++)
+        total += accum[i];
+    for (int i = 0; i < BAT_GAP_CELLS; i++)
+        expect[i] = total * 0.125 * pow(0.875, i);
+    expect[BAT_GAP_CELLS] = total * pow(0.875, BAT_GAP_CELLS);
+    return bat_chi2_p(accum, expect, BAT_GAP_CELLS + 1, BAT_GAP_CELLS);
+}
+
+/* ===============================================================
+ * 3. MAXIMUM-OF-T (Knuth)
+ * ===============================================================
+ * max(u1..u8)^8 é uniforme; histograma em 64 classes.
+ * =============================================================== */
+
+#define BAT_MAXT_T 8
+#define BAT_MAXT_BINS 64
+#define BAT_MAXT_COUNT (1u << 17)
+
+static void bat_maxt_run(bat_src_t *src, double *accum) {
+    for (uint32_t g = 0; g < BAT_MAXT_COUNT; g++) {
+        double best = 0.0;
+        for (int i = 0; i < BAT_MAXT_T; i++) {
+            const double u = bat_unit(src);
+            best = u > best ? u : best;
+        }
+        const double v = pow(best, BAT_MAXT_T);
+        const int bin = (int)(v * BAT_MAXT_BINS);
+        accum[bin < BAT_MAXT_BINS ? bin : BAT_MAXT_BINS - 1] += 1.0;
+    }
+}
+
+static double bat_maxt_p(const double *accum, unsigned bits) {
+    (void)bits;
+    double expect[BAT_MAXT_BINS], total = 0.0;
+    for (int i = 0; i < BAT_MAXT_BINS; i++)
+        total += accum[i];
+    for (int i = 0; i < BAT_MAXT_BINS; i++)
+        expect[i] = total / BAT_MAXT_BINS;
+    return bat_chi2_p(accum, expect, BAT_MAXT_BINS, BAT_MAXT_BINS - 1);
+}
+
+/* ===============================================================
+ * 4. MATRIX RANK (GF(2), bits baixos)
+ * ===============================================================
+ * Matrizes LxL (L = min(bits, 32)) com uma saída por linha.
+ * Classes: posto L, L-1, L-2 e <= L-3.
+ * =============================================================== */
+
+#define BAT_RANK_COUNT (1u << 13)
+
+static unsigned bat_rank_l(unsigned bits) {
+    return bits < 32 ? bits : 32;
+}
+
+static unsigned bat_gf2_rank(uint32_t *row, unsigned n) {
+    unsigned rank = 0;
+    for (unsigned col = 0; col < n && rank < n; col++) {
+        unsigned pivot = rank;
+        while (pivot < n && !((row[pivot] >> col) & 1))
+            pivot++;
+        if (pivot == n)
+            continue;
+        const uint32_t tmp = row[pivot];
+        row[pivot] = row[rank];
+        row[rank] = tmp;
+        for (unsigned r = rank + 1; r < n; r++)
+            row[r] ^= tmp & (0u - ((row[r] >> col) & 1));
+        rank++;
+    }
+    return rank;
+}
+
+static void bat_rank_run(bat_src_t *src, double *accum) {
+    const unsigned n = bat_rank_l(src->bits);
+    const uint64_t mask = (UINT64_C(1) << n) - 1;
+    uint32_t row[32];
+
+    for (uint32_t g = 0; g < BAT_RANK_COUNT; g++) {
+        for (unsigned i = 0; i < n; i++)
+            row[i] = (uint32_t)(bat_next(src) & mask);
+        const unsigned deficit = n - bat_gf2_rank(row, n);
+        accum[deficit < 3 ? deficit : 3] += 1.0;
+    }
+}
+
+static double bat_rank_prob(unsigned n, unsigned r) {
+    double p = ldexp(1.0, (int)(r * (2 * n - r)) - (int)(n * n));
+    for (unsigned i = 0; i < r; i++) {
+        const double a = 1.0 - ldexp(1.0, (int)i - (int)n);
+        p *= a * a / (1.0 - ldexp(1.0, (int)i - (int)r));
+    }
+    return p;
+}
+
+static double bat_rank_p(const double *accum, unsigned bits) {
+    const unsigned n = bat_rank_l(bits);
+    const double total = accum[0] + accum[1] + accum[2] + accum[3];
+    double expect[4];
+    expect[0] = total * bat_rank_prob(n, n);
+    expect[1] = total * bat_rank_prob(n, n - 1);
+    expect[2] = total * bat_rank_prob(n, n - 2);
+    expect[3] = total - expect[0] - expect[1] - expect[2];
+    return bat_chi2_p(accum, expect, 4, 3);
+}
+
+/* ===============================================================
+ * 5. LINEAR COMPLEXITY (NIST SP 800-22, bit menos significativo)
+ * ===============================================================
+ * Berlekamp-Massey em blocos de M = 500 bits. Detecta bits baixos
+ * que são LFSRs (ex.: bit 0 dos geradores "+").
+ * =============================================================== */
+
+#define BAT_LC_M 500
+#define BAT_LC_BLOCKS 64
+#define BAT_LC_WORDS (BAT_LC_M / 64 + 2)
+
+/* 64 bits de v a partir da posição pos (v tem uma palavra de folga). */
+static inline uint64_t bat_lc_window(const uint64_t *v, unsigned pos) {
+    const unsigned q = pos / 64, r = pos % 64;
+    return r ? (v[q] >> r) | (v[q + 1] << (64 - r)) : v[q];
+}
+
+/* Berlekamp-Massey empacotado: rev tem o bit k = s[n - 1 - k], então
+ * s[i - j] (j = 0..l) é uma janela contígua a partir de n - 1 - i. */
+static unsigned bat_berlekamp_massey(const uint64_t *rev, unsigned n) {
+    uint64_t c[BAT_LC_WORDS] = {1}, b[BAT_LC_WORDS] = {1}, t[BAT_LC_WORDS];
+    unsigned l = 0;
+    int m = -1;
+
+    for (unsigned i = 0; i < n; i++) {
+        const unsigned start = n - 1 - i;
+        uint64_t acc = 0;
+        for (unsigned w = 0; w <= l / 64; w++)
+            acc ^= c[w] & bat_lc_window(rev, start + 64 * w);
+        if (!(__builtin_popcountll(acc) & 1))
+            continue;
+
+        memcpy(t, c, sizeof(t));
+        const unsigned shift = (unsigned)((int)i - m), q = shift / 64, r = shift % 64;
+        for (unsigned w = BAT_LC_WORDS; w-- > q;) {
+            uint64_t v = b[w - q] << r;
+            if (r && w > q)
+                v |= b[w - q - 1] >> (64 - r);
+            c[w] ^= v;
+        }
+        if (2 * l <= i) {
+            l = i + 1 - l;
+            m = (int)i;
+            memcpy(b, t, sizeof(b));
+        }
+    }
+    return l;
+}
+
+static void bat_lc_run(bat_src_t *src, double *accum) {
+    for (int blk = 0; blk < BAT_LC_BLOCKS; blk++) {
+        uint64_t rev[BAT_LC_WORDS + 1] = {0};
+        for (unsigned i = 0; i < BAT_LC_M; i++) {
+            const unsigned k = BAT_LC_M - 1 - i;
+            rev[k / 64] |= (bat_next(src) & 1) << (k % 64);
+        }
+        const double t = (double)bat_berlekamp_massey(rev, BAT_LC_M) - BAT_LC_M / 2.0;
+        int cell;
+        if (t <= -2.5)
+            cell = 0;
+        else if (t >= 2.5)
+            cell = 6;
+        else
+            cell = (int)floor(t + 3.5);
+        accum[cell] += 1.0;
+    }
+}
+
+static double bat_lc_p(const double *accum, unsigned bits) {
+    (void)bits;
+    static const double pi[7] = {0.010417, 0.03125, 0.125, 0.5, 0.25, 0.0625, 0.020833};
+    double expect[7], total = 0.0;
+    for (int i = 0; i < 7; i++)
+        total += accum[i];
+    for (int i = 0; i < 7; i++)
+        expect[i] = total * pi[i];
+    return bat_chi2_p(accum, expect, 7, 6);
+}
+
+/* ===============================================================
+ * 6. BIT FREQUENCY (por posição)
+ * ===============================================================
+ * Soma de z^2 da contagem de uns em cada posição de bit.
+ * accum: [0..bits) uns por posição, [64] amostras.
+ * =============================================================== */
+
+#define BAT_FREQ_COUNT (1u << 18)
+
+/* Contadores SWAR: lane[b] guarda, no byte j, os uns do bit 8j + b. */
+static void bat_freq_run(bat_src_t *src, double *accum) {
+    const uint64_t low = 0x0101010101010101ULL;
+    for (uint32_t g = 0; g < BAT_FREQ_COUNT; g += 255) {
+        uint64_t lane[8] = {0};
+        const uint32_t batch = BAT_FREQ_COUNT - g < 255 ? BAT_FREQ_COUNT - g : 255;
+        for (uint32_t i = 0; i < batch; i++) {
+            const uint64_t x = bat_next(src);
+            for (unsigned b = 0; b < 8; b++)
+                lane[b] += (x >> b) & low;
+        }
+        for (unsigned b = 0; b < 8; b++) {
+            for (unsigned j = 0; j < 8; j++)
+                accum[8 * j + b] += (double)((lane[b] >> (8 * j)) & 0xff);
+        }
+    }
+    accum[64] += BAT_FREQ_COUNT;
+}
+
+static double bat_freq_p(const double *accum, unsigned bits) {
+    const double n = accum[64];
+    double chi2 = 0.0;
+    for (unsigned b = 0; b < bits; b++) {
+        const double diff = 2.0 * accum[b] - n;
+        chi2 += diff * diff / n;
+    }
+    return bat_gamma_q(bits / 2.0, chi2 / 2.0);
+}
+
+/* ===============================================================
+ * 7. HAMMING CORRELATION (L'Ecuyer, HammingCorr)
+ * ===============================================================
+ * Correlação entre o peso de Hamming de saídas consecutivas.
+ * accum: [0] soma dos produtos centrados, [1] pares.
+ * =============================================================== */
+
+#define BAT_HAM_COUNT (1u << 18)
+
+static void bat_hamming_run(bat_src_t *src, double *accum) {
+    const double half = src->bits / 2.0;
+    double prev = __builtin_popcountll(bat_next(src)) - half;
+    for (uint32_t g = 0; g < BAT_HAM_COUNT; g++) {
+        const double cur = __builtin_popcountll(bat_next(src)) - half;
+        accum[0] += prev * cur;
+        prev = cur;
+    }
+    accum[1] += BAT_HAM_COUNT;
+}
+
+static double bat_hamming_p(const double *accum, unsigned bits) {
+    const double z = accum[0] / (sqrt(accum[1]) * bits / 4.0);
+    return bat_normal_upper(z);
+}
+
+/* ===============================================================
+ * TABELA DE TESTES
+ * =============================================================== */
+
+typedef struct bat_test {
+    const char *name;
+    void (*run)(bat_src_t *src, double *accum);
+    double (*pvalue)(const double *accum, unsigned bits);
+    size_t chunks;
+} bat_test_t;
+
+static const bat_test_t bat_tests[] = {
+    {"birthday_spacings", bat_birthday_run, bat_birthday_p, 4},
+    {"gap", bat_gap_run, bat_gap_p, 4},
+    {"max_of_t", bat_maxt_run, bat_maxt_p, 4},
+    {"matrix_rank", bat_rank_run, bat_rank_p, 4},
+    {"linear_complexity", bat_lc_run, bat_lc_p, 8},
+    {"bit_frequency", bat_freq_run, bat_freq_p, 4},
+    {"hamming_corr", bat_hamming_run, bat_hamming_p, 4},
+};
+
+#define BAT_TESTS (sizeof(bat_tests) / sizeof(bat_tests[0]))
+
+/* ===============================================================
+ * EXECUÇÃO PARALELA
+ * ===============================================================
+ * Um job = (gerador, teste, bloco). Threads pegam jobs por um
+ * contador atômico; cada job tem seu acumulador privado.
+ * =============================================================== */
+
+typedef struct bat_job {
+    bat_kind_t kind;
+    size_t test;
+    size_t chunk;
+    uint64_t draws;
+    double accum[BAT_ACCUM];
+} bat_job_t;
+
+typedef struct bat_ctx {
+    bat_job_t *jobs;
+    size_t count;
+    uint64_t seed;
+    atomic_size_t next;
+} bat_ctx_t;
+
+static void *bat_worker(void *arg) {
+    bat_ctx_t *ctx = arg;
+    for (;;) {
+        const size_t i = atomic_fetch_add_explicit(&ctx->next, 1, memory_order_relaxed);
+        if (i >= ctx->count)
+            break;
+        bat_job_t *job = &ctx->jobs[i];
+        bat_src_t src;
+        bat_src_init(&src, job->kind, ctx->seed, job->chunk);
+        bat_tests[job->test].run(&src, job->accum);
+        job->draws = src.draws;
+    }
+    return NULL;
+}
+
+static const char *bat_verdict(double p) {
+    if (p < 1e-10 || p > 1.0 - 1e-10)
+        return "FALHA";
+    if (p < 1e-3 || p > 1.0 - 1e-3)
+        return "suspeito";
+    return "ok";
+}
+
+int main(int argc, char **argv) {
+    size_t scale = 1;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t seed = BAT_SEED;
+    bool csv = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc) {
+            scale = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else {
+            fprintf(stderr, "uso: %s [--scale N] [--threads N] [--seed N] [--csv]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (scale < 1)
+        scale = 1;
+    if (threads < 1)
+        threads = 1;
+
+    bat_ctx_t ctx = {.seed = seed};
+    for (size_t t = 0; t < BAT_TESTS; t++)
+        ctx.count += BAT_KINDS * bat_tests[t].chunks * scale;
+    ctx.jobs = calloc(ctx.count, sizeof(bat_job_t));
+    if (!ctx.jobs)
+        return 2;
+    atomic_init(&ctx.next, 0);
+
+    /* Blocos de ordem alta primeiro: pagam mais jumps até o sub-fluxo. */
+    size_t j = 0;
+    for (size_t t = 0; t < BAT_TESTS; t++) {
+        const size_t chunks = bat_tests[t].chunks * scale;
+        for (int k = 0; k < BAT_KINDS; k++) {
+            for (size_t c = 0; c < chunks; c++) {
+                ctx.jobs[j].kind = (bat_kind_t)k;
+                ctx.jobs[j].test = t;
+                ctx.jobs[j].chunk = chunks - 1 - c;
+                j++;
+            }
+        }
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    pthread_t *tid = malloc((size_t)threads * sizeof(pthread_t));
+    if (!tid)
+        return 2;
+    long started = 0;
+    for (; started < threads; started++) {
+        if (pthread_create(&tid[started], NULL, bat_worker, &ctx) != 0)
+            break;
+    }
+    if (started == 0)
+        bat_worker(&ctx);
+    for (long i = 0; i < started; i++)
+        pthread_join(tid[i], NULL);
+    free(tid);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    uint64_t draws = 0;
+    int failures = 0;
+    if (csv)
+        printf("generator,test,p_value,verdict\n");
+
+    for (int k = 0; k < BAT_KINDS; k++) {
+        for (size_t t = 0; t < BAT_TESTS; t++) {
+            double accum[BAT_ACCUM] = {0};
+            for (size_t i = 0; i < ctx.count; i++) {
+                const bat_job_t *job = &ctx.jobs[i];
+                if (job->kind != (bat_kind_t)k || job->test != t)
+                    continue;
+                for (int a = 0; a < BAT_ACCUM; a++)
+                    accum[a] += job->accum[a];
+                draws += job->draws * ((bat_src_bits[k] + 7) / 8);
+            }
+            const double p = bat_tests[t].pvalue(accum, bat_src_bits[k]);
+            const char *verdict = bat_verdict(p);
+            failures += strcmp(verdict, "FALHA") == 0;
+            if (csv)
+                printf("%s,%s,%.6g,%s\n", bat_src_name[k], bat_tests[t].name, p, verdict);
+            else
+                printf("%-16s %-18s %-12.4g %s\n", bat_src_name[k], bat_tests[t].name, p, verdict);
+        }
+    }
+
+    const double secs = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    fprintf(
+        stderr, "\n%d geradores x %zu testes, %ld threads: %.2f GB em %.2f s (%.2f GB/s)\n",
+        BAT_KINDS, BAT_TESTS, threads, (double)draws / 1e9, secs, (double)draws / 1e9 / secs
+    );
+    free(ctx.jobs);
+    return failures ? 1 : 0;
+}
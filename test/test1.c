@@ -7,27 +7,28 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include <assert.h>
 #include <math.h>
 #include <inttypes.h>
+#include <time.h>
 
 /* Inclua seu cabeçalho principal ou os módulos individuais */
 #include "stdhash.h"
 #include "stdconst.h"
+#include "stdrand.h"
+#include "stdthrd.h"
+#include "stdmem.h"
+#include "stdsock.h"
+#include "stdprof.h"
 
-/* * MOCK STDRAND (Caso você ainda não tenha o stdrand.h implementado)
- * Se já tiver, troque isso por: #include "stdrand.h"
- */
-#ifndef STDRAND_H
-typedef struct { uint64_t state; } stdrand_t;
-static inline void rand_seed(stdrand_t *rng, uint64_t seed) { rng->state = seed; }
-static inline uint64_t rand_next(stdrand_t *rng) {
-    /* SplitMix64 simples para teste */
-    uint64_t z = (rng->state += 0x9e3779b97f4a7c15ULL);
-    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
-    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
-    return z ^ (z >> 31);
-}
+#ifdef __cplusplus
+#include "stdfrigo.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #endif
 
 /* ===============================================================
@@ -142,7 +143,7 @@ void test_hardware_accel(void) {
 void test_integration(void) {
     printf("\n>>> Testando Integração Rand+Hash...\n");
 
-    stdrand_t rng;
+    rand64_t rng;
     rand_seed(&rng, 12345); // Seed fixa
 
     uint64_t val = rand_next(&rng);
@@ -154,6 +155,1672 @@ void test_integration(void) {
     if (val != h) TEST_PASS("Pipeline Rand -> Hash funcionou");
 }
 
+/* ===============================================================
+ * 5. TESTE DE AMOSTRAGEM PONDERADA (stdrand alias)
+ * =============================================================== */
+void test_alias(void) {
+    printf("\n>>> Testando Alias Table...\n");
+
+    const double weights[] = {1.0, 0.0, 3.0, 4.0};
+    size_t counts[4] = {0};
+    size_t batch[256];
+    rand_alias_t table;
+    rand64_t rng = rand64_init(42);
+
+    assert(rand_alias_init(&table, weights, 4));
+    for (int i = 0; i < 1000; i++) {
+        rand_alias_fill(&table, &rng, batch, 256);
+        for (int j = 0; j < 256; j++) counts[batch[j]]++;
+    }
+    assert(counts[1] == 0);
+    assert(fabs((double)counts[3] / 256000.0 - 0.5) < 0.01);
+    TEST_PASS("rand_alias_fill respeita os pesos");
+
+    assert(rand_alias_update(&table, 1, 8.0));
+    assert(rand_alias_update(&table, 3, 0.0));
+    assert(rand_alias_rebuild(&table));
+    memset(counts, 0, sizeof(counts));
+    for (int i = 0; i < 100000; i++) counts[rand_alias_next(&table, &rng)]++;
+    assert(counts[3] == 0);
+    assert(fabs((double)counts[1] / 100000.0 - 8.0 / 12.0) < 0.01);
+    TEST_PASS("rand_alias_rebuild aplica pesos atualizados");
+
+    rand_alias_free(&table);
+}
+
+/* ===============================================================
+ * 6. TESTE DE RESERVATÓRIO (stdrand reservoir)
+ * =============================================================== */
+/* Soma de z² das contagens de inclusão contra as probabilidades
+ * exatas; nenhum item pode passar de 5 desvios. */
+static double _test_inclusion_chi2(const uint64_t *hits, const double *p, size_t n, uint64_t trials) {
+    double chi2 = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const double mean = (double)trials * p[i];
+        const double z = ((double)hits[i] - mean) / sqrt(mean * (1.0 - p[i]));
+        assert(fabs(z) < 5.0);
+        chi2 += z * z;
+    }
+    return chi2;
+}
+
+void test_reservoir(void) {
+    printf("\n>>> Testando Reservoir Sampling...\n");
+
+    uint64_t items[1000];
+    for (uint64_t i = 0; i < 1000; i++) items[i] = i;
+
+    rand_reservoir_t a, b;
+    assert(rand_reservoir_init(&a, 16, sizeof(uint64_t), 1));
+    assert(rand_reservoir_init(&b, 16, sizeof(uint64_t), 2));
+    rand_reservoir_offer(&a, items, 10);
+    assert(a.count == 10 && a.seen == 10);
+    rand_reservoir_offer(&a, items + 10, 490);
+    rand_reservoir_offer(&b, items + 500, 500);
+    assert(a.count == 16 && a.seen == 500);
+    assert(rand_reservoir_merge(&a, &b));
+    assert(a.count == 16 && a.seen == 1000);
+    for (size_t i = 0; i < a.count; i++) assert(((uint64_t *)a.items)[i] < 1000);
+    TEST_PASS("rand_reservoir_offer/merge mantêm k itens da união");
+    rand_reservoir_free(&a);
+    rand_reservoir_free(&b);
+
+    /* Cada um dos 100 itens deve entrar com probabilidade k/n = 0.1,
+     * num único reservatório (em lotes de 7) e após o merge de dois
+     * fluxos de tamanhos diferentes. */
+    const uint64_t trials = 20000;
+    static uint64_t single[100], merged[100];
+    double p_uniform[100];
+    for (int i = 0; i < 100; i++) p_uniform[i] = 0.1;
+    for (uint64_t t = 0; t < trials; t++) {
+        assert(rand_reservoir_init(&a, 10, sizeof(uint64_t), 2 * t + 1));
+        for (size_t i = 0; i < 100; i += 7) rand_reservoir_offer(&a, items + i, i + 7 < 100 ? 7 : 100 - i);
+        for (size_t i = 0; i < a.count; i++) single[((uint64_t *)a.items)[i]]++;
+        rand_reservoir_free(&a);
+
+        assert(rand_reservoir_init(&a, 10, sizeof(uint64_t), 2 * t + 2));
+        assert(rand_reservoir_init(&b, 10, sizeof(uint64_t), 2 * t + 3));
+        rand_reservoir_offer(&a, items, 60);
+        rand_reservoir_offer(&b, items + 60, 40);
+        assert(rand_reservoir_merge(&a, &b) && a.count == 10);
+        for (size_t i = 0; i < a.count; i++) merged[((uint64_t *)a.items)[i]]++;
+        rand_reservoir_free(&a);
+        rand_reservoir_free(&b);
+    }
+    const double bound = 100.0 + 6.0 * sqrt(200.0);
+    assert(_test_inclusion_chi2(single, p_uniform, 100, trials) < bound);
+    assert(_test_inclusion_chi2(merged, p_uniform, 100, trials) < bound);
+    TEST_PASS("Inclusão uniforme k/n com e sem merge (qui-quadrado)");
+
+    double weights[1000];
+    for (int i = 0; i < 1000; i++) weights[i] = i < 990 ? 0.0 : 1.0;
+    rand_wreservoir_t w;
+    assert(rand_wreservoir_init(&w, 8, sizeof(uint64_t), 3));
+    rand_wreservoir_offer(&w, items, weights, 1000);
+    assert(w.count == 8);
+    for (size_t i = 0; i < w.count; i++) assert(((uint64_t *)w.items)[i] >= 990);
+    TEST_PASS("rand_wreservoir_offer ignora itens de peso zero");
+    rand_wreservoir_free(&w);
+
+    /* k = 1 sobre 50 pesos distintos: P(i) = w_i / W exatamente. Metade
+     * do fluxo vai para cada reservatório antes do merge. */
+    rand_wreservoir_t w2;
+    static uint64_t hits1[50];
+    double p1[50], total = 0.0;
+    for (int i = 0; i < 50; i++) {
+        weights[i] = (double)(i % 5 + 1);
+        total += weights[i];
+    }
+    for (int i = 0; i < 50; i++) p1[i] = weights[i] / total;
+    for (uint64_t t = 0; t < 50000; t++) {
+        assert(rand_wreservoir_init(&w, 1, sizeof(uint64_t), 3 * t + 1));
+        assert(rand_wreservoir_init(&w2, 1, sizeof(uint64_t), 3 * t + 2));
+        rand_wreservoir_offer(&w, items, weights, 20);
+        rand_wreservoir_offer(&w2, items + 20, weights + 20, 30);
+        assert(rand_wreservoir_merge(&w, &w2) && w.count == 1);
+        hits1[((uint64_t *)w.items)[0]]++;
+        rand_wreservoir_free(&w);
+        rand_wreservoir_free(&w2);
+    }
+    assert(_test_inclusion_chi2(hits1, p1, 50, 50000) < 50.0 + 6.0 * sqrt(100.0));
+
+    /* k = 2 sobre 6 pesos: P(i) = p_i + soma_j p_j w_i / (W - w_j). */
+    const double w6[6] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    static uint64_t hits2[6];
+    double p2[6];
+    for (int i = 0; i < 6; i++) {
+        p2[i] = w6[i] / 21.0;
+        for (int j = 0; j < 6; j++) {
+            if (j != i)
+                p2[i] += w6[j] / 21.0 * w6[i] / (21.0 - w6[j]);
+        }
+    }
+    for (uint64_t t = 0; t < 50000; t++) {
+        assert(rand_wreservoir_init(&w, 2, sizeof(uint64_t), 3 * t + 3));
+        rand_wreservoir_offer(&w, items, w6, 6);
+        assert(w.count == 2);
+        for (size_t i = 0; i < w.count; i++) hits2[((uint64_t *)w.items)[i]]++;
+        rand_wreservoir_free(&w);
+    }
+    assert(_test_inclusion_chi2(hits2, p2, 6, 50000) < 6.0 + 6.0 * sqrt(12.0));
+    TEST_PASS("rand_wreservoir inclui cada item com a probabilidade exata dos pesos");
+}
+
+/* ===============================================================
+ * 7. TESTE DE ENTROPIA EM MASSA (stdrand hw pool)
+ * =============================================================== */
+void test_hw_pool(void) {
+    printf("\n>>> Testando Pool de Entropia...\n");
+
+    uint8_t buf[1021] = {0};
+    assert(rand_hw_fill(buf, sizeof(buf)));
+    size_t zeros = 0;
+    for (size_t i = 0; i < sizeof(buf); i++) zeros += buf[i] == 0;
+    assert(zeros < 32);
+    TEST_PASS("rand_hw_fill preencheu buffer desalinhado");
+
+#if defined(__x86_64__) || defined(_M_X64)
+    uint64_t first = rand64_hw_seed();
+    bool distinct = true;
+    for (int i = 0; i < 200; i++) distinct &= rand64_hw_seed() != first;
+    assert(distinct);
+    TEST_PASS("rand64_hw_seed entrega seeds distintas do pool");
+#endif
+}
+
+/* ===============================================================
+ * 8. TESTE DO GERADOR INLINE (stdrand wyrand)
+ * =============================================================== */
+void test_wyrand(void) {
+    printf("\n>>> Testando rand_wy_t...\n");
+
+    rand_wy_t a, b;
+    rand_init(99, &a);
+    b = rand_wy_init(99);
+    assert(rand_next(&a) == rand_wy_next(&b));
+
+    for (int i = 0; i < 10000; i++) {
+        uint64_t r = rand_range(&a, 10, 20);
+        assert(r >= 10 && r < 20);
+        assert(rand_bound(&a, 1ULL << 63 | 1) <= 1ULL << 63);
+    }
+    TEST_PASS("rand_wy_t resolvido pelo _Generic com limites corretos");
+
+    b = a;
+    rand_jump(&b);
+    assert(rand_next(&a) != rand_next(&b));
+    TEST_PASS("rand_wy_jump desloca o fluxo");
+}
+
+/* ===============================================================
+ * 9. TESTE DO CSPRNG (stdrand ChaCha20)
+ * =============================================================== */
+void test_secure(void) {
+    printf("\n>>> Testando rand_secure_t...\n");
+
+    rand_secure_t a, b;
+    assert(rand_secure_init(&a));
+    assert(rand_secure_init(&b));
+    assert(rand_next(&a) != rand_next(&b));
+    TEST_PASS("Instâncias independentes geram fluxos distintos");
+
+    static uint8_t buf[3000];
+    size_t hist[256] = {0};
+    for (int i = 0; i < 100; i++) {
+        rand_secure_fill(&a, buf, sizeof(buf));
+        for (size_t j = 0; j < sizeof(buf); j++) hist[buf[j]]++;
+    }
+    for (int i = 0; i < 256; i++) assert(hist[i] > 900 && hist[i] < 1450);
+    for (int i = 0; i < 1000; i++) assert(rand_range(&a, 100, 200) - 100 < 100);
+    TEST_PASS("rand_secure_fill/range com distribuição uniforme de bytes");
+
+    rand_secure_wipe(&a);
+    rand_secure_wipe(&b);
+
+    /* RFC 8439 §2.3.2: chave 00..1f, contador 1, nonce 00000009 0000004a 00000000. */
+    static const uint32_t rfc_in[16] = {
+        0x61707865U, 0x3320646eU, 0x79622d32U, 0x6b206574U, 0x03020100U, 0x07060504U,
+        0x0b0a0908U, 0x0f0e0d0cU, 0x13121110U, 0x17161514U, 0x1b1a1918U, 0x1f1e1d1cU,
+        0x00000001U, 0x09000000U, 0x4a000000U, 0x00000000U};
+    static const uint8_t rfc_out[64] = {
+        0x10, 0xf1, 0xe7, 0xe4, 0xd1, 0x3b, 0x59, 0x15, 0x50, 0x0f, 0xdd, 0x1f, 0xa3,
+        0x20, 0x71, 0xc4, 0xc7, 0xd1, 0xf4, 0xc7, 0x33, 0xc0, 0x68, 0x03, 0x04, 0x22,
+        0xaa, 0x9a, 0xc3, 0xd4, 0x6c, 0x4e, 0xd2, 0x82, 0x64, 0x46, 0x07, 0x9f, 0xaa,
+        0x09, 0x14, 0xc2, 0xd7, 0x05, 0xd9, 0x8b, 0x02, 0xa2, 0xb5, 0x12, 0x9c, 0xd1,
+        0xde, 0x16, 0x4e, 0xb9, 0xcb, 0xd0, 0x83, 0xe8, 0xa2, 0x50, 0x3c, 0x4e};
+    static uint8_t ref[64 * 64], got[64 * 64];
+    assert(rand_chacha_blocks(rfc_in, ref, 1, RAND_CHACHA_SCALAR));
+    assert(memcmp(ref, rfc_out, sizeof(rfc_out)) == 0);
+    assert(rand_chacha_blocks(rfc_in, got, 1, RAND_CHACHA_AUTO));
+    assert(memcmp(got, rfc_out, sizeof(rfc_out)) == 0);
+    TEST_PASS("Bloco ChaCha20 confere com o vetor da RFC 8439 §2.3.2");
+
+    /* Contador perto de 2^32 para cobrir a volta nos kernels SIMD. */
+    uint32_t in[16];
+    memcpy(in, rfc_in, sizeof(in));
+    in[12] = 0xfffffff0U;
+    const size_t counts[] = {1, 3, 4, 8, 16, 17, 31, 48, 64};
+    const char *names[] = {"escalar", "SSE2", "AVX2", "AVX-512"};
+    for (unsigned k = RAND_CHACHA_SSE2; k <= RAND_CHACHA_AVX512; k++) {
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+            const size_t len = 64 * counts[c];
+            memset(ref, 0, sizeof(ref));
+            memset(got, 0xa5, sizeof(got));
+            assert(rand_chacha_blocks(in, ref, counts[c], RAND_CHACHA_SCALAR));
+            if (!rand_chacha_blocks(in, got, counts[c], k))
+                break;
+            assert(memcmp(ref, got, len) == 0);
+            for (size_t i = len; i < sizeof(got); i++) assert(got[i] == 0xa5);
+            if (c == 0)
+                printf("    kernel %s conferido\n", names[k]);
+        }
+    }
+    assert(!rand_chacha_blocks(in, got, 1, 7));
+    TEST_PASS("Kernels SIMD geram os mesmos bytes que o escalar");
+}
+
+/* ===============================================================
+ * 10. TESTE DE AMOSTRAGEM SEM REPOSIÇÃO (stdrand)
+ * =============================================================== */
+void test_sampling(void) {
+    printf("\n>>> Testando rand_sample_* e rand_perm_t...\n");
+
+    const uint64_t big = 10000000000ULL;
+    static uint64_t out[1000];
+    rand64_t rng = rand64_init(11);
+    assert(rand_sample_floyd(&rng, big, 1000, out));
+    for (int i = 1; i < 1000; i++) assert(out[i - 1] < out[i]);
+    assert(out[999] < big);
+    assert(!rand_sample_floyd(&rng, 5, 6, out));
+
+    rand_sample_t sample;
+    uint64_t prev = 0, idx, count = 0;
+    assert(rand_sample_init(&sample, big, 100000, 12));
+    while (rand_sample_next(&sample, &idx)) {
+        assert(count == 0 || idx > prev);
+        prev = idx;
+        count++;
+    }
+    assert(count == 100000 && prev < big);
+    TEST_PASS("Floyd e Vitter D geram índices distintos e ordenados (n = 10^10)");
+
+    /* Cada índice deve aparecer com frequência k/n (Método D e Método A). */
+    int hits_d[1000] = {0}, hits_a[20] = {0};
+    for (uint64_t t = 0; t < 2000; t++) {
+        rand_sample_init(&sample, 1000, 10, t);
+        while (rand_sample_next(&sample, &idx)) hits_d[idx]++;
+        rand_sample_init(&sample, 20, 5, t);
+        while (rand_sample_next(&sample, &idx)) hits_a[idx]++;
+    }
+    int lo = 2000, hi = 0;
+    for (int i = 0; i < 1000; i++) {
+        lo = hits_d[i] < lo ? hits_d[i] : lo;
+        hi = hits_d[i] > hi ? hits_d[i] : hi;
+    }
+    assert(lo >= 2 && hi <= 45);
+    for (int i = 0; i < 20; i++) assert(hits_a[i] > 420 && hits_a[i] < 580);
+    TEST_PASS("Vitter D/A com frequência de inclusão uniforme");
+
+    rand_perm_t perm;
+    static uint8_t seen[1000];
+    assert(rand_perm_init(&perm, 1000, 13));
+    for (uint64_t i = 0; i < 1000; i++) {
+        const uint64_t v = rand_perm_map(&perm, i);
+        assert(v < 1000 && !seen[v]);
+        seen[v] = 1;
+        assert(rand_perm_unmap(&perm, v) == i);
+    }
+    const uint64_t outside[] = {1000, 1023, 1024, UINT64_MAX};
+    for (size_t i = 0; i < sizeof(outside) / sizeof(outside[0]); i++) {
+        assert(rand_perm_map(&perm, outside[i]) == outside[i]);
+        assert(rand_perm_unmap(&perm, outside[i]) == outside[i]);
+    }
+    assert(rand_perm_init(&perm, big, 14));
+    for (uint64_t i = 0; i < 1000; i++) {
+        const uint64_t v = rand_perm_map(&perm, big - 1 - i);
+        assert(v < big && rand_perm_unmap(&perm, v) == big - 1 - i);
+    }
+    TEST_PASS("rand_perm_t é uma bijeção sobre [0, n) com inversa");
+}
+
+/* ===============================================================
+ * 11. TESTE DE MONTE CARLO PARALELO (stdrand parallel)
+ * =============================================================== */
+static double _test_pi_task(uint64_t task, rand64_t *rng, void *ctx) {
+    (void)task;
+    (void)ctx;
+    int hits = 0;
+    for (int i = 0; i < 64; i++) {
+        const double x = (double)(rand64_next(rng) >> 11) * 0x1.0p-53;
+        const double y = (double)(rand64_next(rng) >> 11) * 0x1.0p-53;
+        hits += x * x + y * y < 1.0;
+    }
+    return 4.0 * hits / 64.0;
+}
+
+static double _test_unit_task(uint64_t task, rand64_t *rng, void *ctx) {
+    (void)task;
+    (void)ctx;
+    return (double)(rand64_next(rng) >> 11) * 0x1.0p-53;
+}
+
+static void _test_first_task(uint64_t task, rand64_t *rng, void *ctx) {
+    ((uint64_t *)ctx)[task] = rand64_next(rng);
+}
+
+/* Troca o pool no meio da execução que ainda roda nele. */
+static double _test_swap_task(uint64_t task, rand64_t *rng, void *ctx) {
+    if (task == 0)
+        rand_parallel_threads(2);
+    return _test_pi_task(task, rng, ctx);
+}
+
+void test_parallel(void) {
+    printf("\n>>> Testando rand_parallel_*...\n");
+
+    const uint64_t n = 200000;
+    double sum1, sum4, kahan1, kahan4;
+    rand_parallel_threads(1);
+    assert(rand_parallel_sum(n, 7, _test_pi_task, NULL, &sum1));
+    assert(rand_parallel_kahan(n, 7, _test_pi_task, NULL, &kahan1));
+    rand_parallel_threads(4);
+    assert(rand_parallel_sum(n, 7, _test_pi_task, NULL, &sum4));
+    assert(rand_parallel_kahan(n, 7, _test_pi_task, NULL, &kahan4));
+    assert(memcmp(&sum1, &sum4, sizeof(double)) == 0);
+    assert(memcmp(&kahan1, &kahan4, sizeof(double)) == 0);
+    assert(fabs(kahan1 / (double)n - 3.14159265358979) < 0.01);
+    TEST_PASS("Soma e Kahan bit a bit idênticas com 1 e 4 threads");
+
+    double swapped;
+    rand_parallel_threads(4);
+    assert(rand_parallel_sum(n, 7, _test_swap_task, NULL, &swapped));
+    assert(memcmp(&sum1, &swapped, sizeof(double)) == 0);
+    assert(rand_parallel_sum(n, 7, _test_pi_task, NULL, &swapped));
+    assert(memcmp(&sum1, &swapped, sizeof(double)) == 0);
+    TEST_PASS("rand_parallel_threads durante uma execução não libera o pool em uso");
+
+    rand_hist_t h1, h3;
+    assert(rand_hist_init(&h1, 10, 0.0, 1.0) && rand_hist_init(&h3, 10, 0.0, 1.0));
+    rand_parallel_threads(1);
+    assert(rand_parallel_hist(n, 8, _test_unit_task, NULL, &h1));
+    rand_parallel_threads(3);
+    assert(rand_parallel_hist(n, 8, _test_unit_task, NULL, &h3));
+    uint64_t total = 0;
+    for (size_t i = 0; i < 10; i++) {
+        assert(h1.counts[i] == h3.counts[i]);
+        assert(h1.counts[i] > 19000 && h1.counts[i] < 21000);
+        total += h1.counts[i];
+    }
+    assert(total == n && h1.underflow == 0 && h1.overflow == 0 && h1.nan == 0);
+    rand_hist_add(&h1, -1.0);
+    rand_hist_add(&h1, 1.0);
+    rand_hist_add(&h1, NAN);
+    assert(h1.underflow == 1 && h1.overflow == 1 && h1.nan == 1);
+    rand_hist_free(&h1);
+    rand_hist_free(&h3);
+    TEST_PASS("Histograma paralelo reprodutível e uniforme");
+
+    uint64_t *first = (uint64_t *)calloc(5000, sizeof(uint64_t));
+    assert(first && rand_parallel_for(5000, 9, _test_first_task, first));
+    for (uint64_t t = 0; t < 5000; t++) {
+        rand64_t rng = rand_parallel_stream(9, t);
+        assert(first[t] == rand64_next(&rng));
+    }
+    free(first);
+    rand_parallel_threads(0);
+    TEST_PASS("Cada tarefa recebe o fluxo de rand_parallel_stream(seed, task)");
+}
+
+/* ===============================================================
+ * 12. TESTE DO THREAD POOL (stdthrd work-stealing)
+ * =============================================================== */
+static tpool_t *_test_pool;
+static latch_t _test_latch;
+
+static void _test_square_range(uint64_t begin, uint64_t end, void *ctx) {
+    uint64_t *out = (uint64_t *)ctx;
+    for (uint64_t i = begin; i < end; i++) out[i] = i * i;
+}
+
+static void _test_nested_range(uint64_t begin, uint64_t end, void *ctx) {
+    uint64_t *out = (uint64_t *)ctx;
+    for (uint64_t i = begin; i < end; i++) {
+        assert(tpool_parallel_for(_test_pool, 100, 0, _test_square_range, out + i * 100));
+    }
+}
+
+static void _test_mark(void *arg) {
+    *(uint8_t *)arg = 1;
+    latch_count_down(&_test_latch, 1);
+}
+
+static void *_test_fib(void *arg) {
+    const uintptr_t n = (uintptr_t)arg;
+    if (n < 2) return arg;
+    tpool_future_t left;
+    assert(tpool_async(_test_pool, &left, _test_fib, (void *)(n - 1)));
+    const uintptr_t right = (uintptr_t)_test_fib((void *)(n - 2));
+    return (void *)((uintptr_t)tpool_future_wait(_test_pool, &left) + right);
+}
+
+void test_thread_pool(void) {
+    printf("\n>>> Testando tpool_t (stdthrd)...\n");
+
+    tpool_config_t config = {4, 8, TPOOL_AFFINITY_NONE};
+    _test_pool = tpool_init(&config);
+    assert(_test_pool && tpool_size(_test_pool) == 4 && tpool_worker_id(_test_pool) == -1);
+
+    uint64_t *out = (uint64_t *)calloc(100000, sizeof(uint64_t));
+    assert(out && tpool_parallel_for(_test_pool, 100000, 0, _test_square_range, out));
+    for (uint64_t i = 0; i < 100000; i++) assert(out[i] == i * i);
+    memset(out, 0, 100000 * sizeof(uint64_t));
+    assert(tpool_parallel_for(_test_pool, 1000, 1, _test_nested_range, out));
+    for (uint64_t i = 0; i < 100000; i++) assert(out[i] == (i % 100) * (i % 100));
+    free(out);
+    TEST_PASS("parallel_for cobre [0, n) uma vez, inclusive aninhado");
+
+    static uint8_t marks[3000];
+    latch_init(&_test_latch, 3000);
+    for (int i = 0; i < 3000; i++) assert(tpool_submit(_test_pool, _test_mark, &marks[i]));
+    latch_wait(&_test_latch);
+    for (int i = 0; i < 3000; i++) assert(marks[i] == 1);
+    assert((uintptr_t)_test_fib((void *)20) == 6765);
+    TEST_PASS("submit + latch e futures recursivos (fib(20))");
+
+    tpool_free(_test_pool);
+    config.affinity = TPOOL_AFFINITY_NUMA;
+    _test_pool = tpool_init(&config);
+    assert(_test_pool && (uintptr_t)_test_fib((void *)15) == 610);
+    tpool_free(_test_pool);
+    TEST_PASS("Pool com afinidade NUMA criado e destruído");
+}
+
+/* ===============================================================
+ * 13. TESTE DAS FILAS LOCK-FREE (stdthrd queues)
+ * =============================================================== */
+static queue_blocking_t _test_queue;
+
+static void _test_producer(void *arg) {
+    const uint64_t id = (uint64_t)(uintptr_t)arg;
+    for (uint64_t i = 0; i < 20000; i++) {
+        const uint64_t value = id << 32 | i;
+        assert(queue_blocking_push(&_test_queue, &value));
+    }
+    latch_count_down(&_test_latch, 1);
+}
+
+void test_queues(void) {
+    printf("\n>>> Testando queue_spsc_t, queue_mpmc_t e queue_blocking_t...\n");
+
+    uint32_t in[100], out[100];
+    for (uint32_t i = 0; i < 100; i++) in[i] = i;
+
+    queue_spsc_t spsc;
+    assert(queue_spsc_init(&spsc, 50, sizeof(uint32_t)));
+    assert(queue_spsc_push_n(&spsc, in, 100) == 64 && !queue_spsc_push(&spsc, in));
+    assert(queue_spsc_pop_n(&spsc, out, 40) == 40 && out[39] == 39);
+    assert(queue_spsc_push_n(&spsc, in + 64, 36) == 36);
+    assert(queue_spsc_pop_n(&spsc, out + 40, 100) == 60 && !queue_spsc_pop(&spsc, out));
+    for (uint32_t i = 0; i < 100; i++) assert(out[i] == i);
+    queue_spsc_free(&spsc);
+
+    queue_mpmc_t mpmc;
+    uint32_t value;
+    assert(queue_mpmc_init(&mpmc, 8, sizeof(uint32_t)));
+    for (int round = 0; round < 3; round++) {
+        for (uint32_t i = 0; i < 8; i++) assert(queue_mpmc_push(&mpmc, &in[i]));
+        assert(!queue_mpmc_push(&mpmc, &in[0]));
+        for (uint32_t i = 0; i < 8; i++) assert(queue_mpmc_pop(&mpmc, &value) && value == i);
+        assert(!queue_mpmc_pop(&mpmc, &value));
+    }
+    queue_mpmc_free(&mpmc);
+    TEST_PASS("SPSC (lotes com wrap-around) e MPMC respeitam FIFO e capacidade");
+
+    tpool_config_t config = {3, 0, TPOOL_AFFINITY_NONE};
+    tpool_t *pool = tpool_init(&config);
+    assert(pool);
+    const queue_kind_t kinds[2] = {QUEUE_SPSC, QUEUE_MPMC};
+    for (int k = 0; k < 2; k++) {
+        const uint64_t producers = kinds[k] == QUEUE_SPSC ? 1 : 3;
+        assert(queue_blocking_init(&_test_queue, kinds[k], 16, sizeof(uint64_t)));
+        latch_init(&_test_latch, (int64_t)producers);
+        for (uint64_t p = 0; p < producers; p++) {
+            assert(tpool_submit(pool, _test_producer, (void *)(uintptr_t)p));
+        }
+        uint64_t next[3] = {0, 0, 0}, item;
+        for (uint64_t n = 0; n < producers * 20000; n++) {
+            assert(queue_blocking_pop(&_test_queue, &item));
+            const uint64_t id = item >> 32;
+            assert(id < producers && (item & UINT32_MAX) == next[id]);
+            next[id]++;
+        }
+        latch_wait(&_test_latch);
+        queue_blocking_close(&_test_queue);
+        assert(!queue_blocking_pop(&_test_queue, &item) && !queue_blocking_push(&_test_queue, &item));
+        queue_blocking_free(&_test_queue);
+    }
+    tpool_free(pool);
+    TEST_PASS("Fila bloqueante entre threads preserva a ordem por produtor");
+}
+
+/* ===============================================================
+ * 14. TESTE DOS LOCKS (stdthrd locks)
+ * =============================================================== */
+static lock_mutex_t _test_mutex = LOCK_MUTEX_INIT;
+static lock_ticket_t _test_ticket = LOCK_TICKET_INIT;
+static lock_mcs_t _test_mcs = LOCK_MCS_INIT;
+static lock_seq_t _test_seq = LOCK_SEQ_INIT;
+static lock_rw_t _test_rw;
+static uint64_t _test_counters[3];
+static uint64_t _test_pair[2];
+
+static void _test_lock_worker(void *arg) {
+    const uintptr_t id = (uintptr_t)arg;
+    lock_mcs_node_t node;
+    uint64_t pair[2];
+    for (uint64_t i = 0; i < 20000; i++) {
+        lock_mutex_lock(&_test_mutex);
+        _test_counters[0]++;
+        lock_mutex_unlock(&_test_mutex);
+        lock_ticket_lock(&_test_ticket);
+        _test_counters[1]++;
+        lock_ticket_unlock(&_test_ticket);
+        lock_mcs_lock(&_test_mcs, &node);
+        _test_counters[2]++;
+        lock_mcs_unlock(&_test_mcs, &node);
+        if (id == 0) {
+            pair[0] = pair[1] = i;
+            lock_seq_write(&_test_seq, _test_pair, pair, sizeof(pair));
+            lock_rw_write_lock(&_test_rw);
+            _test_pair[0] = _test_pair[1] = i;
+            lock_rw_write_unlock(&_test_rw);
+        } else {
+            lock_seq_read(&_test_seq, pair, _test_pair, sizeof(pair));
+            assert(pair[0] == pair[1]);
+            lock_rw_read_lock(&_test_rw);
+            assert(_test_pair[0] == _test_pair[1]);
+            lock_rw_read_unlock(&_test_rw);
+        }
+    }
+    latch_count_down(&_test_latch, 1);
+}
+
+static void _test_rw_parked(void *arg) {
+    (void)arg;
+    lock_rw_read_lock(&_test_rw);
+    lock_rw_read_unlock(&_test_rw);
+    latch_count_down(&_test_latch, 1);
+}
+
+void test_locks(void) {
+    printf("\n>>> Testando lock_mutex_t, lock_ticket_t, lock_mcs_t, lock_seq_t e lock_rw_t...\n");
+
+    assert(lock_mutex_trylock(&_test_mutex) && !lock_mutex_trylock(&_test_mutex));
+    lock_mutex_unlock(&_test_mutex);
+    assert(lock_rw_init(&_test_rw, 0) && _test_rw.size >= 1);
+    lock_rw_read_lock(&_test_rw);
+    lock_rw_read_lock(&_test_rw);
+    lock_rw_read_unlock(&_test_rw);
+    lock_rw_read_unlock(&_test_rw);
+    TEST_PASS("trylock e leitores reentrantes sem disputa");
+
+    tpool_config_t config = {4, 0, TPOOL_AFFINITY_NONE};
+    tpool_t *pool = tpool_init(&config);
+    assert(pool);
+    latch_init(&_test_latch, 4);
+    for (uintptr_t t = 0; t < 4; t++) assert(tpool_submit(pool, _test_lock_worker, (void *)t));
+    latch_wait(&_test_latch);
+    for (int i = 0; i < 3; i++) assert(_test_counters[i] == 80000);
+    TEST_PASS("Exclusão mútua sob disputa; seqlock e RW nunca expõem escrita parcial");
+
+    /* Leitor dormindo no futex enquanto o escritor solta e retoma o
+     * lock: ao acordar ele encontra pending == 1 de novo e precisa
+     * remarcar 2, senão o próximo unlock não o acorda. */
+    const struct timespec tick = {0, 1000000};
+    for (int round = 0; round < 8; round++) {
+        latch_init(&_test_latch, 1);
+        lock_rw_write_lock(&_test_rw);
+        assert(tpool_submit(pool, _test_rw_parked, NULL));
+        while (atomic_load(&_test_rw.pending) != 2) nanosleep(&tick, NULL);
+        lock_rw_write_unlock(&_test_rw);
+        lock_rw_write_lock(&_test_rw);
+        nanosleep(&tick, NULL);
+        lock_rw_write_unlock(&_test_rw);
+        for (int waited = 0; waited < 2000 && !latch_try_wait(&_test_latch); waited++) {
+            nanosleep(&tick, NULL);
+        }
+        assert(latch_try_wait(&_test_latch));
+    }
+    tpool_free(pool);
+    lock_rw_free(&_test_rw);
+    TEST_PASS("Leitor estacionado acorda mesmo com o escritor retomando o lock");
+}
+
+/* ===============================================================
+ * 15. TESTE DA ARENA (stdmem)
+ * =============================================================== */
+void test_arena(void) {
+    printf("\n>>> Testando mem_arena_t (stdmem)...\n");
+
+    mem_arena_t arena;
+    assert(mem_arena_init(&arena, 4096, 0));
+    uint8_t *first = (uint8_t *)mem_arena_alloc(&arena, 10);
+    uint8_t *second = (uint8_t *)mem_arena_alloc(&arena, 10);
+    assert(first && second == first + 16);
+    void *line = mem_arena_alloc_aligned(&arena, 100, 64);
+    void *page = mem_arena_alloc_aligned(&arena, 100, 8192);
+    assert(((uintptr_t)line & 63) == 0 && ((uintptr_t)page & 8191) == 0);
+    TEST_PASS("Bump-pointer contíguo e alinhamento até além da página");
+
+    const mem_arena_mark_t mark = mem_arena_save(&arena);
+    void *after = mem_arena_alloc(&arena, 10);
+    void *big = mem_arena_alloc(&arena, 1 << 20);
+    assert(big);
+    memset(big, 0xAB, 1 << 20);
+    for (int i = 0; i < 1000; i++) assert(mem_arena_alloc(&arena, 100));
+    const size_t mapped = arena.mapped;
+    mem_arena_restore(&arena, mark);
+    assert(mem_arena_alloc(&arena, 10) == after);
+    mem_arena_reset(&arena);
+    assert(mem_arena_alloc(&arena, 10) == first);
+    for (int i = 0; i < 1000; i++) assert(mem_arena_alloc(&arena, 100));
+    assert(arena.mapped == mapped);
+    TEST_PASS("Checkpoint e reset reaproveitam os chunks já mapeados");
+
+    mem_arena_reset(&arena);
+    mem_arena_trim(&arena);
+    assert(arena.mapped == 4096);
+    mem_arena_free(&arena);
+
+    assert(mem_arena_init(&arena, 0, MEM_ARENA_HUGE_PAGES));
+    uint64_t *values = (uint64_t *)mem_arena_alloc(&arena, 1000 * sizeof(uint64_t));
+    for (uint64_t i = 0; i < 1000; i++) values[i] = i;
+    assert(values[999] == 999 && arena.mapped % (2 << 20) == 0);
+    mem_arena_free(&arena);
+    TEST_PASS("Trim devolve chunks livres; arena com huge pages");
+}
+
+/* ===============================================================
+ * 16. TESTE DO POOL DE OBJETOS (stdmem)
+ * =============================================================== */
+static mem_pool_t *_test_obj_pool;
+static void *_test_handoff[4][2000];
+
+static void _test_pool_worker(void *arg) {
+    const uintptr_t id = (uintptr_t)arg;
+    uint64_t **live = (uint64_t **)malloc(2000 * sizeof(uint64_t *));
+    assert(live);
+    for (int round = 0; round < 5; round++) {
+        for (uint64_t i = 0; i < 2000; i++) {
+            live[i] = (uint64_t *)mem_pool_alloc(_test_obj_pool);
+            assert(live[i] && ((uintptr_t)live[i] & 63) == 0);
+            live[i][0] = id << 32 | i;
+        }
+        for (uint64_t i = 0; i < 2000; i++) {
+            assert(live[i][0] == (id << 32 | i));
+            mem_pool_release(_test_obj_pool, live[i]);
+        }
+    }
+    free(live);
+    /* Objetos alocados pela thread principal voltam por outra thread. */
+    for (int i = 0; i < 2000; i++) mem_pool_release(_test_obj_pool, _test_handoff[id][i]);
+    latch_count_down(&_test_latch, 1);
+}
+
+void test_object_pool(void) {
+    printf("\n>>> Testando mem_pool_t (stdmem)...\n");
+
+    mem_pool_t *pool = mem_pool_init(10, MEM_POOL_POISON);
+    assert(pool && mem_pool_slot_size(pool) == 64);
+    uint8_t *obj = (uint8_t *)mem_pool_alloc(pool);
+    assert(obj && obj[0] == 0xCD && obj[63] == 0xCD);
+    mem_pool_release(pool, obj);
+    assert(obj[8] == 0xDD && obj[63] == 0xDD && mem_pool_alloc(pool) == obj);
+    mem_pool_flush(pool);
+    assert(mem_pool_alloc(pool) != NULL);
+    mem_pool_free(pool);
+    TEST_PASS("Slots de 64 bytes, envenenamento e reuso LIFO");
+
+    _test_obj_pool = mem_pool_init(100, 0);
+    assert(_test_obj_pool && mem_pool_slot_size(_test_obj_pool) == 128);
+    for (int t = 0; t < 4; t++) {
+        for (int i = 0; i < 2000; i++) {
+            _test_handoff[t][i] = mem_pool_alloc(_test_obj_pool);
+            assert(_test_handoff[t][i]);
+        }
+    }
+    tpool_config_t config = {4, 0, TPOOL_AFFINITY_NONE};
+    tpool_t *pool_threads = tpool_init(&config);
+    assert(pool_threads);
+    latch_init(&_test_latch, 4);
+    for (uintptr_t t = 0; t < 4; t++) assert(tpool_submit(pool_threads, _test_pool_worker, (void *)t));
+    latch_wait(&_test_latch);
+    tpool_free(pool_threads);
+
+    /* Os workers saíram: seus magazines voltaram ao depósito. */
+    static void *again[8000];
+    for (int i = 0; i < 8000; i++) {
+        again[i] = mem_pool_alloc(_test_obj_pool);
+        assert(again[i]);
+    }
+    for (int i = 0; i < 8000; i++) mem_pool_release(_test_obj_pool, again[i]);
+    mem_pool_free(_test_obj_pool);
+    TEST_PASS("Alloc/release entre threads e devolução no fim da thread");
+}
+
+/* ===============================================================
+ * 17. TESTE DO EVENT LOOP (stdsock)
+ * =============================================================== */
+static net_handle_t _test_listener, _test_server, _test_client;
+static net_timer_t _test_timers[3];
+static int _test_echoes, _test_fired;
+static bool _test_connected;
+
+static void _test_echo_read(net_loop_t *loop, net_handle_t *handle, uint32_t events) {
+    (void)events;
+    char buf[64];
+    for (;;) {
+        const ptrdiff_t n = net_recv(handle->fd, buf, sizeof(buf));
+        if (n == NET_AGAIN) break;
+        if (n <= 0) {
+            net_loop_del(loop, handle);
+            CLOSESOCKET(handle->fd);
+            break;
+        }
+        assert(net_send(handle->fd, buf, (size_t)n) == n);
+    }
+}
+
+static void _test_on_accept(net_loop_t *loop, net_handle_t *handle, uint32_t events) {
+    (void)events;
+    socket_t sock;
+    while (ISVALIDSOCKET(sock = net_accept(handle->fd))) {
+        _test_server.fd = sock;
+        _test_server.on_read = _test_echo_read;
+        assert(net_loop_add(loop, &_test_server, NET_EVENT_READ));
+    }
+    assert(errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+static void _test_client_read(net_loop_t *loop, net_handle_t *handle, uint32_t events) {
+    (void)events;
+    char buf[64];
+    ptrdiff_t n;
+    while ((n = net_recv(handle->fd, buf, sizeof(buf))) > 0) {
+        assert(n == 4 && memcmp(buf, "ping", 4) == 0);
+        if (++_test_echoes == 100) {
+            net_loop_stop(loop);
+            return;
+        }
+        assert(net_send(handle->fd, "ping", 4) == 4);
+    }
+    assert(n == NET_AGAIN);
+}
+
+static void _test_client_write(net_loop_t *loop, net_handle_t *handle, uint32_t events) {
+    (void)events;
+    if (_test_connected) return;
+    _test_connected = true;
+    assert(net_loop_mod(loop, handle, NET_EVENT_READ));
+    assert(net_send(handle->fd, "ping", 4) == 4);
+}
+
+static void _test_on_timer(net_loop_t *loop, net_timer_t *timer) {
+    (void)loop;
+    assert(timer != &_test_timers[1]);
+    if (timer == &_test_timers[2]) {
+        assert(!"event loop travado");
+    }
+    _test_fired++;
+}
+
+static void _test_stop_loop(void *arg) {
+    net_loop_stop((net_loop_t *)arg);
+}
+
+#define _TEST_WHEEL_TIMERS 2000
+static net_timer_t _test_wheel[_TEST_WHEEL_TIMERS + 1];
+static uint64_t _test_wheel_fired_at[_TEST_WHEEL_TIMERS + 1];
+static int _test_wheel_fired, _test_wheel_repeats;
+
+static void _test_on_wheel(net_loop_t *loop, net_timer_t *timer) {
+    const size_t i = (size_t)(uintptr_t)timer->ctx;
+    if (i == _TEST_WHEEL_TIMERS && ++_test_wheel_repeats < 3) {
+        assert(net_timer_start(loop, timer, 0));
+        return;
+    }
+    assert(_test_wheel_fired_at[i] == UINT64_MAX);
+    _test_wheel_fired_at[i] = net_loop_now(loop);
+    _test_wheel_fired++;
+}
+
+static void _test_timer_wheel(void) {
+    net_loop_t *loop = net_loop_init(0);
+    assert(loop);
+    const uint64_t start = net_loop_now(loop);
+    int expected = 0;
+    for (size_t i = 0; i <= _TEST_WHEEL_TIMERS; i++) {
+        net_timer_init(&_test_wheel[i], _test_on_wheel, (void *)(uintptr_t)i);
+        _test_wheel_fired_at[i] = UINT64_MAX;
+        for (uint64_t k = 0; k < 10; k++) assert(net_timer_start(loop, &_test_wheel[i], 1000 + k * 500));
+        assert(net_timer_start(loop, &_test_wheel[i], (i * 37) % 600));
+        if (i % 7 == 3) net_timer_stop(loop, &_test_wheel[i]);
+        else expected++;
+    }
+    assert(!net_loop_set_tick(loop, 10));
+    while (_test_wheel_fired < expected) {
+        assert(net_loop_run_once(loop, -1) >= 0);
+        assert(net_loop_now(loop) - start < 5000);
+    }
+    uint64_t worst = 0;
+    for (size_t i = 0; i <= _TEST_WHEEL_TIMERS; i++) {
+        const uint64_t timeout = (i * 37) % 600;
+        if (i % 7 == 3) {
+            assert(_test_wheel_fired_at[i] == UINT64_MAX && !net_timer_active(&_test_wheel[i]));
+            continue;
+        }
+        assert(_test_wheel_fired_at[i] - start >= timeout);
+        if (_test_wheel_fired_at[i] - start - timeout > worst) worst = _test_wheel_fired_at[i] - start - timeout;
+    }
+    assert(_test_wheel_repeats == 3);
+    printf("    %d timers (cascata do nível 1), atraso máximo %" PRIu64 " ms\n", expected, worst);
+
+    _test_wheel_fired = 0;
+    _test_wheel_fired_at[0] = UINT64_MAX;
+    assert(net_loop_set_tick(loop, 16));
+    const uint64_t coarse = net_loop_now(loop);
+    assert(net_timer_start(loop, &_test_wheel[0], 20));
+    while (_test_wheel_fired == 0) assert(net_loop_run_once(loop, -1) >= 0);
+    assert(_test_wheel_fired_at[0] - coarse >= 20);
+    net_loop_free(loop);
+}
+
+void test_net_loop(void) {
+    printf("\n>>> Testando net_loop_t (stdsock)...\n");
+
+    net_loop_t *loop = net_loop_init(0);
+    assert(loop);
+    _test_listener.fd = net_listen_tcp("127.0.0.1", 0, 0, NET_LISTEN_REUSEPORT);
+    assert(ISVALIDSOCKET(_test_listener.fd));
+    _test_listener.on_read = _test_on_accept;
+    assert(net_loop_add(loop, &_test_listener, NET_EVENT_READ));
+
+    _test_client.fd = net_connect_tcp("127.0.0.1", net_local_port(_test_listener.fd));
+    assert(ISVALIDSOCKET(_test_client.fd));
+    _test_client.on_read = _test_client_read;
+    _test_client.on_write = _test_client_write;
+    assert(net_loop_add(loop, &_test_client, NET_EVENT_READ | NET_EVENT_WRITE));
+
+    net_timer_init(&_test_timers[2], _test_on_timer, NULL);
+    assert(net_timer_start(loop, &_test_timers[2], 5000));
+    net_loop_run(loop);
+    assert(_test_echoes == 100);
+    TEST_PASS("Echo edge-triggered sobre loopback (accept, connect, 100 idas e voltas)");
+
+    const uint64_t start = net_loop_now(loop);
+    net_timer_init(&_test_timers[0], _test_on_timer, NULL);
+    net_timer_init(&_test_timers[1], _test_on_timer, NULL);
+    assert(net_timer_start(loop, &_test_timers[0], 5) && net_timer_start(loop, &_test_timers[1], 1));
+    net_timer_stop(loop, &_test_timers[1]);
+    assert(!net_timer_active(&_test_timers[1]));
+    while (_test_fired == 0) assert(net_loop_run_once(loop, -1) >= 0);
+    assert(net_loop_now(loop) - start >= 5 && !net_timer_active(&_test_timers[0]));
+    TEST_PASS("Timers disparam no prazo e stop cancela");
+
+    _test_timer_wheel();
+    TEST_PASS("Roda de timers: rearme, cancelamento, cascata e tick grosso");
+
+    tpool_config_t config = {1, 0, TPOOL_AFFINITY_NONE};
+    tpool_t *pool = tpool_init(&config);
+    assert(pool && tpool_submit(pool, _test_stop_loop, loop));
+    net_loop_run(loop);
+    tpool_free(pool);
+    net_timer_stop(loop, &_test_timers[2]);
+    TEST_PASS("net_loop_stop de outra thread acorda o epoll_wait");
+
+    CLOSESOCKET(_test_client.fd);
+    CLOSESOCKET(_test_listener.fd);
+    net_loop_free(loop);
+}
+
+/* ===============================================================
+ * 18. TESTE DO I/O ASSÍNCRONO (net_aio_t, io_uring e epoll)
+ * =============================================================== */
+static net_aio_req_t _test_aio_accept, _test_aio_recv, _test_aio_send, _test_aio_close, _test_aio_file[2];
+static socket_t _test_aio_conn;
+static int _test_aio_accepted, _test_aio_echoed, _test_aio_finished, _test_aio_cancelled;
+static int64_t _test_aio_results[2];
+static char _test_aio_reply[64];
+static unsigned char _test_aio_region[8192];
+
+static void _test_aio_on_done(net_aio_t *aio, net_aio_req_t *req, const net_aio_event_t *ev) {
+    (void)aio;
+    assert(!(ev->flags & NET_AIO_MORE));
+    if (req == &_test_aio_send) assert(ev->res == (int64_t)req->len);
+    if (req == &_test_aio_close) assert(ev->res == 0);
+    if (req == &_test_aio_file[0] || req == &_test_aio_file[1])
+        _test_aio_results[req == &_test_aio_file[1]] = ev->res;
+    _test_aio_finished++;
+}
+
+static void _test_aio_on_recv(net_aio_t *aio, net_aio_req_t *req, const net_aio_event_t *ev) {
+    if (!(ev->flags & NET_AIO_MORE)) {
+        assert(ev->res == -ECANCELED || ev->res == 0);
+        _test_aio_cancelled += ev->res == -ECANCELED;
+        return;
+    }
+    assert(ev->res > 0 && ev->buf);
+    const size_t n = (size_t)ev->res;
+    memcpy(_test_aio_reply, ev->buf, n);
+    net_aio_buffer_release(aio, ev->buf);
+    if (n == 4 && memcmp(_test_aio_reply, "quit", 4) == 0) {
+        /* Resposta e close encadeados: o close só roda após o send. */
+        assert(net_aio_cancel(aio, req));
+        assert(net_aio_send(aio, &_test_aio_send, req->fd, "bye", 3, NET_AIO_LINK, _test_aio_on_done, NULL));
+        assert(net_aio_close(aio, &_test_aio_close, req->fd, _test_aio_on_done, NULL));
+        return;
+    }
+    assert(net_aio_send(aio, &_test_aio_send, req->fd, _test_aio_reply, n, 0, _test_aio_on_done, NULL));
+    _test_aio_echoed++;
+}
+
+static void _test_aio_on_accept(net_aio_t *aio, net_aio_req_t *req, const net_aio_event_t *ev) {
+    (void)req;
+    if (!(ev->flags & NET_AIO_MORE)) {
+        assert(ev->res == -ECANCELED);
+        _test_aio_cancelled++;
+        return;
+    }
+    assert(ev->res >= 0);
+    _test_aio_conn = (socket_t)ev->res;
+    _test_aio_accepted++;
+    assert(net_aio_recv(aio, &_test_aio_recv, _test_aio_conn, _test_aio_on_recv, NULL));
+}
+
+static void _test_aio_wait(net_aio_t *aio, const int *counter, int target) {
+    for (int i = 0; *counter < target; i++) {
+        assert(i < 1000 && "net_aio travado");
+        assert(net_aio_run_once(aio, 10) >= 0);
+    }
+}
+
+/* Lê exatamente size bytes do cliente (ou até EOF) girando o aio. */
+static size_t _test_aio_read(net_aio_t *aio, socket_t sock, char *buf, size_t size) {
+    size_t got = 0;
+    for (int i = 0; got < size; i++) {
+        assert(i < 1000 && "net_aio travado");
+        const ptrdiff_t n = net_recv(sock, buf + got, size - got);
+        if (n == 0) break;
+        if (n > 0) got += (size_t)n;
+        else assert(net_aio_run_once(aio, 10) >= 0);
+    }
+    return got;
+}
+
+static void _test_aio_backend(net_aio_backend_t backend) {
+    net_aio_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.backend = backend;
+    config.buffers = 8;
+    config.buffer_size = 64;
+    net_aio_t *aio = net_aio_init(&config);
+    const char *name = backend == NET_AIO_URING ? "io_uring" : "epoll";
+    if (!aio) {
+        printf("    (backend %s indisponível neste kernel)\n", name);
+        return;
+    }
+    assert(net_aio_backend(aio) == backend);
+    _test_aio_accepted = _test_aio_echoed = _test_aio_finished = _test_aio_cancelled = 0;
+
+    socket_t listener = net_listen_tcp("127.0.0.1", 0, 0, 0);
+    assert(ISVALIDSOCKET(listener));
+    assert(net_aio_accept(aio, &_test_aio_accept, listener, _test_aio_on_accept, NULL));
+    assert(net_aio_submit(aio));
+    socket_t client = net_connect_tcp("127.0.0.1", net_local_port(listener));
+    assert(ISVALIDSOCKET(client));
+    _test_aio_wait(aio, &_test_aio_accepted, 1);
+
+    char buf[16];
+    for (int i = 0; i < 20; i++) {
+        assert(net_send(client, "ping", 4) == 4);
+        assert(_test_aio_read(aio, client, buf, 4) == 4 && memcmp(buf, "ping", 4) == 0);
+    }
+    _test_aio_wait(aio, &_test_aio_finished, 20);
+    assert(_test_aio_echoed == 20);
+    printf("    [%s] ", name);
+    TEST_PASS("accept e recv multishot com buffers providos (20 ecos)");
+
+    assert(net_send(client, "quit", 4) == 4);
+    assert(_test_aio_read(aio, client, buf, sizeof(buf)) == 3 && memcmp(buf, "bye", 3) == 0);
+    _test_aio_wait(aio, &_test_aio_finished, 22);
+    _test_aio_wait(aio, &_test_aio_cancelled, 1);
+    assert(net_aio_cancel(aio, &_test_aio_accept));
+    _test_aio_wait(aio, &_test_aio_cancelled, 2);
+    printf("    [%s] ", name);
+    TEST_PASS("send + close encadeados, EOF no cliente e cancelamento");
+
+    char path[] = "/tmp/stdfrigo_aio_XXXXXX";
+    const int file = mkstemp(path);
+    assert(file >= 0);
+    unlink(path);
+    struct iovec region;
+    region.iov_base = _test_aio_region;
+    region.iov_len = sizeof(_test_aio_region);
+    assert(net_aio_register_buffers(aio, &region, 1));
+    for (size_t i = 0; i < 4096; i++) _test_aio_region[i] = (unsigned char)(i * 7);
+    assert(net_aio_write(aio, &_test_aio_file[0], file, _test_aio_region, 4096, 0, NET_AIO_LINK,
+                         _test_aio_on_done, NULL));
+    assert(net_aio_read(aio, &_test_aio_file[1], file, _test_aio_region + 4096, 4096, 0, 0,
+                        _test_aio_on_done, NULL));
+    _test_aio_wait(aio, &_test_aio_finished, 24);
+    assert(_test_aio_results[0] == 4096 && _test_aio_results[1] == 4096);
+    assert(memcmp(_test_aio_region, _test_aio_region + 4096, 4096) == 0);
+
+    assert(net_aio_write(aio, &_test_aio_file[0], -1, _test_aio_region, 16, 0, NET_AIO_LINK,
+                         _test_aio_on_done, NULL));
+    assert(net_aio_read(aio, &_test_aio_file[1], file, _test_aio_region, 16, 0, 0, _test_aio_on_done, NULL));
+    _test_aio_wait(aio, &_test_aio_finished, 26);
+    assert(_test_aio_results[0] == -EBADF && _test_aio_results[1] == -ECANCELED);
+    assert(net_aio_register_buffers(aio, NULL, 0));
+    close(file);
+    printf("    [%s] ", name);
+    TEST_PASS("write/read em buffer registrado; falha cancela o elo seguinte");
+
+    assert(net_aio_syscalls(aio) > 0);
+    CLOSESOCKET(client);
+    CLOSESOCKET(listener);
+    net_aio_free(aio);
+}
+
+void test_net_aio(void) {
+    printf("\n>>> Testando net_aio_t (stdsock)...\n");
+    _test_aio_backend(NET_AIO_URING);
+    _test_aio_backend(NET_AIO_EPOLL);
+}
+
+/* ===============================================================
+ * 19. TESTE DO ENVIO SEM CÓPIA (sendfile, splice/tee, MSG_ZEROCOPY)
+ * =============================================================== */
+#define _TEST_ZC_SIZE 262144
+static unsigned char _test_zc_data[_TEST_ZC_SIZE], _test_zc_recv[_TEST_ZC_SIZE];
+
+static void _test_tcp_pair(socket_t listener, socket_t *client, socket_t *server) {
+    *client = net_connect_tcp("127.0.0.1", net_local_port(listener));
+    assert(ISVALIDSOCKET(*client));
+    *server = INVALID_SOCKET;
+    for (long i = 0; i < 100000000 && !ISVALIDSOCKET(*server); i++) *server = net_accept(listener);
+    assert(ISVALIDSOCKET(*server));
+}
+
+/* Lê o que houver sem bloquear; devolve o novo total. */
+static size_t _test_drain_sock(socket_t sock, unsigned char *dst, size_t got, size_t want) {
+    while (got < want) {
+        const ptrdiff_t n = net_recv(sock, dst + got, want - got);
+        if (n == NET_AGAIN) break;
+        assert(n > 0);
+        got += (size_t)n;
+    }
+    return got;
+}
+
+void test_zero_copy(void) {
+    printf("\n>>> Testando envio sem cópia (stdsock)...\n");
+    for (size_t i = 0; i < _TEST_ZC_SIZE; i++) _test_zc_data[i] = (unsigned char)(i * 31 + (i >> 9));
+    socket_t listener = net_listen_tcp("127.0.0.1", 0, 0, 0);
+    assert(ISVALIDSOCKET(listener));
+
+    socket_t cli, srv;
+    _test_tcp_pair(listener, &cli, &srv);
+    char path[] = "/tmp/stdfrigo_zc_XXXXXX";
+    const int file = mkstemp(path);
+    assert(file >= 0);
+    unlink(path);
+    assert(write(file, _test_zc_data, _TEST_ZC_SIZE) == _TEST_ZC_SIZE);
+    uint64_t offset = 0;
+    size_t got = 0;
+    while (got < _TEST_ZC_SIZE) {
+        if (offset < _TEST_ZC_SIZE) {
+            const ptrdiff_t n = net_sendfile(srv, file, &offset, _TEST_ZC_SIZE - (size_t)offset);
+            assert(n > 0 || n == NET_AGAIN);
+        }
+        got = _test_drain_sock(cli, _test_zc_recv, got, _TEST_ZC_SIZE);
+    }
+    assert(memcmp(_test_zc_data, _test_zc_recv, _TEST_ZC_SIZE) == 0);
+    assert(net_sendfile(srv, file, &offset, 100) == 0);
+    close(file);
+    TEST_PASS("net_sendfile entrega o arquivo inteiro e 0 no fim");
+
+    socket_t dst_cli, dst_srv, mir_cli, mir_srv;
+    _test_tcp_pair(listener, &dst_cli, &dst_srv);
+    _test_tcp_pair(listener, &mir_cli, &mir_srv);
+    net_pipe_t pipe_main, pipe_mirror;
+    assert(net_pipe_init(&pipe_main, 0) && net_pipe_init(&pipe_mirror, 0));
+    size_t sent = 0;
+    got = 0;
+    memset(_test_zc_recv, 0, _TEST_ZC_SIZE);
+    while (got < _TEST_ZC_SIZE) {
+        if (sent < _TEST_ZC_SIZE) {
+            const ptrdiff_t n = net_send(cli, _test_zc_data + sent, _TEST_ZC_SIZE - sent);
+            assert(n > 0 || n == NET_AGAIN);
+            if (n > 0) sent += (size_t)n;
+        }
+        const ptrdiff_t n = net_splice(srv, dst_srv, &pipe_main, 65536);
+        assert(n > 0 || n == NET_AGAIN);
+        got = _test_drain_sock(dst_cli, _test_zc_recv, got, _TEST_ZC_SIZE);
+    }
+    assert(memcmp(_test_zc_data, _test_zc_recv, _TEST_ZC_SIZE) == 0 && net_pipe_pending(&pipe_main) == 0);
+    TEST_PASS("net_splice encaminha 256 KiB entre sockets pelo pipe");
+
+    unsigned char copy[1000];
+    assert(net_send(cli, "espelhado", 9) == 9);
+    ptrdiff_t filled = NET_AGAIN;
+    for (long i = 0; i < 100000000 && filled == NET_AGAIN; i++) filled = net_pipe_fill(&pipe_main, srv, sizeof(copy));
+    assert(filled == 9 && net_pipe_tee(&pipe_main, &pipe_mirror, 9) == 9);
+    assert(net_pipe_pending(&pipe_main) == 9 && net_pipe_pending(&pipe_mirror) == 9);
+    assert(net_pipe_drain(&pipe_main, dst_srv, 9) == 9 && net_pipe_drain(&pipe_mirror, mir_srv, 9) == 9);
+    size_t a = 0, b = 0;
+    for (long i = 0; i < 100000000 && (a < 9 || b < 9); i++) {
+        a = _test_drain_sock(dst_cli, copy, a, 9);
+        b = _test_drain_sock(mir_cli, copy + 9, b, 9);
+    }
+    assert(memcmp(copy, "espelhado", 9) == 0 && memcmp(copy + 9, "espelhado", 9) == 0);
+    net_pipe_free(&pipe_main);
+    net_pipe_free(&pipe_mirror);
+    TEST_PASS("net_pipe_tee espelha o tráfego sem consumir a origem");
+
+    net_zc_t zc;
+    const bool zerocopy = net_zc_init(&zc, srv);
+    uint32_t ids[4];
+    sent = got = 0;
+    for (int i = 0; i < 4; i++) {
+        ptrdiff_t n = NET_AGAIN;
+        while (n == NET_AGAIN) {
+            n = net_zc_send(&zc, _test_zc_data + (size_t)i * 65536, 65536, &ids[i]);
+            got = _test_drain_sock(cli, _test_zc_recv, got, _TEST_ZC_SIZE);
+        }
+        assert(n > 0);
+        sent += (size_t)n;
+    }
+    while (got < sent) got = _test_drain_sock(cli, _test_zc_recv, got, sent);
+    assert(!zerocopy || ids[0] != 0);
+    for (long i = 0; i < 100000000 && !net_zc_done(&zc, ids[3]); i++) assert(net_zc_reap(&zc) >= 0);
+    for (int i = 0; i < 4; i++) assert(net_zc_done(&zc, ids[i]));
+    TEST_PASS("MSG_ZEROCOPY: notificações da fila de erros liberam os buffers");
+
+    CLOSESOCKET(cli);
+    CLOSESOCKET(srv);
+    CLOSESOCKET(dst_cli);
+    CLOSESOCKET(dst_srv);
+    CLOSESOCKET(mir_cli);
+    CLOSESOCKET(mir_srv);
+    CLOSESOCKET(listener);
+}
+
+/* ===============================================================
+ * 20. TESTE DOS DATAGRAMAS EM LOTE (recvmmsg/sendmmsg, GSO/GRO)
+ * =============================================================== */
+/* Recebe até juntar want bytes; devolve o número de datagramas. */
+static unsigned _test_dgram_collect(socket_t sock, net_dgram_batch_t *batch, size_t want, size_t *bytes) {
+    unsigned msgs = 0;
+    *bytes = 0;
+    for (long i = 0; i < 100000000 && *bytes < want; i++) {
+        const int n = net_dgram_recv(sock, batch);
+        if (n == NET_AGAIN) continue;
+        assert(n > 0);
+        for (int j = 0; j < n; j++) {
+            const net_dgram_t *msg = &batch->msgs[j];
+            assert(!(msg->flags & NET_DGRAM_TRUNC) && msg->timestamp_ns != 0);
+            for (size_t k = 0; k < msg->len; k++)
+                assert(((const unsigned char *)msg->data)[k] == (unsigned char)(*bytes + k));
+            *bytes += msg->len;
+        }
+        msgs += (unsigned)n;
+    }
+    return msgs;
+}
+
+void test_dgram_batch(void) {
+    printf("\n>>> Testando datagramas em lote (stdsock)...\n");
+    socket_t rx = net_udp_bind("127.0.0.1", 0, 0);
+    assert(ISVALIDSOCKET(rx));
+    socket_t tx = net_udp_connect("127.0.0.1", net_local_port(rx));
+    assert(ISVALIDSOCKET(tx));
+    assert(net_set_rcvbuf(rx, 1 << 20) > 0 && net_set_sndbuf(tx, 1 << 20) > 0);
+    assert(net_set_timestamps(rx, true));
+    net_set_drop_counter(rx, true);
+
+    net_dgram_batch_t *out = net_dgram_batch_init(32, 2048);
+    net_dgram_batch_t *in = net_dgram_batch_init(16, 2048);
+    assert(out && in);
+    for (unsigned i = 0; i < 32; i++) {
+        unsigned char *data = (unsigned char *)out->msgs[i].data;
+        for (size_t k = 0; k < 50; k++) data[k] = (unsigned char)(i * 50 + k);
+        out->msgs[i].len = 50;
+    }
+    assert(net_dgram_send(tx, out, 32) == 32);
+    size_t bytes;
+    assert(_test_dgram_collect(rx, in, 32 * 50, &bytes) == 32 && bytes == 32 * 50);
+    assert(in->msgs[0].addr_len != 0);
+    TEST_PASS("sendmmsg/recvmmsg: 32 datagramas em uma chamada, com timestamp");
+
+    const bool gro = net_udp_set_gro(rx, true);
+    unsigned char *data = (unsigned char *)out->msgs[0].data;
+    for (size_t k = 0; k < 1000; k++) data[k] = (unsigned char)k;
+    out->msgs[0].len = 1000;
+    out->msgs[0].segment = 100;
+    assert(net_dgram_send(tx, out, 1) == 1);
+    const unsigned msgs = _test_dgram_collect(rx, in, 1000, &bytes);
+    assert(bytes == 1000 && (msgs == 10 || (gro && in->msgs[0].segment == 100)));
+    printf("    GSO de 10x100 bytes chegou em %u datagrama(s)%s\n", msgs, gro ? " (GRO ativo)" : "");
+    TEST_PASS("UDP_SEGMENT: mensagem segmentada chega inteira (GRO ou separada)");
+
+    net_dgram_batch_free(out);
+    net_dgram_batch_free(in);
+    CLOSESOCKET(tx);
+    CLOSESOCKET(rx);
+}
+
+/* ===============================================================
+ * 21. TESTE DE CADEIAS DE BUFFERS E ANEL ESPELHADO (stdmem + stdsock)
+ * =============================================================== */
+static int _test_buf_released = 0;
+
+static void _test_buf_release(void *data, void *ctx) {
+    (void)ctx;
+    free(data);
+    _test_buf_released++;
+}
+
+void test_buffer_chain(void) {
+    printf("\n>>> Testando cadeias de buffers e anel espelhado (stdmem)...\n");
+    mem_buf_t *body = mem_buf_wrap(malloc(1000), 1000, _test_buf_release, NULL);
+    assert(body);
+    for (size_t i = 0; i < 1000; i++) ((unsigned char *)mem_buf_data(body))[i] = (unsigned char)(i * 7);
+    mem_chain_t resp, head;
+    mem_chain_init(&resp);
+    mem_chain_init(&head);
+    assert(mem_chain_append_static(&resp, "HTTP/1.1 200 OK\r\n", 17));
+    assert(mem_chain_append(&resp, body, 0, 400));
+    assert(mem_chain_append(&resp, body, 400, 600) && resp.count == 2 && resp.bytes == 1017);
+    mem_buf_unref(body);
+    assert(_test_buf_released == 0);
+    assert(mem_chain_splice(&head, &resp, 20) && head.count == 2 && head.bytes == 20 && resp.bytes == 997);
+    unsigned char flat[1017];
+    assert(mem_chain_copy(&head, 0, flat, 20) == 20 && mem_chain_copy(&resp, 0, flat + 20, 997) == 997);
+    assert(memcmp(flat, "HTTP/1.1 200 OK\r\n", 17) == 0 && flat[17] == 0 && flat[1016] == (unsigned char)(999 * 7));
+    mem_chain_free(&head);
+    assert(_test_buf_released == 0);
+    TEST_PASS("Fatias compartilham o buffer; splice corta sem copiar");
+
+    mem_ring_t ring;
+    assert(mem_ring_init(&ring, 1000) && ring.size >= 1000 && mem_ring_writable(&ring) == ring.size);
+    memset(mem_ring_write_ptr(&ring), 'a', ring.size - 10);
+    mem_ring_produce(&ring, ring.size - 10);
+    mem_ring_consume(&ring, ring.size - 10);
+    for (int i = 0; i < 100; i++) {
+        mem_ring_write_ptr(&ring)[0] = (unsigned char)i;
+        mem_ring_produce(&ring, 1);
+    }
+    assert(ring.base[0] == 10 && ring.base[ring.size] == 10);
+    const unsigned char *frame = mem_ring_read_ptr(&ring);
+    for (int i = 0; i < 100; i++) assert(frame[i] == (unsigned char)i);
+    mem_ring_consume(&ring, 100);
+    assert(mem_ring_readable(&ring) == 0 && ring.head == 90);
+    TEST_PASS("Anel espelhado: leitura contígua através do fim");
+
+    socket_t listener = net_listen_tcp("127.0.0.1", 0, 0, 0);
+    assert(ISVALIDSOCKET(listener));
+    socket_t cli, srv;
+    _test_tcp_pair(listener, &cli, &srv);
+    mem_chain_t out;
+    mem_chain_init(&out);
+    assert(mem_chain_splice(&out, &resp, resp.bytes) && resp.count == 0);
+    mem_chain_free(&resp);
+    size_t sent = 0;
+    while (out.bytes) {
+        const ptrdiff_t n = net_send_chain(srv, &out);
+        assert(n > 0 || n == NET_AGAIN);
+        if (n > 0) sent += (size_t)n;
+    }
+    assert(sent == 997 && _test_buf_released == 1 && net_send_chain(srv, &out) == 0);
+    for (long i = 0; i < 100000000 && mem_ring_readable(&ring) < 997; i++) {
+        const ptrdiff_t n = net_recv_ring(cli, &ring);
+        assert(n > 0 || n == NET_AGAIN);
+    }
+    assert(mem_ring_readable(&ring) == 997 && memcmp(mem_ring_read_ptr(&ring), flat + 20, 997) == 0);
+    while (mem_ring_readable(&ring)) {
+        const ptrdiff_t n = net_send_ring(cli, &ring);
+        assert(n > 0 || n == NET_AGAIN);
+    }
+    size_t got = 0;
+    for (long i = 0; i < 100000000 && got < 997; i++) {
+        struct iovec iov[2];
+        iov[0].iov_base = flat + got;
+        iov[0].iov_len = 3;
+        iov[1].iov_base = flat + got + 3;
+        iov[1].iov_len = 1017 - got - 3;
+        const ptrdiff_t n = net_recvv(srv, iov, 2);
+        assert(n > 0 || n == NET_AGAIN);
+        if (n > 0) got += (size_t)n;
+    }
+    assert(got == 997 && flat[996] == (unsigned char)(999 * 7));
+    TEST_PASS("net_send_chain/net_recv_ring/net_recvv pelo loopback, buffer liberado");
+
+    mem_chain_free(&out);
+    mem_ring_free(&ring);
+    CLOSESOCKET(cli);
+    CLOSESOCKET(srv);
+    CLOSESOCKET(listener);
+}
+
+/* ===============================================================
+ * 22. TESTE DO SERVIDOR MULTI-ACCEPTOR (SO_REUSEPORT + BPF)
+ * =============================================================== */
+#define _TEST_SERVER_CONNS 64
+
+typedef struct _test_shard_state {
+    unsigned accepted;
+    unsigned misrouted;
+} _test_shard_state_t;
+
+static latch_t _test_server_done;
+
+static void _test_shard_start(net_shard_t *shard) {
+    shard->ctx = calloc(1, sizeof(_test_shard_state_t));
+}
+
+static void _test_shard_accept(net_shard_t *shard, socket_t sock) {
+    _test_shard_state_t *state = (_test_shard_state_t *)shard->ctx;
+    struct sockaddr_storage peer, local;
+    socklen_t peer_len = sizeof(peer), local_len = sizeof(local);
+    assert(getpeername(sock, (struct sockaddr *)&peer, &peer_len) == 0);
+    assert(getsockname(sock, (struct sockaddr *)&local, &local_len) == 0);
+    const unsigned shards = net_server_shards(shard->server);
+    if (net_server_steer((struct sockaddr *)&peer, (struct sockaddr *)&local, shards) != shard->index)
+        state->misrouted++;
+    state->accepted++;
+    CLOSESOCKET(sock);
+    latch_count_down(&_test_server_done, 1);
+}
+
+void test_reuseport_server(void) {
+    printf("\n>>> Testando servidor multi-acceptor (stdsock)...\n");
+    net_server_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.host = "127.0.0.1";
+    config.shards = 4;
+    config.flags = NET_SERVER_PIN | NET_SERVER_STEER;
+    config.on_accept = _test_shard_accept;
+    config.on_start = _test_shard_start;
+    net_server_t *server = net_server_init(&config);
+    assert(server && net_server_shards(server) == 4 && net_server_port(server) != 0);
+    for (unsigned i = 0; i < 4; i++) assert(net_server_shard(server, i)->cpu >= 0);
+    latch_init(&_test_server_done, _TEST_SERVER_CONNS);
+    assert(net_server_start(server));
+
+    socket_t clients[_TEST_SERVER_CONNS];
+    for (int i = 0; i < _TEST_SERVER_CONNS; i++) {
+        clients[i] = net_connect_tcp("127.0.0.1", net_server_port(server));
+        assert(ISVALIDSOCKET(clients[i]));
+    }
+    latch_wait(&_test_server_done);
+    net_server_stop(server);
+
+    unsigned total = 0, busy = 0;
+    for (unsigned i = 0; i < 4; i++) {
+        net_shard_t *shard = net_server_shard(server, i);
+        _test_shard_state_t *state = (_test_shard_state_t *)shard->ctx;
+        assert(state->misrouted == 0 && state->accepted == shard->accepted);
+        total += state->accepted;
+        busy += state->accepted > 0;
+        printf("    shard %u: %u conexões\n", i, state->accepted);
+        free(state);
+    }
+    assert(total == _TEST_SERVER_CONNS && busy == 4);
+    TEST_PASS("Um listener por shard; BPF direciona pela 4-tupla como net_server_steer prevê");
+
+    for (int i = 0; i < _TEST_SERVER_CONNS; i++) CLOSESOCKET(clients[i]);
+    net_server_free(server);
+}
+
+/* ===============================================================
+ * 23. TESTE DO PROFILER (stdprof)
+ * =============================================================== */
+static void _test_prof_range(uint64_t begin, uint64_t end, void *ctx) {
+    volatile uint64_t *sink = (volatile uint64_t *)ctx;
+    for (uint64_t i = begin; i < end; i++) {
+        for (int j = 0; j < 1000; j++) {
+            PROF_BEGIN(test_prof_inner);
+            *sink = *sink + i;
+            PROF_END(test_prof_inner);
+        }
+    }
+}
+
+static const prof_stat_t *_test_prof_find(const prof_stat_t *stats, size_t count, const char *name) {
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(stats[i].name, name) == 0) return &stats[i];
+    }
+    return NULL;
+}
+
+void test_profiler(void) {
+    printf("\n>>> Testando PROF_BEGIN/PROF_END (stdprof)...\n");
+
+    double rate = prof_ticks_per_ns();
+    uint64_t overhead = prof_overhead();
+    uint64_t bare = UINT64_MAX;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t t0 = prof_ticks();
+        uint64_t t1 = prof_ticks();
+        if (t1 - t0 < bare) bare = t1 - t0;
+    }
+    assert(rate > 0.0);
+    printf("    %.3f ticks/ns; par vazio %" PRIu64 " ticks (leitura do relógio %" PRIu64 ")\n",
+           rate, overhead, bare);
+    TEST_PASS("Relógio calibrado e custo da sonda medido");
+
+    static uint64_t sink;
+    tpool_config_t config = {4, 8, TPOOL_AFFINITY_NONE};
+    tpool_t *pool = tpool_init(&config);
+    assert(pool && tpool_parallel_for(pool, 64, 1, _test_prof_range, &sink));
+    tpool_free(pool);
+    for (int i = 0; i < 10; i++) {
+        PROF_BEGIN(test_prof_outer);
+        _test_prof_range(0, 1, &sink);
+        PROF_END(test_prof_outer);
+    }
+
+    prof_stat_t stats[PROF_MAX_SITES];
+    size_t count = prof_collect(stats, PROF_MAX_SITES);
+    const prof_stat_t *inner = _test_prof_find(stats, count, "test_prof_inner");
+    const prof_stat_t *outer = _test_prof_find(stats, count, "test_prof_outer");
+    assert(inner && outer);
+    assert(inner->calls == 74000 && outer->calls == 10);
+    assert(inner->min <= inner->max && inner->ticks >= inner->calls * inner->min);
+    assert(outer->min >= 1000 * inner->min && strstr(outer->file, "test1") != NULL);
+    TEST_PASS("Contadores por thread somados após o término das threads");
+
+    FILE *csv = tmpfile();
+    assert(csv && prof_dump_file(csv, PROF_FORMAT_CSV));
+    rewind(csv);
+    char line[256];
+    assert(fgets(line, sizeof(line), csv) && strncmp(line, "name,file,line,calls", 20) == 0);
+    int rows = 0;
+    while (fgets(line, sizeof(line), csv)) rows++;
+    assert(rows == (int)count);
+    fclose(csv);
+
+    FILE *bin = tmpfile();
+    assert(bin && prof_dump_file(bin, PROF_FORMAT_BINARY));
+    rewind(bin);
+    unsigned char head[20];
+    assert(fread(head, 1, sizeof(head), bin) == sizeof(head));
+    assert(memcmp(head, "SFPROF1", 8) == 0 && head[16] == (unsigned char)count);
+    fclose(bin);
+    TEST_PASS("Relatórios CSV e binário");
+
+    prof_reset();
+    count = prof_collect(stats, PROF_MAX_SITES);
+    inner = _test_prof_find(stats, count, "test_prof_inner");
+    assert(inner && inner->calls == 0 && inner->min == 0);
+    TEST_PASS("prof_reset zera os contadores e mantém os sites");
+}
+
+static prof_hist_set_t *_test_hist_set;
+
+static void _test_hist_range(uint64_t begin, uint64_t end, void *ctx) {
+    (void)ctx;
+    prof_hist_t *local = prof_hist_local(_test_hist_set);
+    assert(local);
+    for (uint64_t i = begin; i < end; i++) prof_hist_record(local, i);
+}
+
+void test_prof_hist(void) {
+    printf("\n>>> Testando prof_hist_t (stdprof)...\n");
+
+    prof_hist_t hist;
+    assert(prof_hist_init(&hist, 3600000000000ull, 3));
+    printf("    3 dígitos até 1 h em ns: %zu contadores (%zu KiB)\n", hist.len,
+           hist.len * sizeof(uint64_t) / 1024);
+    rand64_t rng;
+    rand_init(2024, &rng);
+    for (int i = 0; i < 100000; i++) {
+        uint64_t v = rand_next(&rng) >> (rand_next(&rng) % 64);
+        if (v > hist.highest) v = hist.highest;
+        size_t index = prof_hist_index(&hist, v);
+        uint64_t low = prof_hist_lowest_at(&hist, index), high = prof_hist_highest_at(&hist, index);
+        assert(index < hist.len && low <= v && v <= high);
+        assert(high - low <= v / 1000);
+    }
+    TEST_PASS("Índice por clz: todo valor cai num bucket com erro < 0,1%");
+
+    for (uint64_t v = 1; v <= 100000; v++) prof_hist_record(&hist, v);
+    assert(hist.total == 100000 && hist.min == 1 && hist.max == 100000);
+    assert(prof_hist_percentile(&hist, 0.0) == 1 && prof_hist_percentile(&hist, 100.0) == 100000);
+    uint64_t p50 = prof_hist_percentile(&hist, 50.0), p99 = prof_hist_percentile(&hist, 99.0);
+    uint64_t p999 = prof_hist_percentile(&hist, 99.9);
+    assert(p50 >= 50000 && p50 <= 50050 && p99 >= 99000 && p99 <= 99100 && p999 >= 99900 && p999 <= 100000);
+    assert(fabs(prof_hist_mean(&hist) - 50000.5) < 50.0);
+    prof_hist_record(&hist, UINT64_MAX);
+    assert(hist.max == UINT64_MAX && prof_hist_percentile(&hist, 100.0) == UINT64_MAX);
+    printf("    p50=%" PRIu64 " p99=%" PRIu64 " p99.9=%" PRIu64 "\n", p50, p99, p999);
+    TEST_PASS("Percentis dentro da precisão; acima de highest satura");
+
+    size_t need = prof_hist_encode(&hist, NULL, 0);
+    uint8_t *wire = (uint8_t *)malloc(need);
+    assert(wire && prof_hist_encode(&hist, wire, need) == need);
+    prof_hist_t copy;
+    assert(prof_hist_decode(&copy, wire, need));
+    assert(copy.len == hist.len && copy.total == hist.total && copy.min == hist.min && copy.max == hist.max);
+    assert(memcmp(copy.counts, hist.counts, hist.len * sizeof(uint64_t)) == 0);
+    prof_hist_free(&copy);
+    assert(!prof_hist_decode(&copy, wire, need - 1) && !prof_hist_decode(&copy, wire, 3));
+    printf("    serializado em %zu bytes\n", need);
+    free(wire);
+    TEST_PASS("encode/decode preserva contagens, min e max");
+
+    _test_hist_set = prof_hist_set_init(1000000, 2);
+    assert(_test_hist_set);
+    tpool_config_t config = {4, 8, TPOOL_AFFINITY_NONE};
+    tpool_t *pool = tpool_init(&config);
+    assert(pool && tpool_parallel_for(pool, 200000, 0, _test_hist_range, NULL));
+    tpool_free(pool);
+    prof_hist_t merged;
+    assert(prof_hist_init(&merged, 1000000, 2));
+    assert(prof_hist_set_merge(_test_hist_set, &merged));
+    assert(merged.total == 200000 && merged.min == 0 && merged.max == 199999);
+    assert(!prof_hist_merge(&merged, &hist));
+    prof_hist_set_reset(_test_hist_set);
+    prof_hist_reset(&merged);
+    assert(prof_hist_set_merge(_test_hist_set, &merged) && merged.total == 0);
+    prof_hist_free(&merged);
+    prof_hist_set_free(_test_hist_set);
+    TEST_PASS("Shards por thread somados no merge");
+
+    prof_hist_reset(&hist);
+    uint64_t t0 = prof_ticks();
+    for (uint64_t i = 0; i < 1000000; i++) prof_hist_record(&hist, (i * 2654435761u) & 0xfffffff);
+    double ns = prof_ticks_to_ns(prof_ticks() - t0) / 1e6;
+    assert(hist.total == 1000000);
+    printf("    prof_hist_record: %.2f ns/valor\n", ns);
+    prof_hist_free(&hist);
+    TEST_PASS("Gravação barata o bastante para cada requisição");
+}
+
+/* ===============================================================
+ * 24. TESTE DOS ADAPTADORES C++ (stdfrigo.hpp)
+ * =============================================================== */
+#ifdef __cplusplus
+void test_cpp_adapters(void) {
+    printf("\n>>> Testando frigo::rand_engine e frigo::hash...\n");
+
+    frigo::rand64_engine eng(42);
+    std::vector<int> deck(52);
+    for (int i = 0; i < 52; i++) deck[(size_t)i] = i;
+    std::shuffle(deck.begin(), deck.end(), eng);
+    std::vector<int> sorted = deck;
+    std::sort(sorted.begin(), sorted.end());
+    for (int i = 0; i < 52; i++) assert(sorted[(size_t)i] == i);
+
+    std::uniform_int_distribution<int> dice(1, 6);
+    frigo::rand_double_engine deng(7);
+    for (int i = 0; i < 1000; i++) {
+        int v = dice(deng);
+        assert(v >= 1 && v <= 6);
+    }
+    TEST_PASS("std::shuffle e <random> aceitam os adaptadores");
+
+    frigo::rand_wy_engine a(9), b(9);
+    a.discard(1000);
+    for (int i = 0; i < 1000; i++) b();
+    assert(a() == b());
+    frigo::rand32_engine c(9), d(9);
+    c.discard(10);
+    for (int i = 0; i < 10; i++) d();
+    assert(c() == d());
+    frigo::rand64_engine parent(1);
+    frigo::rand64_engine child = parent.split();
+    assert(parent() != child());
+    TEST_PASS("discard equivale a n chamadas; split gera fluxos distintos");
+
+    std::unordered_map<std::string, int, frigo::hash<std::string>, std::equal_to<>> names;
+    names["frigo"] = 1;
+    assert(names.find(std::string_view("frigo")) != names.end());
+    assert(frigo::hash<std::string>{}("abc") == frigo::hash<std::string_view>{}("abc"));
+    assert(frigo::hash<uint64_t>{}(1) != 1 && frigo::hash<uint64_t>{}(1) == frigo::hash<int>{}(1));
+    std::unordered_map<uint64_t, int, frigo::hash<uint64_t>> ids;
+    for (uint64_t i = 0; i < 1000; i++) ids[i] = (int)i;
+    assert(ids.size() == 1000 && ids[500] == 500);
+    TEST_PASS("frigo::hash transparente para inteiros e strings");
+
+    frigo::arena_resource resource(4096);
+    {
+        frigo::arena_checkpoint scope(resource);
+        std::pmr::vector<std::pmr::string> words(&resource);
+        for (int i = 0; i < 1000; i++) words.emplace_back(std::to_string(i) + " palavras longas o bastante");
+        assert(words.size() == 1000 && words[999].get_allocator().resource() == &resource);
+    }
+    void *again = resource.allocate(16);
+    resource.reset();
+    assert(resource.allocate(16) == again);
+    TEST_PASS("frigo::arena_resource atende containers std::pmr");
+
+    for (int i = 0; i < 3; i++) {
+        FRIGO_PROF_SCOPE(test_prof_scope);
+        assert(frigo::hash<int>{}(i) == hash64_int((uint64_t)i));
+    }
+    prof_stat_t stats[PROF_MAX_SITES];
+    size_t count = prof_collect(stats, PROF_MAX_SITES);
+    bool found = false;
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(stats[i].name, "test_prof_scope") == 0) found = stats[i].calls == 3;
+    }
+    assert(found);
+    TEST_PASS("frigo::prof_scope registra o escopo ao sair");
+}
+#endif
+
 /* ===============================================================
  * MAIN
  * =============================================================== */
@@ -170,6 +1837,29 @@ int main(void) {
     test_polymorphism();
     test_hardware_accel();
     test_integration();
+    test_alias();
+    test_reservoir();
+    test_hw_pool();
+    test_wyrand();
+    test_secure();
+    test_sampling();
+    test_parallel();
+    test_thread_pool();
+    test_queues();
+    test_locks();
+    test_arena();
+    test_object_pool();
+    test_net_loop();
+    test_net_aio();
+    test_zero_copy();
+    test_dgram_batch();
+    test_buffer_chain();
+    test_reuseport_server();
+    test_profiler();
+    test_prof_hist();
+    #ifdef __cplusplus
+    test_cpp_adapters();
+    #endif
 
     printf("\n" KGRN "TODOS OS TESTES CONCLUÍDOS." KRST "\n");
     return 0;